@@ -0,0 +1,69 @@
+//===- AIECompiler.h --------------------------------------------*- C++ -*-===//
+//
+// This file is licensed under the Apache License v2.0 with LLVM Exceptions.
+// See https://llvm.org/LICENSE.txt for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+//
+// (c) Copyright 2022 Xilinx Inc.
+//
+//===----------------------------------------------------------------------===//
+//
+// In-process version of the MLIR part of aiecc: lower a design to its
+// physical form, lower every core to LLVM IR and generate the linker files
+// and the host interface, sharing a single MLIRContext and its thread pool.
+//
+//===----------------------------------------------------------------------===//
+
+#ifndef AIE_COMPILER_H
+#define AIE_COMPILER_H
+
+#include "mlir/IR/BuiltinOps.h"
+#include "mlir/Support/LogicalResult.h"
+#include "llvm/ADT/SmallVector.h"
+
+#include <string>
+
+namespace xilinx {
+namespace AIE {
+
+struct AIECompilerOptions {
+  // Directory where the generated files are written, without spaces or
+  // braces.
+  std::string tmpDir = "acdc_project";
+  // Route the flows with the pathfinder router.
+  bool pathfinder = false;
+  // Version of libxaie used by the generated host interface, 1 or 2.
+  int xaieTarget = 2;
+  // Program memory of a core, in bytes, that the estimated size of its code
+  // is checked against.
+  unsigned codeSizeBudget = 16384;
+  // Print the pipelines as they are run.
+  bool verbose = false;
+};
+
+// A core of the design, and the ELF file given by its elf_file attribute, if
+// any.
+struct AIECoreInfo {
+  int col;
+  int row;
+  std::string elfFile;
+};
+
+// Compile the given logical design, and write into options.tmpDir the same
+// files as aiecc does before invoking the backend:
+//   input_with_addresses.mlir, input_physical.mlir and aie_inc.cpp, and
+//   core_<col>_<row>.mlir, .ll, .ld.script and .bcf for every core.
+// The cores are processed in parallel when multithreading is enabled in the
+// context of the module, which is left in its physical form.  The cores of
+// the design are appended to cores.
+//
+// The AIE, AIEVec and MLIR passes have to be registered, since the pipelines
+// are the textual ones used by aiecc.
+mlir::LogicalResult compileAIEModule(mlir::ModuleOp module,
+                                     const AIECompilerOptions &options,
+                                     llvm::SmallVectorImpl<AIECoreInfo> &cores);
+
+} // namespace AIE
+} // namespace xilinx
+
+#endif // AIE_COMPILER_H
@@ -206,15 +206,18 @@ std::unique_ptr<OperationPass<ModuleOp>> createAIEAssignLockIDsPass();
 std::unique_ptr<OperationPass<ModuleOp>> createAIECoreToStandardPass();
 std::unique_ptr<OperationPass<ModuleOp>> createAIECreateCoresPass();
 std::unique_ptr<OperationPass<ModuleOp>> createAIECreateLocksPass();
+std::unique_ptr<OperationPass<ModuleOp>> createAIEEstimateCodeSizePass();
 std::unique_ptr<OperationPass<ModuleOp>> createAIEFindFlowsPass();
 std::unique_ptr<OperationPass<ModuleOp>> createAIEHerdRoutingPass();
 std::unique_ptr<OperationPass<ModuleOp>> createAIELocalizeLocksPass();
 std::unique_ptr<OperationPass<ModuleOp>> createAIELowerMemcpyPass();
 std::unique_ptr<OperationPass<ModuleOp>> createAIENormalizeAddressSpacesPass();
+std::unique_ptr<OperationPass<ModuleOp>> createAIEPlaceTilesPass();
 std::unique_ptr<OperationPass<ModuleOp>> createAIELowerMulticastPass();
 std::unique_ptr<OperationPass<ModuleOp>> createAIERouteFlowsPass();
 std::unique_ptr<OperationPass<ModuleOp>> createAIEBroadcastPacketPass();
 std::unique_ptr<OperationPass<ModuleOp>> createAIERoutePacketFlowsPass();
+std::unique_ptr<OperationPass<ModuleOp>> createAIERouteTracesPass();
 std::unique_ptr<OperationPass<func::FuncOp>> createAIEVectorOptPass();
 std::unique_ptr<OperationPass<ModuleOp>> createAIEPathfinderPass();
 std::unique_ptr<OperationPass<ModuleOp>>
@@ -13,6 +13,8 @@
 
 #include <algorithm>
 #include <limits>
+#include <map>
+#include <set>
 #include <utility> //for std::pair
 #include <vector>
 
@@ -64,13 +66,33 @@ typedef std::pair<int, int> Coord;
 // SwitchSetting.first is the incoming signal
 // SwitchSetting.second is the fanout
 typedef std::pair<Port, std::set<Port>> SwitchSetting;
-typedef std::map<Switchbox *, SwitchSetting> SwitchSettings;
+
+// Switchboxes are ordered by their coordinates rather than by their address,
+// so that the routing and the code generated from it do not depend on where
+// the graph was allocated.
+struct SwitchboxLess {
+  bool operator()(const Switchbox *a, const Switchbox *b) const {
+    return std::make_pair(a->col, a->row) < std::make_pair(b->col, b->row);
+  }
+};
+typedef std::map<Switchbox *, SwitchSetting, SwitchboxLess> SwitchSettings;
 
 // A Flow defines source and destination vertices
 // Only one source, but any number of destinations (fanout)
 typedef std::pair<Switchbox *, Port> PathEndPoint;
 typedef std::pair<PathEndPoint, std::vector<PathEndPoint>> Flow;
 
+struct PathEndPointLess {
+  bool operator()(const PathEndPoint &a, const PathEndPoint &b) const {
+    if (SwitchboxLess()(a.first, b.first))
+      return true;
+    if (SwitchboxLess()(b.first, a.first))
+      return false;
+    return a.second < b.second;
+  }
+};
+typedef std::map<PathEndPoint, SwitchSettings, PathEndPointLess> FlowSolutions;
+
 class Pathfinder {
 private:
   SwitchboxGraph graph;
@@ -84,8 +106,7 @@ public:
   void addFlow(Coord srcCoords, Port srcPort, Coord dstCoords, Port dstPort);
   void addFixedConnection(Coord coord, Port port);
   bool isLegal();
-  std::map<PathEndPoint, SwitchSettings>
-  findPaths(const int MAX_ITERATIONS = 1000);
+  FlowSolutions findPaths(const int MAX_ITERATIONS = 1000);
 
   Switchbox *getSwitchbox(TileID coords) {
     auto vpair = vertices(graph);
@@ -21,10 +21,12 @@
 #include "mlir/IR/OpImplementation.h"
 #include "mlir/IR/TypeSupport.h"
 #include "mlir/IR/Types.h"
+#include "llvm/ADT/SetVector.h"
 #include "llvm/ADT/SmallSet.h"
 #include "llvm/ADT/StringSwitch.h"
 
 using llvm::SmallSet;
+using llvm::SmallSetVector;
 using namespace mlir;
 
 namespace xilinx {
@@ -62,7 +64,9 @@ public:
 
   // CoreOp, MemOp or ShimDMAOp
   Operation *getTokenUserOp(Operation *Op);
-  SmallSet<TileOp, 4> getAccessibleTileOp(Operation *Op);
+  // The tiles whose locks Op can use, the tile of Op first.  This is a set
+  // vector so that it is iterated in a stable order.
+  SmallSetVector<TileOp, 4> getAccessibleTileOp(Operation *Op);
   std::pair<int, int> getCoord(Operation *Op);
   std::pair<StringRef, int> getTokenUseNameUser(Operation *Op, bool acquire);
 
@@ -53,6 +53,7 @@ namespace aievec {
 #include "aie/Dialect/AIEVec/Transforms/Passes.h.inc"
 
 std::unique_ptr<Pass> createAIEVectorizePass();
+std::unique_ptr<Pass> createAIEVecToStandardPass();
 
 /// Generate the code for registering passes.
 #define GEN_PASS_REGISTRATION
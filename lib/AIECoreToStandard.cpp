@@ -21,9 +21,17 @@
 #include "mlir/IR/BlockAndValueMapping.h"
 #include "mlir/IR/Location.h"
 #include "mlir/IR/PatternMatch.h"
+#include "mlir/IR/Threading.h"
 #include "mlir/Pass/Pass.h"
+#include "mlir/Pass/PassManager.h"
+#include "mlir/Pass/PassRegistry.h"
+#include "mlir/Support/FileUtilities.h"
 #include "mlir/Tools/mlir-translate/MlirTranslateMain.h"
 #include "mlir/Transforms/DialectConversion.h"
+#include "llvm/ADT/Sequence.h"
+#include "llvm/Support/FileSystem.h"
+#include "llvm/Support/Path.h"
+#include "llvm/Support/ToolOutputFile.h"
 
 using namespace mlir;
 using namespace mlir::vector;
@@ -298,9 +306,9 @@ struct AIECoreToStandardFunc : public OpConversionPattern<CoreOp> {
 
 struct AIECoreToStandardPass
     : public AIECoreToStandardBase<AIECoreToStandardPass> {
-  void runOnOperation() override {
-
-    ModuleOp m = getOperation();
+  // Lower the core at (col, row) of the given module to a function in the
+  // standard dialects, and remove everything else.
+  LogicalResult lowerCore(ModuleOp m, int col, int row) {
     OpBuilder builder = OpBuilder::atBlockEnd(m.getBody());
 
     // Ensure that we don't have an incorrect target triple.  This may override
@@ -422,7 +430,7 @@ struct AIECoreToStandardPass
         .setPrivate();
 
     BlockAndValueMapping mapper;
-    ConversionTarget target(getContext());
+    ConversionTarget target(*m.getContext());
     target.addLegalDialect<func::FuncDialect>();
     target.addLegalDialect<cf::ControlFlowDialect>();
     target.addLegalDialect<memref::MemRefDialect>();
@@ -430,18 +438,18 @@ struct AIECoreToStandardPass
     target.addLegalDialect<arith::ArithmeticDialect>();
     target.addLegalOp<func::FuncOp, ModuleOp>();
 
-    RewritePatternSet patterns(&getContext());
+    RewritePatternSet patterns(m.getContext());
     patterns.add<AIEPutStreamToStdLowering, AIEGetStreamToStdLowering,
                  AIEPutCascadeToStdLowering, AIEGetCascadeToStdLowering,
                  AIEDebugOpToStdLowering, AIEUseLockToStdLowering
                  >(m.getContext(), m);
 
     patterns.add<AIECoreToStandardFunc>(m.getContext(), m, mapper,
-                                        tileToBuffers, 1, tileCol, tileRow);
+                                        tileToBuffers, 1, col, row);
     if (failed(applyPartialConversion(m, target, std::move(patterns))))
-      signalPassFailure();
+      return failure();
 
-    RewritePatternSet removepatterns(&getContext());
+    RewritePatternSet removepatterns(m.getContext());
     removepatterns
         .add<AIEOpRemoval<AIE::TileOp>, AIEOpRemoval<AIE::FlowOp>,
              AIEOpRemoval<AIE::MemOp>, AIEOpRemoval<AIE::ShimDMAOp>,
@@ -451,7 +459,89 @@ struct AIECoreToStandardPass
             m.getContext(), m);
 
     if (failed(applyPartialConversion(m, target, std::move(removepatterns))))
-      signalPassFailure();
+      return failure();
+    return success();
+  }
+
+  void getDependentDialects(DialectRegistry &registry) const override {
+    AIECoreToStandardBase::getDependentDialects(registry);
+    // The dialects of the per-core pipeline have to be loaded before it runs
+    // as a dynamic pipeline of this pass.
+    OpPassManager pm(ModuleOp::getOperationName());
+    if (succeeded(parsePassPipeline(corePipeline, pm)))
+      pm.getDependentDialects(registry);
+  }
+
+  void runOnOperation() override {
+    ModuleOp m = getOperation();
+
+    if (outputDir.empty()) {
+      if (failed(lowerCore(m, tileCol, tileRow)))
+        signalPassFailure();
+      return;
+    }
+
+    // Lower every core from its own copy of the module, and write the result
+    // to outputDir.  The input module is left unchanged.  The core pipeline is
+    // nested under a module, so that it runs on every copy in parallel.
+    OpPassManager pm(ModuleOp::getOperationName());
+    if (!corePipeline.empty() &&
+        failed(parsePassPipeline("builtin.module(" + corePipeline + ")", pm))) {
+      m.emitError("invalid core-pipeline: ") << corePipeline;
+      return signalPassFailure();
+    }
+    if (auto ec = llvm::sys::fs::create_directories(outputDir)) {
+      m.emitError("cannot create ") << outputDir << ": " << ec.message();
+      return signalPassFailure();
+    }
+
+    SmallVector<CoreOp, 16> cores(m.getOps<CoreOp>());
+    SmallVector<OwningOpRef<ModuleOp>, 16> coreModules(cores.size());
+    auto lowerCoreModule = [&](size_t i) -> LogicalResult {
+      coreModules[i] = m.clone();
+      return lowerCore(*coreModules[i], cores[i].colIndex(),
+                       cores[i].rowIndex());
+    };
+    if (failed(failableParallelForEach(
+            m.getContext(), llvm::seq<size_t>(0, cores.size()),
+            lowerCoreModule)))
+      return signalPassFailure();
+
+    // The pass manager can only run a pipeline on an operation nested under
+    // the one the pass is processing: the copies are moved to a temporary
+    // module in the input module while the core pipeline runs.
+    if (!pm.empty()) {
+      OpBuilder builder = OpBuilder::atBlockEnd(m.getBody());
+      OwningOpRef<ModuleOp> container(
+          builder.create<ModuleOp>(builder.getUnknownLoc()));
+      for (auto &coreModule : coreModules)
+        container->push_back(coreModule.release());
+      LogicalResult result = runPipeline(pm, *container);
+      for (auto &coreModule : coreModules) {
+        coreModule = cast<ModuleOp>(container->getBody()->front());
+        (*coreModule)->remove();
+      }
+      if (failed(result))
+        return signalPassFailure();
+    }
+
+    for (size_t i = 0; i < cores.size(); i++) {
+      SmallString<128> path(outputDir);
+      llvm::sys::path::append(path, "core_" +
+                                        std::to_string(cores[i].colIndex()) +
+                                        "_" +
+                                        std::to_string(cores[i].rowIndex()) +
+                                        ".mlir");
+      std::string errorMessage;
+      auto output = openOutputFile(path, &errorMessage);
+      if (!output) {
+        cores[i].emitError(errorMessage);
+        return signalPassFailure();
+      }
+      coreModules[i]->print(output->os());
+      output->keep();
+    }
+    markAllAnalysesPreserved();
   }
 };
 
@@ -17,6 +17,7 @@
 #include "mlir/Pass/Pass.h"
 #include "mlir/Tools/mlir-translate/MlirTranslateMain.h"
 #include "mlir/Transforms/DialectConversion.h"
+#include "llvm/ADT/MapVector.h"
 
 #define DEBUG_TYPE "aie-create-locks"
 using namespace mlir;
@@ -163,8 +164,8 @@ struct AIECreateLocksPass : public AIECreateLocksBase<AIECreateLocksPass> {
   DenseMap<TileOp, DenseMap<int, DenseMap<int, StringRef>>> tileLockUsedStates;
   // tileLocks[tileOp] = {lockId: LockOp}
   DenseMap<TileOp, DenseMap<int, LockOp>> tileLocks;
-  // lockInitialized = {LockOp: initialized or not}
-  DenseMap<LockOp, bool> lockInitialized;
+  // lockInitialized = {LockOp: initialized or not}, in allocation order
+  llvm::MapVector<LockOp, bool> lockInitialized;
 
   // tokenUser2lockState[(tokenName, user)] = (lockOp, state)
   DenseMap<std::pair<StringRef, int>, std::pair<LockOp, int>>
@@ -289,14 +290,14 @@ struct AIECreateLocksPass : public AIECreateLocksBase<AIECreateLocksPass> {
         if (!users.size())
           continue;
 
-        SmallSet<TileOp, 4> possibleTiles =
+        SmallSetVector<TileOp, 4> possibleTiles =
             TA.getAccessibleTileOp(*users.begin());
 
         for (auto user : users) {
           auto currPossibleTiles = TA.getAccessibleTileOp(user);
 
           // find the intersection of the possible tiles
-          SmallSet<TileOp, 4> intersection;
+          SmallSetVector<TileOp, 4> intersection;
           for (auto tileOp : currPossibleTiles)
             if (possibleTiles.count(tileOp))
               intersection.insert(tileOp);
@@ -17,8 +17,11 @@
 #include "mlir/Pass/Pass.h"
 #include "mlir/Tools/mlir-translate/MlirTranslateMain.h"
 #include "mlir/Transforms/DialectConversion.h"
+#include "llvm/ADT/MapVector.h"
 #include "llvm/ADT/Twine.h"
 
+#include <map>
+
 #define DEBUG_TYPE "aie-create-packet-flows"
 
 using namespace mlir;
@@ -95,13 +98,15 @@ void update_coordinates(int &xCur, int &yCur, WireBundle move) {
   }
 }
 
+// The logical model of the switchboxes, ordered by their coordinates so that
+// the switchbox configurations are generated in a stable order.
+typedef std::map<TileID, SmallVector<std::pair<Connect, int>, 8>>
+    SwitchboxConnects;
+
 // Build a packet-switched route from the sourse to the destination with the
 // given ID. The route is recorded in the given map of switchboxes.
-void buildPSRoute(
-    int xSrc, int ySrc, Port sourcePort, int xDest, int yDest, Port destPort,
-    int flowID,
-    DenseMap<std::pair<int, int>, SmallVector<std::pair<Connect, int>, 8>>
-        &switchboxes) {
+void buildPSRoute(int xSrc, int ySrc, Port sourcePort, int xDest, int yDest,
+                  Port destPort, int flowID, SwitchboxConnects &switchboxes) {
   int xCur = xSrc;
   int yCur = ySrc;
   WireBundle curBundle;
@@ -212,7 +217,7 @@ SwitchboxOp getOrCreateSwitchbox(OpBuilder &builder, TileOp tile) {
 struct AIERoutePacketFlowsPass
     : public AIERoutePacketFlowsBase<AIERoutePacketFlowsPass> {
   // Map from tile coordinates to TileOp
-  DenseMap<std::pair<int, int>, Operation *> tiles;
+  std::map<TileID, Operation *> tiles;
   Operation *getOrCreateTile(OpBuilder &builder, int col, int row) {
     auto index = std::make_pair(col, row);
     Operation *tileOp = tiles[index];
@@ -247,8 +252,11 @@ struct AIERoutePacketFlowsPass
     // to the dest swboxes, and only use packet-switch to route at the dest
     // swboxes
 
-    // Map from a port and flowID to
-    DenseMap<std::pair<PhysPort, int>, SmallVector<PhysPort, 4>> packetFlows;
+    // Map from a port and flowID to the ports it is routed to.  The maps keyed
+    // by operations are iterated in insertion order, which unlike their
+    // addresses does not change from one run to the next.
+    llvm::MapVector<std::pair<PhysPort, int>, SmallVector<PhysPort, 4>>
+        packetFlows;
     SmallVector<std::pair<PhysPort, int>, 4> slavePorts;
     DenseMap<std::pair<PhysPort, int>, int> slaveAMSels;
 
@@ -259,8 +267,7 @@ struct AIERoutePacketFlowsPass
     }
 
     // The logical model of all the switchboxes.
-    DenseMap<std::pair<int, int>, SmallVector<std::pair<Connect, int>, 8>>
-        switchboxes;
+    SwitchboxConnects switchboxes;
     for (auto pktflow : m.getOps<PacketFlowOp>()) {
       Region &r = pktflow.getPorts();
       Block &b = r.front();
@@ -329,7 +336,8 @@ struct AIERoutePacketFlowsPass
 
     // A map from Tile and master selectValue to the ports targetted by that
     // master select.
-    DenseMap<std::pair<Operation *, int>, SmallVector<Port, 4>> masterAMSels;
+    llvm::MapVector<std::pair<Operation *, int>, SmallVector<Port, 4>>
+        masterAMSels;
 
     // Count of currently used logical arbiters for each tile.
     DenseMap<Operation *, int> amselValues;
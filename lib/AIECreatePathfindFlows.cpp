@@ -95,8 +95,8 @@ public:
   ModuleOp &module;
   int maxcol, maxrow;
   Pathfinder pathfinder;
-  std::map<PathEndPoint, SwitchSettings> flow_solutions;
-  std::map<PathEndPoint, bool> processed_flows;
+  FlowSolutions flow_solutions;
+  std::map<PathEndPoint, bool, PathEndPointLess> processed_flows;
 
   DenseMap<Coord, TileOp> coordToTile;
   DenseMap<Coord, SwitchboxOp> coordToSwitchbox;
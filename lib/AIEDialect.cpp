@@ -16,6 +16,7 @@
 #include "mlir/Transforms/InliningUtils.h"
 #include "llvm/ADT/DenseSet.h"
 #include "llvm/ADT/SmallSet.h"
+#include "llvm/ADT/StringExtras.h"
 
 using namespace mlir;
 
@@ -694,6 +695,65 @@ LogicalResult xilinx::AIE::PacketFlowOp::verify() {
   return success();
 }
 
+// TraceOp
+LogicalResult xilinx::AIE::TraceOp::verify() {
+  if (getTileOp().isShimTile())
+    return emitOpError("shim tiles do not have a core or memory trace unit");
+
+  auto events = getEvents();
+  if (events.empty() || events.size() > 8)
+    return emitOpError("must trace between 1 and 8 events");
+  auto isEventName = [](StringRef name) {
+    return !name.empty() && llvm::all_of(name, [](char c) {
+      return llvm::isUpper(c) || llvm::isDigit(c) || c == '_';
+    });
+  };
+  for (auto event : events.getAsValueRange<StringAttr>())
+    if (!isEventName(event))
+      return emitOpError("invalid event name '") << event << "'";
+  if (!isEventName(getStart()) || !isEventName(getStop()))
+    return emitOpError("invalid start or stop event name");
+
+  if (getDest()) {
+    if (!getDestTileOp().isShimNOCTile())
+      return emitOpError("trace destination must be a shim tile with a DMA");
+    if (!getDestChannel())
+      return emitOpError("trace destination must have a DMA channel");
+  }
+
+  // Trace streams are told apart by their packet ID.
+  for (auto other : getOperation()->getBlock()->getOps<TraceOp>())
+    if (other != *this && other.getPacketID() == getPacketID())
+      return emitOpError("packet ID ")
+             << getPacketID() << " is used by more than one trace";
+
+  // The only packet flow allowed to share the ID is the one carrying this
+  // trace stream, as created by AIERouteTraces.
+  for (auto flow : getOperation()->getBlock()->getOps<PacketFlowOp>()) {
+    if (flow.IDInt() != (int)getPacketID())
+      continue;
+    bool carriesTrace = llvm::any_of(
+        flow.getPorts().front().getOps<PacketSourceOp>(), [&](auto source) {
+          return source.getTile() == getTile() &&
+                 source.getBundle() == WireBundle::Trace &&
+                 source.channelIndex() == traceChannel();
+        });
+    if (!carriesTrace)
+      return emitOpError("packet ID ")
+             << getPacketID() << " is used by a packet flow";
+  }
+
+  return success();
+}
+xilinx::AIE::TileOp xilinx::AIE::TraceOp::getTileOp() {
+  return cast<xilinx::AIE::TileOp>(getTile().getDefiningOp());
+}
+xilinx::AIE::TileOp xilinx::AIE::TraceOp::getDestTileOp() {
+  return cast<xilinx::AIE::TileOp>(getDest().getDefiningOp());
+}
+int xilinx::AIE::TraceOp::colIndex() { return getTileOp().colIndex(); }
+int xilinx::AIE::TraceOp::rowIndex() { return getTileOp().rowIndex(); }
+
 // CoreOp
 LogicalResult xilinx::AIE::CoreOp::verify() {
   assert(getOperation()->getNumRegions() == 1 && "CoreOp has zero region!");
@@ -0,0 +1,89 @@
+//===- AIEEstimateCodeSize.cpp ----------------------------------*- C++ -*-===//
+//
+// This file is licensed under the Apache License v2.0 with LLVM Exceptions.
+// See https://llvm.org/LICENSE.txt for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+//
+// (c) Copyright 2022 Xilinx Inc.
+//
+//===----------------------------------------------------------------------===//
+
+// This pass estimates the size of the program of a core lowered to the LLVM
+// dialect, so that a core overflowing its program memory is found before the
+// backend compiler runs.  The estimate counts one instruction per operation,
+// which is coarse, but enough to notice a loop body duplicated too many
+// times.
+
+#include "aie/AIEDialect.h"
+#include "mlir/IR/Attributes.h"
+#include "mlir/IR/FunctionInterfaces.h"
+#include "mlir/Interfaces/SideEffectInterfaces.h"
+#include "mlir/Pass/Pass.h"
+
+#define DEBUG_TYPE "aie-estimate-code-size"
+
+using namespace mlir;
+using namespace xilinx;
+using namespace xilinx::AIE;
+
+// Bytes of a scalar instruction, of a vector instruction, which is issued in
+// a wider VLIW bundle, and of the prologue and epilogue of a function.
+static const int64_t scalarInstrBytes = 4;
+static const int64_t vectorInstrBytes = 16;
+static const int64_t functionBytes = 16;
+
+static int64_t estimateOpSize(Operation *op) {
+  // Constants, addresses of globals and the like are folded into the
+  // instructions that use them.  Branches and returns without operands are
+  // instructions of their own.
+  if (op->getNumOperands() == 0 && op->getNumRegions() == 0 &&
+      op->getNumSuccessors() == 0 && !op->hasTrait<OpTrait::IsTerminator>() &&
+      MemoryEffectOpInterface::hasNoEffect(op))
+    return 0;
+  if (isa<UnrealizedConversionCastOp>(op))
+    return 0;
+  auto isVector = [](Type t) { return t.isa<VectorType>(); };
+  if (llvm::any_of(op->getOperandTypes(), isVector) ||
+      llvm::any_of(op->getResultTypes(), isVector))
+    return vectorInstrBytes;
+  return scalarInstrBytes;
+}
+
+struct AIEEstimateCodeSizePass
+    : public AIEEstimateCodeSizeBase<AIEEstimateCodeSizePass> {
+  void runOnOperation() override {
+    ModuleOp m = getOperation();
+
+    int64_t total = 0;
+    int64_t largest = 0;
+    StringRef largestName;
+    m.walk([&](FunctionOpInterface func) {
+      if (func.isExternal())
+        return;
+      int64_t size = functionBytes;
+      func->walk([&](Operation *op) {
+        if (op != func.getOperation())
+          size += estimateOpSize(op);
+      });
+      total += size;
+      if (size > largest) {
+        largest = size;
+        largestName = SymbolTable::getSymbolName(func).getValue();
+      }
+    });
+
+    OpBuilder builder(m.getContext());
+    m->setAttr("AIE.code_size", builder.getI64IntegerAttr(total));
+    if (total > budget)
+      m.emitWarning("estimated code size of ")
+          << total << " bytes exceeds the program memory budget of " << budget
+          << " bytes, largest function: @" << largestName << " (" << largest
+          << " bytes)";
+    markAllAnalysesPreserved();
+  }
+};
+
+std::unique_ptr<OperationPass<ModuleOp>>
+xilinx::AIE::createAIEEstimateCodeSizePass() {
+  return std::make_unique<AIEEstimateCodeSizePass>();
+}
@@ -25,6 +25,7 @@
 #include "mlir/Pass/Pass.h"
 #include "mlir/Tools/mlir-translate/MlirTranslateMain.h"
 #include "mlir/Transforms/DialectConversion.h"
+#include "llvm/ADT/MapVector.h"
 #include "llvm/Support/Debug.h"
 #include <numeric>
 
@@ -99,10 +100,11 @@ struct AIEObjectFifoStatefulTransformPass
       buffersPerFifo; // maps each objFifo to its corresponding elements
   DenseMap<ObjectFifoCreateOp, std::vector<LockOp>>
       locksPerFifo; // maps each objFifo to its corresponding locks
-  DenseMap<ObjectFifoCreateOp,
-           std::pair<ObjectFifoCreateOp, ObjectFifoCreateOp>>
+  llvm::MapVector<ObjectFifoCreateOp,
+                  std::pair<ObjectFifoCreateOp, ObjectFifoCreateOp>>
       splitFifos;     // maps each objFifo between non-adjacent tiles to its
-                      // corresponding producer and consumer objectFifos
+                      // corresponding producer and consumer objectFifos, in
+                      // the order of the module
   int buff_index = 0; // used to give objectFifo buffer elements a symbolic name
 
   /// Function used to create objectFifo elements and their locks.
@@ -156,11 +156,10 @@ void Pathfinder::addFixedConnection(Coord coords, Port port) {
 //
 // returns a map specifying switchbox settings for all flows
 // if no legal routing can be found after MAX_ITERATIONS, returns empty vector
-std::map<PathEndPoint, SwitchSettings>
-Pathfinder::findPaths(const int MAX_ITERATIONS) {
+FlowSolutions Pathfinder::findPaths(const int MAX_ITERATIONS) {
   LLVM_DEBUG(llvm::dbgs() << "Begin Pathfinder::findPaths\n");
   int iteration_count = 0;
-  std::map<PathEndPoint, SwitchSettings> routing_solution;
+  FlowSolutions routing_solution;
 
   // initialize all Channel histories to 0
   auto edge_pair = edges(graph);
@@ -0,0 +1,383 @@
+//===- AIEPlaceTiles.cpp ----------------------------------------*- C++ -*-===//
+//
+// This file is licensed under the Apache License v2.0 with LLVM Exceptions.
+// See https://llvm.org/LICENSE.txt for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+//
+// (c) Copyright 2022 Xilinx Inc.
+//
+//===----------------------------------------------------------------------===//
+
+// This pass places the tiles with a `logical` attribute on the AIE array.
+// The communication between tiles is modeled as a graph whose edges are the
+// flows, objectFifos and shared buffers and locks of the design, and the
+// placement minimizing its cost is found with simulated annealing, following
+// the schedule of VPR (Betz and Rose, "VPR: A New Packing, Placement and
+// Routing Tool for FPGA Research", 1997).
+
+#include "aie/AIEDialect.h"
+#include "mlir/IR/Attributes.h"
+#include "mlir/Pass/Pass.h"
+
+#include "llvm/Support/Debug.h"
+
+#include <cmath>
+#include <cstdlib>
+#include <random>
+
+#define DEBUG_TYPE "aie-place-tiles"
+
+using namespace mlir;
+using namespace xilinx;
+using namespace xilinx::AIE;
+
+namespace {
+
+enum class EdgeKind { Stream, ObjectFifo, SharedMemory };
+
+// Communication between tiles a and b.  For SharedMemory edges, a is the tile
+// of the core and b the tile of the memory it accesses.  For ObjectFifo edges,
+// a is the producer and b the consumer.
+struct Edge {
+  unsigned a, b;
+  EdgeKind kind;
+  double volume;
+};
+
+// The cost of a core accessing a memory it is not adjacent to.
+static const double sharedMemoryPenalty = 1000.0;
+
+static int distance(TileID a, TileID b) {
+  return std::abs(a.first - b.first) + std::abs(a.second - b.second);
+}
+
+} // namespace
+
+struct AIEPlaceTilesPass : public AIEPlaceTilesBase<AIEPlaceTilesPass> {
+  SmallVector<TileOp, 32> tiles;
+  DenseMap<Value, unsigned> tileIndex;
+  SmallVector<TileID, 32> position;
+  SmallVector<unsigned, 32> movable;
+  SmallVector<Edge, 64> edges;
+  SmallVector<SmallVector<unsigned, 4>, 32> incident;
+
+  // The sites of the fixed tiles, and the site of each movable tile.
+  DenseSet<TileID> fixedSites;
+  DenseMap<TileID, unsigned> occupant;
+
+  void addEdge(Value a, Value b, EdgeKind kind, Operation *op) {
+    if (!tileIndex.count(a) || !tileIndex.count(b) || a == b)
+      return;
+    double volume = 1.0;
+    if (auto attr = op->getAttrOfType<IntegerAttr>("volume"))
+      volume = attr.getInt();
+    unsigned e = edges.size();
+    edges.push_back({tileIndex[a], tileIndex[b], kind, volume});
+    incident[tileIndex[a]].push_back(e);
+    incident[tileIndex[b]].push_back(e);
+  }
+
+  void buildGraph(ModuleOp m) {
+    for (auto tile : m.getOps<TileOp>()) {
+      tileIndex[tile] = tiles.size();
+      tiles.push_back(tile);
+      position.push_back({tile.colIndex(), tile.rowIndex()});
+      incident.emplace_back();
+      if (tile->hasAttr("logical"))
+        movable.push_back(tiles.size() - 1);
+      else
+        fixedSites.insert(position.back());
+    }
+
+    for (auto flow : m.getOps<FlowOp>())
+      addEdge(flow.getSource(), flow.getDest(), EdgeKind::Stream, flow);
+    for (auto packetFlow : m.getOps<PacketFlowOp>()) {
+      Value source;
+      for (auto &op : packetFlow.getPorts().front())
+        if (auto packetSource = dyn_cast<PacketSourceOp>(op))
+          source = packetSource.getTile();
+      for (auto &op : packetFlow.getPorts().front())
+        if (auto packetDest = dyn_cast<PacketDestOp>(op))
+          addEdge(source, packetDest.getTile(), EdgeKind::Stream, packetFlow);
+    }
+    for (auto fifo : m.getOps<ObjectFifoCreateOp>())
+      addEdge(fifo.getProducerTile(), fifo.getConsumerTile(),
+              EdgeKind::ObjectFifo, fifo);
+
+    // The buffers and locks of other tiles used in the body of each core.
+    for (auto core : m.getOps<CoreOp>()) {
+      DenseSet<Value> memories;
+      core.walk([&](Operation *op) {
+        for (Value operand : op->getOperands()) {
+          Operation *def = operand.getDefiningOp();
+          if (auto buffer = dyn_cast_or_null<BufferOp>(def))
+            memories.insert(buffer.getTile());
+          else if (auto lock = dyn_cast_or_null<LockOp>(def))
+            memories.insert(lock.getTile());
+        }
+      });
+      for (Value memory : memories)
+        addEdge(core.getTile(), memory, EdgeKind::SharedMemory, core);
+    }
+  }
+
+  bool memoryAdjacent(const Edge &e) {
+    TileID a = position[e.a], b = position[e.b];
+    if (isLegalMemAffinity(a.first, a.second, b.first, b.second))
+      return true;
+    // The buffers of an objectFifo can also be in the memory of its producer.
+    return e.kind == EdgeKind::ObjectFifo &&
+           isLegalMemAffinity(b.first, b.second, a.first, a.second);
+  }
+
+  double cost(const Edge &e) {
+    switch (e.kind) {
+    case EdgeKind::Stream:
+      return e.volume * distance(position[e.a], position[e.b]);
+    case EdgeKind::ObjectFifo:
+      if (memoryAdjacent(e))
+        return 0;
+      return e.volume * (distance(position[e.a], position[e.b]) + 2);
+    case EdgeKind::SharedMemory:
+      return memoryAdjacent(e) ? 0 : e.volume * sharedMemoryPenalty;
+    }
+    llvm_unreachable("unknown edge kind");
+  }
+
+  double totalCost() {
+    double total = 0;
+    for (auto &e : edges)
+      total += cost(e);
+    return total;
+  }
+
+  double cost(ArrayRef<unsigned> edgeSet) {
+    double total = 0;
+    for (unsigned e : edgeSet)
+      total += cost(edges[e]);
+    return total;
+  }
+
+  bool isSite(TileID site) {
+    return site.first >= 0 && site.first < cols && site.second >= 1 &&
+           site.second <= rows;
+  }
+
+  // Move tile t to site, swapping it with the movable tile placed there, if
+  // any.
+  void move(unsigned t, TileID site) {
+    TileID from = position[t];
+    auto it = occupant.find(site);
+    if (it != occupant.end()) {
+      unsigned other = it->second;
+      position[other] = from;
+      occupant[from] = other;
+    } else {
+      occupant.erase(from);
+    }
+    position[t] = site;
+    occupant[site] = t;
+  }
+
+  // Place the movable tiles on their coordinates, if free, and on the first
+  // free sites otherwise.
+  LogicalResult initialPlacement() {
+    SmallVector<unsigned, 8> unplaced;
+    for (unsigned t : movable) {
+      if (isSite(position[t]) && !fixedSites.count(position[t]) &&
+          !occupant.count(position[t]))
+        occupant[position[t]] = t;
+      else
+        unplaced.push_back(t);
+    }
+    auto *next = unplaced.begin();
+    for (int col = 0; col < cols && next != unplaced.end(); col++)
+      for (int row = 1; row <= rows && next != unplaced.end(); row++) {
+        TileID site = {col, row};
+        if (fixedSites.count(site) || occupant.count(site))
+          continue;
+        position[*next] = site;
+        occupant[site] = *next++;
+      }
+    if (next != unplaced.end())
+      return tiles[*next].emitError("no free tile left to place this tile on");
+    return success();
+  }
+
+  void anneal() {
+    std::mt19937 rng(seed);
+    auto uniform = [&](int lo, int hi) {
+      return std::uniform_int_distribution<int>(lo, hi)(rng);
+    };
+    auto probability = [&]() {
+      return std::uniform_real_distribution<double>(0, 1)(rng);
+    };
+
+    double current = totalCost();
+    double best = current;
+    SmallVector<TileID, 32> bestPosition(position);
+    int maxRange = std::max<int>(cols, rows);
+    double range = maxRange;
+
+    // Try a random move of a random tile, and keep it if accept(delta).
+    SmallVector<unsigned, 16> affected;
+    auto tryMove = [&](function_ref<bool(double)> accept) {
+      unsigned t = movable[uniform(0, movable.size() - 1)];
+      int r = std::max(1, (int)range);
+      TileID from = position[t];
+      TileID site = {uniform(std::max(0, from.first - r),
+                             std::min(cols - 1, from.first + r)),
+                     uniform(std::max(1, from.second - r),
+                             std::min((int)rows, from.second + r))};
+      if (site == from || fixedSites.count(site))
+        return false;
+
+      affected.assign(incident[t].begin(), incident[t].end());
+      auto it = occupant.find(site);
+      if (it != occupant.end())
+        affected.append(incident[it->second].begin(),
+                        incident[it->second].end());
+      llvm::sort(affected);
+      affected.erase(std::unique(affected.begin(), affected.end()),
+                     affected.end());
+
+      double before = cost(affected);
+      move(t, site);
+      double delta = cost(affected) - before;
+      if (!accept(delta)) {
+        move(t, from);
+        return false;
+      }
+      current += delta;
+      if (current < best) {
+        best = current;
+        bestPosition = position;
+      }
+      return true;
+    };
+
+    // The initial temperature is 20 times the standard deviation of the cost
+    // over random moves.
+    unsigned n = movable.size();
+    double sum = 0, sumSquares = 0;
+    for (unsigned i = 0; i < n; i++) {
+      tryMove([](double) { return true; });
+      sum += current;
+      sumSquares += current * current;
+    }
+    double mean = sum / n;
+    double temperature =
+        20 * std::sqrt(std::max(0.0, sumSquares / n - mean * mean));
+
+    unsigned movesPerTemperature =
+        std::max(1.0, effort * std::pow((double)n, 4.0 / 3.0));
+    auto metropolis = [&](double delta) {
+      return delta <= 0 || probability() < std::exp(-delta / temperature);
+    };
+    while (current > 0 &&
+           temperature > 0.005 * current / std::max<size_t>(edges.size(), 1)) {
+      unsigned accepted = 0;
+      for (unsigned i = 0; i < movesPerTemperature; i++)
+        accepted += tryMove(metropolis);
+
+      double rate = (double)accepted / movesPerTemperature;
+      if (rate > 0.96)
+        temperature *= 0.5;
+      else if (rate > 0.8)
+        temperature *= 0.9;
+      else if (rate > 0.15)
+        temperature *= 0.95;
+      else
+        temperature *= 0.8;
+      range = std::min<double>(std::max(range * (0.56 + rate), 1.0), maxRange);
+      LLVM_DEBUG(llvm::dbgs() << "temperature " << temperature << " cost "
+                              << current << " acceptance " << rate << "\n");
+    }
+
+    // Finish with the greedy moves in the neighborhood of the best placement.
+    for (unsigned t : movable)
+      occupant.erase(position[t]);
+    position = bestPosition;
+    for (unsigned t : movable)
+      occupant[position[t]] = t;
+    current = best;
+    range = 1;
+    for (unsigned i = 0; i < movesPerTemperature; i++)
+      tryMove([](double delta) { return delta < 0; });
+  }
+
+  void reportQuality(ModuleOp m, double initialCost, int initialWirelength,
+                     int initialAdjacent) {
+    int wirelength = 0, fifos = 0, adjacent = 0;
+    for (auto &e : edges) {
+      if (e.kind == EdgeKind::Stream)
+        wirelength += distance(position[e.a], position[e.b]);
+      if (e.kind == EdgeKind::ObjectFifo) {
+        fifos++;
+        adjacent += memoryAdjacent(e);
+      }
+    }
+    // Volumes and penalties are integers, and so are the costs.
+    m.emitRemark() << "placed " << movable.size() << " tiles: cost "
+                   << (int64_t)totalCost() << " (initially "
+                   << (int64_t)initialCost
+                   << "), stream wirelength " << wirelength << " (initially "
+                   << initialWirelength << "), " << adjacent << " of " << fifos
+                   << " objectFifos through shared memory (initially "
+                   << initialAdjacent << ")";
+  }
+
+  void runOnOperation() override {
+    ModuleOp m = getOperation();
+    // The pass may run on several modules.
+    tiles.clear();
+    tileIndex.clear();
+    position.clear();
+    movable.clear();
+    edges.clear();
+    incident.clear();
+    fixedSites.clear();
+    occupant.clear();
+    buildGraph(m);
+    if (movable.empty())
+      return;
+    if (failed(initialPlacement()))
+      return signalPassFailure();
+
+    double initialCost = totalCost();
+    int initialWirelength = 0, initialAdjacent = 0;
+    for (auto &e : edges) {
+      if (e.kind == EdgeKind::Stream)
+        initialWirelength += distance(position[e.a], position[e.b]);
+      if (e.kind == EdgeKind::ObjectFifo)
+        initialAdjacent += memoryAdjacent(e);
+    }
+
+    anneal();
+
+    OpBuilder builder(m.getContext());
+    for (unsigned t : movable) {
+      tiles[t].setColAttr(builder.getI32IntegerAttr(position[t].first));
+      tiles[t].setRowAttr(builder.getI32IntegerAttr(position[t].second));
+      tiles[t]->removeAttr("logical");
+    }
+    if (report)
+      reportQuality(m, initialCost, initialWirelength, initialAdjacent);
+
+    bool legal = true;
+    for (auto &e : edges)
+      if (e.kind == EdgeKind::SharedMemory && !memoryAdjacent(e)) {
+        tiles[e.a].getCoreOp().emitError("core cannot access the memory of ")
+            << "tile (" << position[e.b].first << ", " << position[e.b].second
+            << ") after placement";
+        legal = false;
+      }
+    if (!legal)
+      signalPassFailure();
+  }
+};
+
+std::unique_ptr<OperationPass<ModuleOp>>
+xilinx::AIE::createAIEPlaceTilesPass() {
+  return std::make_unique<AIEPlaceTilesPass>();
+}
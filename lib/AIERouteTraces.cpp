@@ -0,0 +1,55 @@
+//===- AIERouteTraces.cpp ---------------------------------------*- C++ -*-===//
+//
+// This file is licensed under the Apache License v2.0 with LLVM Exceptions.
+// See https://llvm.org/LICENSE.txt for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+//
+// (c) Copyright 2022 Xilinx Inc.
+//
+//===----------------------------------------------------------------------===//
+
+#include "aie/AIEDialect.h"
+#include "mlir/IR/Attributes.h"
+#include "mlir/IR/Location.h"
+#include "mlir/Pass/Pass.h"
+
+#define DEBUG_TYPE "aie-route-traces"
+
+using namespace mlir;
+using namespace xilinx;
+using namespace xilinx::AIE;
+
+struct AIERouteTracesPass : public AIERouteTracesBase<AIERouteTracesPass> {
+  void runOnOperation() override {
+
+    ModuleOp m = getOperation();
+    OpBuilder builder = OpBuilder::atBlockEnd(m.getBody());
+
+    for (auto trace : m.getOps<TraceOp>()) {
+      if (!trace.getDest())
+        continue;
+
+      // The trace unit emits packets carrying the trace's packet ID, so the
+      // stream shares the packet-switched network with other packet flows.
+      // The shim DMA BDs receiving it are left to the design.
+      builder.setInsertionPointAfter(trace);
+      PacketFlowOp pkFlow =
+          builder.create<PacketFlowOp>(trace.getLoc(), trace.getPacketID());
+      Block *b = builder.createBlock(&pkFlow.getPorts());
+      builder.setInsertionPointToStart(b);
+      builder.create<PacketSourceOp>(trace.getLoc(), trace.getTileOp(),
+                                     WireBundle::Trace, trace.traceChannel());
+      builder.create<PacketDestOp>(trace.getLoc(), trace.getDestTileOp(),
+                                   WireBundle::DMA, *trace.getDestChannel());
+      builder.create<EndOp>(trace.getLoc());
+
+      trace.getDestMutable().clear();
+      trace.removeDestChannelAttr();
+    }
+  }
+};
+
+std::unique_ptr<OperationPass<ModuleOp>>
+xilinx::AIE::createAIERouteTracesPass() {
+  return std::make_unique<AIERouteTracesPass>();
+}
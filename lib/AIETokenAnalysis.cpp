@@ -134,9 +134,9 @@ std::pair<int, int> xilinx::AIE::TokenAnalysis::getCoord(Operation *Op) {
   return std::make_pair(colIndex, rowIndex);
 }
 
-SmallSet<TileOp, 4>
+SmallSetVector<TileOp, 4>
 xilinx::AIE::TokenAnalysis::getAccessibleTileOp(Operation *Op) {
-  SmallSet<TileOp, 4> possibleTiles;
+  SmallSetVector<TileOp, 4> possibleTiles;
 
   bool IsOpCore = isa<CoreOp>(Op);
   auto coord1 = getCoord(Op);
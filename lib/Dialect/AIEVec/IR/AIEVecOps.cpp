@@ -7,7 +7,8 @@
 // (c) Copyright 2022 Xilinx Inc.
 //
 //===----------------------------------------------------------------------===//
-// This file implements AIE vector op printing, pasing, and verification.
+// This file implements AIE vector op printing, pasing, verification, and
+// folding.
 //===----------------------------------------------------------------------===//
 
 #include "aie/Dialect/AIEVec/IR/AIEVecOps.h"
@@ -130,6 +131,34 @@ ParseResult UPDOp::parse(OpAsmParser &parser, OperationState &result) {
   return parser.addTypeToList(vectorType, result.types);
 }
 
+// Return true if any op strictly between 'from' and 'to', which are in the
+// same block, may write to memory. Ops that do not describe their memory
+// effects, e.g. loops and calls, are assumed to write.
+static bool mayWriteBetween(Operation *from, Operation *to) {
+  for (Operation *op = from->getNextNode(); op != to; op = op->getNextNode()) {
+    auto effectOp = dyn_cast<MemoryEffectOpInterface>(op);
+    if (!effectOp || effectOp.hasEffect<MemoryEffects::Write>())
+      return true;
+  }
+  return false;
+}
+
+// Fold a UPD op that re-reads the same lanes from the same location into the
+// vector it is linked to. The linked vector already holds those lanes, as
+// long as nothing between the two reads may have written to memory.
+OpFoldResult UPDOp::fold(ArrayRef<Attribute> operands) {
+  auto prevOp = dyn_cast_or_null<UPDOp>(
+      getVector() ? getVector().getDefiningOp() : nullptr);
+  if (!prevOp || prevOp.getSource() != getSource() ||
+      prevOp.getOffset() != getOffset() || prevOp.getIndex() != getIndex() ||
+      !llvm::equal(prevOp.getIndices(), getIndices()))
+    return nullptr;
+  if (prevOp->getBlock() != (*this)->getBlock() ||
+      mayWriteBetween(prevOp, *this))
+    return nullptr;
+  return prevOp.getResult();
+}
+
 //===----------------------------------------------------------------------===//
 // SRSOp
 //===----------------------------------------------------------------------===//
@@ -216,6 +245,16 @@ ParseResult SRSOp::parse(OpAsmParser &parser, OperationState &result) {
   return parser.addTypeToList(vectorType, result.types);
 }
 
+// Fold srs(ups(x, shift), shift) to x. Moving a vector into the accumulator
+// and back with the same shift leaves it unchanged.
+OpFoldResult SRSOp::fold(ArrayRef<Attribute> operands) {
+  auto upsOp = getSource().getDefiningOp<UPSOp>();
+  if (!upsOp || upsOp.getShift() != getShift() ||
+      upsOp.getSource().getType() != getResult().getType())
+    return nullptr;
+  return upsOp.getSource();
+}
+
 //===----------------------------------------------------------------------===//
 // UPSOp
 //===----------------------------------------------------------------------===//
@@ -395,20 +434,26 @@ template <typename T> LogicalResult verifyMulFMAOp(T op) {
   unsigned rhsLanes = getVectorLaneSize(rhsType);
   unsigned lhsLanes = getVectorLaneSize(lhsType);
 
-  // If this is not a simple scheme, perform complex checks
+  // If this is not a simple scheme, perform complex checks. The operand
+  // sizes are compared in bits, since the operands of the mixed-precision
+  // schemes have different element types.
   if (accLanes != rhsLanes || accLanes != lhsLanes) {
     if (rhsLanes != 256 / rtypeWidth)
       return op.emitError("incorrect rhs operand vector lanes");
-    if (lhsLanes < 2 * rhsLanes)
-      return op.emitError("The number of lanes in lhs operand "
+    if (lhsLanes * ltypeWidth < 2 * rhsLanes * rtypeWidth)
+      return op.emitError("The size of lhs operand vector "
                           "must be at least twice that of rhs operand");
     if (accLanes > rhsLanes)
       return op.emitError("The number of lanes in accumulator "
                           "must be less than that of rhs operand");
   }
 
-  // lhs and rhs vector's element type must match
-  if (ltype != rtype)
+  // lhs and rhs vector's element type must match, except for the
+  // mixed-precision integer schemes (16x8 and 32x16), where the lhs operand
+  // has the wider element type.
+  bool isMixedInt = ltype.isa<IntegerType>() && rtype.isa<IntegerType>() &&
+                    ltypeWidth > rtypeWidth;
+  if (ltype != rtype && !isMixedInt)
     return op.emitError("The element type of lhs and rhs "
                         "operand vectors must match");
 
@@ -425,7 +470,12 @@ template <typename T> LogicalResult verifyMulFMAOp(T op) {
       return op.emitError("Floating point result must have "
                           "floating point operands");
 
-    if (ltypeWidth != atypeWidth || rtypeWidth != atypeWidth)
+    // bf16 operands accumulate in f32
+    if (ltype.isBF16()) {
+      if (!atype.isF32())
+        return op.emitError("the element type of accumulator must be "
+                            "f32 for bf16 operand vectors");
+    } else if (ltypeWidth != atypeWidth || rtypeWidth != atypeWidth)
       return op.emitError("the element type of accumulator must be "
                           "same width as the operand vectors");
   }
@@ -704,6 +754,21 @@ ParseResult ConcatOp::parse(OpAsmParser &parser, OperationState &result) {
   return parser.addTypeToList(resultType, result.types);
 }
 
+// Fold concat(ext(x, 0), ext(x, 1), ...) back to x.
+OpFoldResult ConcatOp::fold(ArrayRef<Attribute> operands) {
+  Value source;
+  for (auto it : llvm::enumerate(getSources())) {
+    auto extOp = it.value().getDefiningOp<ExtOp>();
+    if (!extOp || extOp.getIndex() != it.index() ||
+        (source && extOp.getSource() != source))
+      return nullptr;
+    source = extOp.getSource();
+  }
+  if (source.getType() != getResult().getType())
+    return nullptr;
+  return source;
+}
+
 //===----------------------------------------------------------------------===//
 // ExtOp
 //===----------------------------------------------------------------------===//
@@ -789,6 +854,15 @@ ParseResult ExtOp::parse(OpAsmParser &parser, OperationState &result) {
   return parser.addTypeToList(resultType, result.types);
 }
 
+// Fold ext(concat(x0, x1, ...), i) to xi.
+OpFoldResult ExtOp::fold(ArrayRef<Attribute> operands) {
+  auto concatOp = getSource().getDefiningOp<ConcatOp>();
+  if (!concatOp ||
+      concatOp.getSources().getTypes().front() != getResult().getType())
+    return nullptr;
+  return concatOp.getSources()[getIndex()];
+}
+
 //===----------------------------------------------------------------------===//
 // SelectOp
 //===----------------------------------------------------------------------===//
@@ -902,6 +976,44 @@ ParseResult SelectOp::parse(OpAsmParser &parser, OperationState &result) {
   return parser.addTypeToList(resultType, result.types);
 }
 
+// Fold a select that picks every lane of the result, in order, from the
+// first set of lanes of xbuff. Only the 32-bit lane layout is recognized,
+// where the offset of each lane is a single hex digit.
+OpFoldResult aievec::SelectOp::fold(ArrayRef<Attribute> operands) {
+  VectorType resultType = getResult().getType().cast<VectorType>();
+  if (getXbuff().getType() != resultType ||
+      resultType.getElementType().getIntOrFloatBitWidth() != 32)
+    return nullptr;
+
+  // All the lanes must come from the first set
+  uint64_t select, start;
+  if (getSelect().empty() || getSelect().getAsInteger(0, select) ||
+      select != 0)
+    return nullptr;
+  if (!getXsquare().empty() ||
+      (!getXstart().empty() && (getXstart().getAsInteger(0, start) || start)))
+    return nullptr;
+
+  // The offsets must be the identity permutation. The hi offsets cover lanes
+  // 8-15 of a 16-lane select.
+  unsigned lanes = getVectorLaneSize(resultType);
+  if (lanes != 8 && lanes != 16)
+    return nullptr;
+  auto isIdentity = [](StringRef offsets, uint64_t base) {
+    uint64_t value;
+    if (offsets.getAsInteger(0, value))
+      return false;
+    for (uint64_t lane = 0; lane < 8; ++lane, value >>= 4)
+      if ((value & 0xf) != base + lane)
+        return false;
+    return true;
+  };
+  if (!isIdentity(getXoffsets(), 0) ||
+      (lanes == 16 && !isIdentity(getXoffsetsHi(), 8)))
+    return nullptr;
+  return getXbuff();
+}
+
 //===----------------------------------------------------------------------===//
 // PackOp and UnpackOp
 //===----------------------------------------------------------------------===//
@@ -1004,6 +1116,15 @@ ParseResult PackOp::parse(OpAsmParser &parser, OperationState &result) {
   return parsePackUnpackOp(parser, result);
 }
 
+// Fold pack(unpack(x)) to x. Unpacking widens each lane without loss, so
+// packing it again restores the original vector.
+OpFoldResult PackOp::fold(ArrayRef<Attribute> operands) {
+  auto unpackOp = getSource().getDefiningOp<UnpackOp>();
+  if (!unpackOp || unpackOp.getSource().getType() != getResult().getType())
+    return nullptr;
+  return unpackOp.getSource();
+}
+
 ParseResult UnpackOp::parse(OpAsmParser &parser, OperationState &result) {
   return parsePackUnpackOp(parser, result);
 }
@@ -0,0 +1,501 @@
+//===- AIEVecToStandard.cpp - Lower AIEVec ops to intrinsics ---*- C++ -*-===//
+//
+// This file is licensed under the Apache License v2.0 with LLVM Exceptions.
+// See https://llvm.org/LICENSE.txt for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+//
+// (c) Copyright 2022 Xilinx Inc.
+//
+//===----------------------------------------------------------------------===//
+// This file implements the lowering of AIE vector ops to calls of the
+// llvm.aie.* intrinsics, so that vectorized cores can take the same path to
+// LLVM IR as the ops lowered by aie-standard-lowering. No LLVM backend defines
+// AIE1 vector intrinsics, so these names and signatures are a placeholder ABI
+// for the backend that consumes the LLVM IR. They mirror the AIE C intrinsics
+// generated by the AIEVec C++ emitter: the name is the C intrinsic name with
+// '_' replaced by '.', suffixed with the mangled result and argument types,
+// and the lane selection attributes are passed as i32 constants in the same
+// order as in the emitted C++.
+//===----------------------------------------------------------------------===//
+
+#include "aie/Dialect/AIEVec/AIEVecUtils.h"
+#include "aie/Dialect/AIEVec/IR/AIEVecOps.h"
+#include "aie/Dialect/AIEVec/Transforms/Passes.h"
+#include "mlir/Dialect/Arithmetic/IR/Arithmetic.h"
+#include "mlir/Dialect/Func/IR/FuncOps.h"
+#include "mlir/Dialect/MemRef/IR/MemRef.h"
+#include "mlir/Dialect/Vector/IR/VectorOps.h"
+#include "mlir/Transforms/DialectConversion.h"
+
+using namespace mlir;
+using namespace xilinx;
+using namespace xilinx::aievec;
+
+#define DEBUG_TYPE "aievec-to-standard"
+
+// Mangle the type for the suffix of an intrinsic name, e.g., vector<16xi48>
+// is mangled as v16i48.
+static std::string getMangledType(Type type) {
+  std::string mangled;
+  llvm::raw_string_ostream os(mangled);
+  if (auto vecType = type.dyn_cast<VectorType>()) {
+    os << "v" << getVectorLaneSize(vecType);
+    type = vecType.getElementType();
+  }
+  os << type;
+  return os.str();
+}
+
+// Replace op by a call to the intrinsic llvm.aie.<baseName>, overloaded on
+// the result type and the types of all the arguments. The C intrinsics are
+// overloaded on the lane selection arguments too, which are only present for
+// the attributes set on the op, so every signature gets its own name. The
+// declaration of the intrinsic is added to the module if it is not already
+// there. Fail if the module declares the name with another signature.
+static LogicalResult replaceOpWithIntrinsicCall(
+    ConversionPatternRewriter &rewriter, ModuleOp module, Operation *op,
+    StringRef baseName, Type resultType, ValueRange args) {
+  std::string funcName = "llvm.aie." + baseName.str();
+  funcName += "." + getMangledType(resultType);
+  for (Value arg : args)
+    funcName += "." + getMangledType(arg.getType());
+
+  auto funcType = FunctionType::get(rewriter.getContext(), TypeRange(args),
+                                    llvm::makeArrayRef(resultType));
+  auto func = module.lookupSymbol<func::FuncOp>(funcName);
+  if (!func) {
+    OpBuilder::InsertionGuard guard(rewriter);
+    rewriter.setInsertionPointToStart(module.getBody());
+    func = rewriter.create<func::FuncOp>(rewriter.getUnknownLoc(), funcName,
+                                         funcType);
+    func.setPrivate();
+  } else if (func.getFunctionType() != funcType)
+    return rewriter.notifyMatchFailure(op, [&](Diagnostic &diag) {
+      diag << funcName << " is already declared with type "
+           << func.getFunctionType();
+    });
+  rewriter.replaceOpWithNewOp<func::CallOp>(op, func, args);
+  return success();
+}
+
+// Create an i32 constant
+static Value createI32Constant(ConversionPatternRewriter &rewriter,
+                               Location loc, int32_t value) {
+  return rewriter.create<arith::ConstantOp>(
+      loc, rewriter.getI32Type(), rewriter.getI32IntegerAttr(value));
+}
+
+// Append the lane selection attributes to the arguments of the intrinsic as
+// i32 constants. Empty attributes are skipped, as in the C++ emitter.
+static LogicalResult appendLaneSelection(ConversionPatternRewriter &rewriter,
+                                         Location loc,
+                                         ArrayRef<StringRef> attrs,
+                                         SmallVectorImpl<Value> &args) {
+  for (StringRef attr : attrs) {
+    if (attr.empty())
+      continue;
+    uint64_t value;
+    if (attr.getAsInteger(0, value))
+      return failure();
+    args.push_back(createI32Constant(rewriter, loc, (int32_t)value));
+  }
+  return success();
+}
+
+// Append the lhs or rhs operand of an add/sub op, followed by its lane
+// selection attributes
+template <typename T>
+static LogicalResult appendAddOrSubOperand(ConversionPatternRewriter &rewriter,
+                                           T op, Value operand, unsigned opNum,
+                                           SmallVectorImpl<Value> &args) {
+  args.push_back(operand);
+  return appendLaneSelection(rewriter, op.getLoc(),
+                             {op.getStart(opNum), op.getOffset(opNum),
+                              op.getOffsetHi(opNum), op.getSquare(opNum)},
+                             args);
+}
+
+// Append the lhs or rhs operand of a mul/fma op, followed by its lane
+// selection attributes
+template <typename T>
+static LogicalResult appendFMAOrMulOperand(ConversionPatternRewriter &rewriter,
+                                           T op, Value operand, unsigned opNum,
+                                           SmallVectorImpl<Value> &args) {
+  args.push_back(operand);
+  return appendLaneSelection(rewriter, op.getLoc(),
+                             {op.getStart(opNum), op.getOffset(opNum),
+                              op.getOffsetHi(opNum), op.getStep(opNum),
+                              op.getSquare(opNum)},
+                             args);
+}
+
+// Return the name of the mul/mac/msc intrinsic, following the C++ emitter
+template <typename T>
+static std::string getFMAOrMulIntrinsicName(T op, StringRef base) {
+  VectorType resType = op.getResult().getType().template cast<VectorType>();
+  Type eltType = resType.getElementType();
+  unsigned lanes = getVectorLaneSize(resType);
+  // bf16 operands are multiplied lane-wise into an f32 accumulator
+  if (op.getLhs()
+          .getType()
+          .template cast<VectorType>()
+          .getElementType()
+          .isBF16())
+    return base.str() + ".elem." + std::to_string(lanes);
+
+  // Float mul/mac/msc are fp{mul,mac,msc} in every scheme, as fp{add,sub}
+  bool simpleScheme = op.getStart(0).empty();
+  std::string name;
+  if (eltType.isa<FloatType>())
+    name = "fp";
+  else if (!simpleScheme && getElementSizeInBits(resType) == 80)
+    name = "l";
+  name += base.str();
+  if (!simpleScheme && !eltType.isa<FloatType>())
+    name += std::to_string(lanes);
+  return name;
+}
+
+template <typename SourceOp>
+struct AIEVecOpToStdLowering : public OpConversionPattern<SourceOp> {
+  using OpConversionPattern<SourceOp>::OpConversionPattern;
+  ModuleOp &module;
+
+  AIEVecOpToStdLowering(MLIRContext *context, ModuleOp &m,
+                        PatternBenefit benefit = 1)
+      : OpConversionPattern<SourceOp>(context, benefit), module(m) {}
+};
+
+// Lower upd to a vector load if the result fits in 256 bits. Otherwise, load
+// half of the result and insert it in the result with upd.{w,x}.
+struct UPDOpToStdLowering : public AIEVecOpToStdLowering<UPDOp> {
+  using AIEVecOpToStdLowering<UPDOp>::AIEVecOpToStdLowering;
+
+  LogicalResult
+  matchAndRewrite(UPDOp op, OpAdaptor adaptor,
+                  ConversionPatternRewriter &rewriter) const override {
+    Location loc = op.getLoc();
+    VectorType resultType = op.getResult().getType().cast<VectorType>();
+    int32_t vecSizeInBits = getVectorSizeInBits(resultType);
+    int32_t elementSizeInBits = getElementSizeInBits(resultType);
+
+    // The offset of the upd op is added to the innermost index
+    if (op.getOffset() % elementSizeInBits)
+      return failure();
+    SmallVector<Value, 4> indices(adaptor.getIndices().begin(),
+                                  adaptor.getIndices().end());
+    if (int32_t offset = op.getOffset() / elementSizeInBits) {
+      if (indices.empty())
+        return failure();
+      Value offsetVal = rewriter.create<arith::ConstantIndexOp>(loc, offset);
+      indices.back() =
+          rewriter.create<arith::AddIOp>(loc, indices.back(), offsetVal);
+    }
+
+    if (vecSizeInBits <= 256) {
+      rewriter.replaceOpWithNewOp<vector::LoadOp>(
+          op, resultType, adaptor.getSource(), indices);
+      return success();
+    }
+
+    unsigned lanes = getVectorLaneSize(resultType);
+    VectorType updType =
+        createVectorType(lanes / 2, resultType.getElementType());
+    Value half = rewriter.create<vector::LoadOp>(loc, updType,
+                                                 adaptor.getSource(), indices);
+    // The first upd op of a chain updates an undefined vector
+    Value vector = adaptor.getVector();
+    if (!vector)
+      vector = rewriter.create<arith::ConstantOp>(
+          loc, resultType, rewriter.getZeroAttr(resultType));
+
+    // The granularity of upd is 128/256/512 for 256/512/1024 bit values
+    StringRef name = vecSizeInBits == 512 ? "upd.w" : "upd.x";
+    Value index = createI32Constant(rewriter, loc, op.getIndex());
+    return replaceOpWithIntrinsicCall(rewriter, module, op, name, resultType,
+                                      {vector, index, half});
+  }
+};
+
+// Lower ups to {l}ups. For float types, ups is a no-op.
+struct UPSOpToStdLowering : public AIEVecOpToStdLowering<UPSOp> {
+  using AIEVecOpToStdLowering<UPSOp>::AIEVecOpToStdLowering;
+
+  LogicalResult
+  matchAndRewrite(UPSOp op, OpAdaptor adaptor,
+                  ConversionPatternRewriter &rewriter) const override {
+    VectorType accType = op.getResult().getType().cast<VectorType>();
+    Type eltType = accType.getElementType();
+    if (eltType.isa<FloatType>()) {
+      rewriter.replaceOp(op, adaptor.getSource());
+      return success();
+    }
+
+    std::string name = "ups";
+    if (getElementSizeInBits(accType) == 80)
+      name = "l" + name;
+    Value shift = createI32Constant(rewriter, op.getLoc(), op.getShift());
+    return replaceOpWithIntrinsicCall(rewriter, module, op, name, accType,
+                                      {adaptor.getSource(), shift});
+  }
+};
+
+// Lower srs to {l,b}srs. For float types, srs is a no-op.
+struct SRSOpToStdLowering : public AIEVecOpToStdLowering<SRSOp> {
+  using AIEVecOpToStdLowering<SRSOp>::AIEVecOpToStdLowering;
+
+  LogicalResult
+  matchAndRewrite(SRSOp op, OpAdaptor adaptor,
+                  ConversionPatternRewriter &rewriter) const override {
+    VectorType accType = op.getSource().getType().cast<VectorType>();
+    VectorType resultType = op.getResult().getType().cast<VectorType>();
+    if (accType.getElementType().isa<FloatType>()) {
+      rewriter.replaceOp(op, adaptor.getSource());
+      return success();
+    }
+
+    unsigned srcWidth = getElementSizeInBits(accType);
+    unsigned resultWidth = getElementSizeInBits(resultType);
+    std::string name = "srs";
+    if ((srcWidth == 80 && resultWidth == 64) ||
+        (srcWidth == 48 && resultWidth == 32))
+      name = "l" + name;
+    else if (srcWidth == 48 && resultWidth == 8)
+      name = "b" + name;
+    Value shift = createI32Constant(rewriter, op.getLoc(), op.getShift());
+    return replaceOpWithIntrinsicCall(rewriter, module, op, name, resultType,
+                                      {adaptor.getSource(), shift});
+  }
+};
+
+// Lower ext to ext.{v,w,x}
+struct ExtOpToStdLowering : public AIEVecOpToStdLowering<ExtOp> {
+  using AIEVecOpToStdLowering<ExtOp>::AIEVecOpToStdLowering;
+
+  LogicalResult
+  matchAndRewrite(ExtOp op, OpAdaptor adaptor,
+                  ConversionPatternRewriter &rewriter) const override {
+    VectorType resultType = op.getResult().getType().cast<VectorType>();
+    int32_t vecSizeInBits = getVectorSizeInBits(resultType);
+    if (vecSizeInBits != 128 && vecSizeInBits != 256 && vecSizeInBits != 512)
+      return failure();
+
+    StringRef name = vecSizeInBits == 128   ? "ext.v"
+                     : vecSizeInBits == 256 ? "ext.w"
+                                            : "ext.x";
+    Value index = createI32Constant(rewriter, op.getLoc(), op.getIndex());
+    return replaceOpWithIntrinsicCall(rewriter, module, op, name, resultType,
+                                      {adaptor.getSource(), index});
+  }
+};
+
+// Lower concat to concat
+struct ConcatOpToStdLowering : public AIEVecOpToStdLowering<ConcatOp> {
+  using AIEVecOpToStdLowering<ConcatOp>::AIEVecOpToStdLowering;
+
+  LogicalResult
+  matchAndRewrite(ConcatOp op, OpAdaptor adaptor,
+                  ConversionPatternRewriter &rewriter) const override {
+    return replaceOpWithIntrinsicCall(rewriter, module, op, "concat",
+                                      op.getResult().getType(),
+                                      adaptor.getSources());
+  }
+};
+
+// Lower select to select{32,16,8}
+struct SelectOpToStdLowering : public AIEVecOpToStdLowering<SelectOp> {
+  using AIEVecOpToStdLowering<SelectOp>::AIEVecOpToStdLowering;
+
+  LogicalResult
+  matchAndRewrite(SelectOp op, OpAdaptor adaptor,
+                  ConversionPatternRewriter &rewriter) const override {
+    Location loc = op.getLoc();
+    VectorType xbuffType = op.getXbuff().getType().cast<VectorType>();
+    int32_t elementSizeInBits = getElementSizeInBits(xbuffType);
+    if (elementSizeInBits != 16 && elementSizeInBits != 32 &&
+        elementSizeInBits != 64)
+      return failure();
+    StringRef name = elementSizeInBits == 16   ? "select32"
+                     : elementSizeInBits == 32 ? "select16"
+                                               : "select8";
+
+    SmallVector<Value, 12> args;
+    if (failed(appendLaneSelection(rewriter, loc, {op.getSelect()}, args)))
+      return failure();
+    args.push_back(adaptor.getXbuff());
+    if (failed(appendLaneSelection(rewriter, loc,
+                                   {op.getXstart(), op.getXoffsets(),
+                                    op.getXoffsetsHi(), op.getXsquare()},
+                                   args)))
+      return failure();
+    if (adaptor.getYbuff())
+      args.push_back(adaptor.getYbuff());
+    if (failed(appendLaneSelection(rewriter, loc,
+                                   {op.getYstart(), op.getYoffsets(),
+                                    op.getYoffsetsHi(), op.getYsquare()},
+                                   args)))
+      return failure();
+
+    return replaceOpWithIntrinsicCall(rewriter, module, op, name,
+                                      op.getResult().getType(), args);
+  }
+};
+
+// Lower pack to {u}pack
+struct PackOpToStdLowering : public AIEVecOpToStdLowering<PackOp> {
+  using AIEVecOpToStdLowering<PackOp>::AIEVecOpToStdLowering;
+
+  LogicalResult
+  matchAndRewrite(PackOp op, OpAdaptor adaptor,
+                  ConversionPatternRewriter &rewriter) const override {
+    VectorType sourceType = op.getSource().getType().cast<VectorType>();
+    StringRef name =
+        sourceType.getElementType().isUnsignedInteger() ? "upack" : "pack";
+    return replaceOpWithIntrinsicCall(rewriter, module, op, name,
+                                      op.getResult().getType(),
+                                      {adaptor.getSource()});
+  }
+};
+
+// Lower unpack to unpack
+struct UnpackOpToStdLowering : public AIEVecOpToStdLowering<UnpackOp> {
+  using AIEVecOpToStdLowering<UnpackOp>::AIEVecOpToStdLowering;
+
+  LogicalResult
+  matchAndRewrite(UnpackOp op, OpAdaptor adaptor,
+                  ConversionPatternRewriter &rewriter) const override {
+    return replaceOpWithIntrinsicCall(rewriter, module, op, "unpack",
+                                      op.getResult().getType(),
+                                      {adaptor.getSource()});
+  }
+};
+
+// Lower mul to {l}mul{lanes}, fpmul, or mul.elem.{lanes} for bf16
+struct MulOpToStdLowering : public AIEVecOpToStdLowering<MulOp> {
+  using AIEVecOpToStdLowering<MulOp>::AIEVecOpToStdLowering;
+
+  LogicalResult
+  matchAndRewrite(MulOp op, OpAdaptor adaptor,
+                  ConversionPatternRewriter &rewriter) const override {
+    SmallVector<Value, 12> args;
+    if (failed(appendFMAOrMulOperand(rewriter, op, adaptor.getLhs(), 0,
+                                     args)) ||
+        failed(appendFMAOrMulOperand(rewriter, op, adaptor.getRhs(), 1, args)))
+      return failure();
+
+    return replaceOpWithIntrinsicCall(rewriter, module, op,
+                                      getFMAOrMulIntrinsicName(op, "mul"),
+                                      op.getResult().getType(), args);
+  }
+};
+
+// Lower fma to {l}{mac,msc}{lanes}, fp{mac,msc}, or {mac,msc}.elem.{lanes}
+// for bf16. The accumulator is the first argument, except for the elementwise
+// bf16 intrinsics that take it last.
+struct FMAOpToStdLowering : public AIEVecOpToStdLowering<FMAOp> {
+  using AIEVecOpToStdLowering<FMAOp>::AIEVecOpToStdLowering;
+
+  LogicalResult
+  matchAndRewrite(FMAOp op, OpAdaptor adaptor,
+                  ConversionPatternRewriter &rewriter) const override {
+    bool bf16Scheme =
+        op.getLhs().getType().cast<VectorType>().getElementType().isBF16();
+
+    SmallVector<Value, 12> args;
+    if (!bf16Scheme)
+      args.push_back(adaptor.getAcc());
+    if (failed(appendFMAOrMulOperand(rewriter, op, adaptor.getLhs(), 0,
+                                     args)) ||
+        failed(appendFMAOrMulOperand(rewriter, op, adaptor.getRhs(), 1, args)))
+      return failure();
+    if (bf16Scheme)
+      args.push_back(adaptor.getAcc());
+
+    StringRef base = op.getFmsub() ? "msc" : "mac";
+    return replaceOpWithIntrinsicCall(rewriter, module, op,
+                                      getFMAOrMulIntrinsicName(op, base),
+                                      op.getResult().getType(), args);
+  }
+};
+
+// Lower add/sub. The simple integer scheme is a lane-wise arith op, the
+// simple float scheme is fp{add,sub}, and the complex schemes are
+// {add,sub}{lanes} (or fp{add,sub} for floats) with lane selection.
+template <typename SourceOp, typename ArithOp>
+struct AddOrSubOpToStdLowering : public AIEVecOpToStdLowering<SourceOp> {
+  using AIEVecOpToStdLowering<SourceOp>::AIEVecOpToStdLowering;
+  using OpAdaptor = typename SourceOp::Adaptor;
+
+  StringRef getBaseName() const {
+    return std::is_same<SourceOp, AddOp>::value ? "add" : "sub";
+  }
+
+  LogicalResult
+  matchAndRewrite(SourceOp op, OpAdaptor adaptor,
+                  ConversionPatternRewriter &rewriter) const override {
+    VectorType resultType =
+        op.getResult().getType().template cast<VectorType>();
+    bool floatType = resultType.getElementType().template isa<FloatType>();
+    bool simpleScheme = op.getStart(0).empty();
+
+    if (simpleScheme && !floatType) {
+      rewriter.replaceOpWithNewOp<ArithOp>(op, adaptor.getLhs(),
+                                           adaptor.getRhs());
+      return success();
+    }
+
+    SmallVector<Value, 10> args;
+    if (simpleScheme) {
+      args.push_back(adaptor.getLhs());
+      args.push_back(adaptor.getRhs());
+    } else if (failed(appendAddOrSubOperand(rewriter, op, adaptor.getLhs(), 0,
+                                            args)) ||
+               failed(appendAddOrSubOperand(rewriter, op, adaptor.getRhs(), 1,
+                                            args)))
+      return failure();
+
+    std::string name = floatType ? "fp" + getBaseName().str()
+                                 : getBaseName().str() +
+                                       std::to_string(
+                                           getVectorLaneSize(resultType));
+    return replaceOpWithIntrinsicCall(rewriter, this->module, op, name,
+                                      resultType, args);
+  }
+};
+
+namespace {
+struct AIEVecToStandard : public AIEVecToStandardBase<AIEVecToStandard> {
+  AIEVecToStandard() = default;
+  void runOnOperation() override;
+};
+
+/// Lower the AIE vector ops of the module to calls of the llvm.aie.*
+/// intrinsics. The declarations of the intrinsics are created on demand.
+void AIEVecToStandard::runOnOperation() {
+  ModuleOp m = getOperation();
+
+  ConversionTarget target(getContext());
+  target.addIllegalDialect<AIEVecDialect>();
+  target.addLegalDialect<func::FuncDialect>();
+  target.addLegalDialect<memref::MemRefDialect>();
+  target.addLegalDialect<vector::VectorDialect>();
+  target.addLegalDialect<arith::ArithmeticDialect>();
+  target.markUnknownOpDynamicallyLegal([](Operation *) { return true; });
+
+  RewritePatternSet patterns(&getContext());
+  patterns.add<UPDOpToStdLowering, UPSOpToStdLowering, SRSOpToStdLowering,
+               ExtOpToStdLowering, ConcatOpToStdLowering,
+               SelectOpToStdLowering, PackOpToStdLowering,
+               UnpackOpToStdLowering, MulOpToStdLowering, FMAOpToStdLowering,
+               AddOrSubOpToStdLowering<AddOp, arith::AddIOp>,
+               AddOrSubOpToStdLowering<SubOp, arith::SubIOp>>(m.getContext(),
+                                                              m);
+
+  if (failed(applyPartialConversion(m, target, std::move(patterns))))
+    signalPassFailure();
+}
+} // namespace
+
+std::unique_ptr<Pass> xilinx::aievec::createAIEVecToStandardPass() {
+  return std::make_unique<AIEVecToStandard>();
+}
@@ -23,10 +23,15 @@
 #include "mlir/Dialect/MemRef/IR/MemRef.h"
 #include "mlir/Dialect/SCF/IR/SCF.h"
 #include "mlir/Dialect/Vector/Transforms/VectorTransforms.h"
+#include "mlir/IR/BlockAndValueMapping.h"
 #include "mlir/IR/TypeUtilities.h"
 #include "mlir/Pass/PassManager.h"
 #include "mlir/Transforms/Passes.h"
+#include "llvm/ADT/SetVector.h"
 #include "llvm/ADT/SmallSet.h"
+#include "llvm/ADT/StringExtras.h"
+#include "llvm/Support/FormatVariadic.h"
+#include "llvm/Support/JSON.h"
 
 using namespace mlir;
 using namespace arith;
@@ -41,6 +46,29 @@ static llvm::cl::opt<bool>
                         llvm::cl::init(true));
 
 namespace {
+// Structure to capture the predicted cost of mapping a chain of mul/fma ops
+// to a vectorization scheme, where 'depth' consecutive ops of the chain are
+// fused into the columns of one AIE mul/fma intrinsic.
+struct SchemeCost {
+  // lanes and columns in the vector intrinsic, and the number of columns that
+  // the fused chain occupies
+  int32_t lanes, cols, depth;
+  // number of AIE mul/fma intrinsics issued for the chain
+  int32_t intrinsics;
+  // number of 256-bit loads (UPD) issued per iteration of the vectorized loop
+  // to fill the vectors read by the chain
+  int32_t loads;
+  // number of 256-bit vector registers holding the operand lanes read by one
+  // fused intrinsic, which grows with the number of fused columns
+  int32_t regs;
+  // predicted number of cycles to issue the chain
+  int32_t cycles;
+  // Constructors
+  SchemeCost()
+      : lanes(0), cols(0), depth(0), intrinsics(0), loads(0), regs(0),
+        cycles(0) {}
+};
+
 // A struct to pack the global state required for vectorization at one place.
 // Local to this translation unit.
 struct VectState {
@@ -95,12 +123,20 @@ struct VectState {
   // i8xi8 scheme. An example of filter for i8xi8 scheme is {0,0,1,1,2,2,3,3},
   // with dupFactor=2.
   int32_t dupFactor;
+  // For the representative op of each fused mul/fma chain, the scheme picked
+  // by the cost model, and its predicted cost.
+  DenseMap<Operation *, SchemeCost> opToSchemeCost;
+  // If set, attach the chosen scheme and its predicted cost to each generated
+  // AIE mul/fma op.
+  bool annotateCost;
 
   // Constructors
   VectState(MLIRContext *context)
-      : builder(context), shift(0), zeroOffset(0), dupFactor(2) {}
-  VectState(MLIRContext *context, int8_t s, int32_t z, int32_t d)
-      : builder(context), shift(s), zeroOffset(z), dupFactor(d) {}
+      : builder(context), shift(0), zeroOffset(0), dupFactor(2),
+        annotateCost(false) {}
+  VectState(MLIRContext *context, int8_t s, int32_t z, int32_t d, bool a)
+      : builder(context), shift(s), zeroOffset(z), dupFactor(d),
+        annotateCost(a) {}
 
   IntervalReuse *getIntervalForOperation(Operation *op);
 };
@@ -179,11 +215,26 @@ static inline AIEVecAttributes getResultVecStats(Operation *op,
   return getVectorStats(vtype);
 }
 
+// Return the idx'th operand of op. The mixed-precision schemes (e.g., i16xi8,
+// i32xi16, bf16 with f32 accumulation) reach the vectorizer as a mul/fma op
+// whose narrower operand is widened by an extension op. The AIE mul/fma
+// intrinsics consume the narrow operand directly, so for the multiplicands of
+// a mul/fma op, look through the extension.
+static inline Value getMulOrFMAOperand(Operation *op, unsigned idx) {
+  Value operand = op->getOperand(idx);
+  if (idx > 1 || !isa<MulIOp, MulFOp, vector::FMAOp>(op))
+    return operand;
+  Operation *defOp = operand.getDefiningOp();
+  if (defOp && isa<ExtSIOp, ExtUIOp, ExtFOp>(defOp))
+    return defOp->getOperand(0);
+  return operand;
+}
+
 // Get the vector stats for an operation's operand.
 static inline AIEVecAttributes
 getOperandVecStats(Operation *op, VectState *state, unsigned idx = 0) {
   assert(op->getNumOperands() > idx);
-  Operation *defOp = op->getOperand(idx).getDefiningOp();
+  Operation *defOp = getMulOrFMAOperand(op, idx).getDefiningOp();
   VectorType vtype = defOp->getResult(0).getType().cast<VectorType>();
   auto ret = getVectorStats(vtype);
   // if the defining op is a transfer read, get the extent read from source
@@ -202,8 +253,8 @@ getOperandVecStats(Operation *op, VectState *state, unsigned idx = 0) {
 static inline std::pair<int32_t, int32_t> getNumRowsAndCols(Operation *op) {
   assert(op->getNumOperands() >= 2 && op->getNumResults() == 1);
 
-  Operation *left = op->getOperand(0).getDefiningOp();
-  Operation *right = op->getOperand(1).getDefiningOp();
+  Operation *left = getMulOrFMAOperand(op, 0).getDefiningOp();
+  Operation *right = getMulOrFMAOperand(op, 1).getDefiningOp();
 
   // Get the number of lanes
   VectorType vtype = op->getResult(0).getType().cast<VectorType>();
@@ -215,6 +266,10 @@ static inline std::pair<int32_t, int32_t> getNumRowsAndCols(Operation *op) {
   int32_t lsize = getElementSizeInBits(ltype);
   int32_t rsize = getElementSizeInBits(rtype);
 
+  // The bf16 scheme is a lane-wise multiplication without column topology
+  if (ltype.getElementType().isBF16() && rtype.getElementType().isBF16())
+    return std::make_pair(lanes, 1);
+
   int32_t width = (lsize == 8 && rsize == 8)    ? 128
                   : (lsize == 16 && rsize == 8) ? 64
                                                 : 32;
@@ -245,8 +300,8 @@ static inline void fuseAccessExtent(Operation *Op1, Operation *Op2,
 
   // Iterate over the even and odd operands for both the operations
   for (int idx = 0; idx < 2; ++idx) {
-    Operation *op1 = Op1->getOperand(idx).getDefiningOp();
-    Operation *op2 = Op2->getOperand(idx).getDefiningOp();
+    Operation *op1 = getMulOrFMAOperand(Op1, idx).getDefiningOp();
+    Operation *op2 = getMulOrFMAOperand(Op2, idx).getDefiningOp();
     // If both op1 and op2 are transfer read ops, then we need to create an
     // interval that subsumes the extent read by both op1 an op2.
     if (isa<TransferReadOp>(op1) && isa<TransferReadOp>(op2)) {
@@ -272,6 +327,8 @@ static inline void fuseAccessExtent(Operation *Op1, Operation *Op2,
 // (1) both lhs and rhs operands come from vector of same size,
 // (2) no operand is splat, and
 // (3) no type is float if Op is mul/fma.
+// The exception is the bf16 scheme, which only has a lane-wise form: its bf16
+// operands must have the same number of lanes as the f32 result.
 static bool isSimpleVectIntrinsic(Operation *Op, VectState *state) {
   // The incoming operator should be mul/fma/sub/add op
   bool isMulOrFMAOp = isa<MulIOp, MulFOp, vector::FMAOp>(Op);
@@ -293,6 +350,9 @@ static bool isSimpleVectIntrinsic(Operation *Op, VectState *state) {
                  !lstat.elementType.isa<FloatType>() &&
                  !rstat.elementType.isa<FloatType>();
 
+  if (isMulOrFMAOp && lstat.elementType.isBF16() && rstat.elementType.isBF16())
+    return noSplat && lstat.lanes == vstat.lanes && rstat.lanes == vstat.lanes;
+
   return sizeMatches && noSplat && (isSubOrAddOp || noFloat);
 }
 
@@ -332,10 +392,11 @@ static bool isWellFormedVectorOp(Operation *Op) {
 }
 
 // Given an AIEOp, determines if an operation writes to an accumulator
-// based on operation type and operand types
+// based on operation type and operand types. A null op (i.e., the value is a
+// block argument) does not write to an accumulator.
 static bool writesToAccumulator(Operation *op) {
   // Integer muls and FMAs write to accumulator
-  if (!isAIEOp(op)) {
+  if (!op || !isAIEOp(op)) {
     return false;
   } else if (auto mulOp = dyn_cast<aievec::MulOp>(op)) {
     return mulOp.getResult()
@@ -698,7 +759,8 @@ static Operation *generateFMAOp(vector::FMAOp fmaOp, AIEOpAttributes &opAttr,
   }
   // If the lhs operand vector is not >= twice the rhs operand vector, then use
   // concat operator.
-  Value lhs = fmaOp.getLhs();
+  Value lhs = getMulOrFMAOperand(fmaOp, 0);
+  Value rhs = getMulOrFMAOperand(fmaOp, 1);
   if (!isSimpleVectIntrinsic(fmaOp, state)) {
     AIEVecAttributes lstat = getOperandVecStats(fmaOp, state, 0);
     assert(lstat.vecSizeInBits % 256 == 0);
@@ -715,10 +777,10 @@ static Operation *generateFMAOp(vector::FMAOp fmaOp, AIEOpAttributes &opAttr,
 
   // Create AIE dialect fma/msc op
   Operation *xfmaOp = state->builder.create<aievec::FMAOp>(
-      fmaOp->getLoc(), lhs, fmaOp.getRhs(), acc, opAttr.start[0],
-      opAttr.offset[0], opAttr.offset_hi[0], opAttr.step[0], opAttr.square[0],
-      opAttr.start[1], opAttr.offset[1], opAttr.offset_hi[1], opAttr.step[1],
-      opAttr.square[1], isSub);
+      fmaOp->getLoc(), lhs, rhs, acc, opAttr.start[0], opAttr.offset[0],
+      opAttr.offset_hi[0], opAttr.step[0], opAttr.square[0], opAttr.start[1],
+      opAttr.offset[1], opAttr.offset_hi[1], opAttr.step[1], opAttr.square[1],
+      isSub);
 
   assert(xfmaOp && "could not create fma op");
   return xfmaOp;
@@ -739,7 +801,8 @@ static Operation *generateMulOp(T mulOp, AIEOpAttributes &opAttr,
 
   // If the lhs operand vector is not >= twice the rhs operand vector, then use
   // concat operator.
-  Value lhs = mulOp.getLhs();
+  Value lhs = getMulOrFMAOperand(mulOp, 0);
+  Value rhs = getMulOrFMAOperand(mulOp, 1);
   if (!isSimpleVectIntrinsic(mulOp, state)) {
     AIEVecAttributes lstat = getOperandVecStats(mulOp, state, 0);
     assert(lstat.vecSizeInBits % 256 == 0);
@@ -753,10 +816,9 @@ static Operation *generateMulOp(T mulOp, AIEOpAttributes &opAttr,
 
   // Create AIE dialect mul op
   Operation *xmulOp = state->builder.create<aievec::MulOp>(
-      mulOp->getLoc(), lhs, mulOp.getRhs(), opType, opAttr.start[0],
-      opAttr.offset[0], opAttr.offset_hi[0], opAttr.step[0], opAttr.square[0],
-      opAttr.start[1], opAttr.offset[1], opAttr.offset_hi[1], opAttr.step[1],
-      opAttr.square[1]);
+      mulOp->getLoc(), lhs, rhs, opType, opAttr.start[0], opAttr.offset[0],
+      opAttr.offset_hi[0], opAttr.step[0], opAttr.square[0], opAttr.start[1],
+      opAttr.offset[1], opAttr.offset_hi[1], opAttr.step[1], opAttr.square[1]);
 
   assert(xmulOp && "could not create mul op");
   return xmulOp;
@@ -1096,22 +1158,28 @@ static bool canFuseMulAndAddOrSubIntoFMAOp(Operation *Op) {
 // the same size. If the incoming operation involves multiplication,
 // reassociate the operands involved in multiplication so that the left operand
 // comes from bigger vector. The exception to this rule is the 8x8 scheme,
-// where the right operand must be the bigger vector.
+// where the right operand must be the bigger vector. For the mixed-precision
+// schemes (16x8 and 32x16), the left operand is the one with wider elements.
 static void reassociateMulOpBasedOnVecSize(Operation *Op, VectState *state) {
   // Get the stats for left and right operand vectors
   AIEVecAttributes lstat = getOperandVecStats(Op, state, 0);
   AIEVecAttributes rstat = getOperandVecStats(Op, state, 1);
 
+  // In the mixed-precision schemes, the operand with the wider element type
+  // is the xbuff, irrespective of the vector sizes.
+  bool isMixed = lstat.elementSizeInBits != rstat.elementSizeInBits;
+
   // No need to do anything if both vectors are the same size
-  if (lstat.vecSizeInBits == rstat.vecSizeInBits)
+  if (!isMixed && lstat.vecSizeInBits == rstat.vecSizeInBits)
     return;
 
   // Check if this is an 8x8 scheme
   bool is8x8 = lstat.elementSizeInBits == 8 && rstat.elementSizeInBits == 8;
 
   // Flip the operands if necessary
-  bool flip = is8x8 ? lstat.vecSizeInBits > rstat.vecSizeInBits
-                    : rstat.vecSizeInBits > lstat.vecSizeInBits;
+  bool flip = isMixed ? rstat.elementSizeInBits > lstat.elementSizeInBits
+              : is8x8 ? lstat.vecSizeInBits > rstat.vecSizeInBits
+                      : rstat.vecSizeInBits > lstat.vecSizeInBits;
   if (flip) {
     LLVM_DEBUG(llvm::dbgs()
                << "\n\nReassociating op " << *Op
@@ -1187,6 +1255,118 @@ static void fuseMulAndAddOrSubIntoFMAOp(Operation *Op, VectState *state) {
     mulOp->erase();
 }
 
+// Predict the cost of issuing the chain {refOp, chain} of vector dialect
+// mul/fma ops, with 'depth' consecutive ops of the chain fused into the
+// columns of one AIE mul/fma intrinsic. The model follows the VLIW slots of
+// the AIE core: one vector mul/mac issues each cycle, and two 256-bit loads
+// can issue in parallel with it. Splat operands are loop invariant, and are
+// not reloaded in each iteration of the vectorized loop. The register pressure
+// is the number of registers spanned by the lanes that one fused intrinsic
+// reads from each operand: every fused column shifts the window of an operand
+// by the column offset of the chain. Return a cost with 0 cycles if the column
+// offsets of the chain cannot be encoded at this depth.
+static SchemeCost computeSchemeCost(Operation *refOp,
+                                    ArrayRef<Operation *> chain, int32_t depth,
+                                    VectState *state) {
+  SchemeCost cost;
+  std::tie(cost.lanes, cost.cols) = getNumRowsAndCols(refOp);
+  // A simple lane-wise intrinsic has no column topology
+  if (isSimpleVectIntrinsic(refOp, state))
+    cost.cols = 1;
+  cost.depth = depth;
+
+  // The i8xi8 scheme generates two AIE mul/fma ops for each vector op
+  int32_t xbits = getElementSizeInBits(
+      getMulOrFMAOperand(refOp, 0).getType().cast<VectorType>());
+  int32_t zbits = getElementSizeInBits(
+      getMulOrFMAOperand(refOp, 1).getType().cast<VectorType>());
+  int32_t numOps = chain.size() + 1;
+  cost.intrinsics = llvm::divideCeil(numOps, depth);
+  if (xbits == 8 && zbits == 8)
+    cost.intrinsics *= 2;
+
+  // The access distance between the operands of consecutive ops in the chain
+  auto startOf = [&](Operation *op, unsigned idx) {
+    return computeStartInAIEVec(getMulOrFMAOperand(op, idx).getDefiningOp(),
+                                state);
+  };
+  int32_t colOffsets[2] = {0, 0};
+  if (depth > 1)
+    for (unsigned idx = 0; idx < 2; ++idx)
+      colOffsets[idx] = startOf(chain[0], idx) - startOf(refOp, idx);
+
+  // The columns of the 32x16 scheme read consecutive xbuff lanes
+  if (depth > 1 && xbits == 32 && zbits == 16 && colOffsets[0] > 1)
+    return cost;
+
+  for (unsigned idx = 0; idx < 2; ++idx) {
+    AIEVecAttributes stat = getOperandVecStats(refOp, state, idx);
+    int32_t window = startOf(refOp, idx) + (depth - 1) * colOffsets[idx] +
+                     (stat.isSplat ? 1 : cost.lanes);
+    cost.regs += llvm::divideCeil(window * stat.elementSizeInBits, 256);
+  }
+
+  // Each vector that the chain reads is loaded once, whatever the fusion
+  // depth, since the fused ops read their operands from the same vectors.
+  llvm::SmallSet<std::pair<IntervalReuse *, int32_t>, 4> intervals;
+  SmallVector<Operation *, 8> ops(1, refOp);
+  ops.append(chain.begin(), chain.end());
+  for (auto op : ops) {
+    for (unsigned idx = 0; idx < 2; ++idx) {
+      Operation *defOp = getMulOrFMAOperand(op, idx).getDefiningOp();
+      AIEVecAttributes stat = getOperandVecStats(op, state, idx);
+      // The reads from the same interval are loaded into one vector
+      if (!stat.loadFromMemory || stat.isSplat)
+        continue;
+      IntervalReuse *iv = state->getIntervalForOperation(defOp);
+      auto interval = iv->getInterval(defOp);
+      if (intervals.insert(std::make_pair(iv, interval.first)).second)
+        cost.loads += llvm::divideCeil(stat.vecSizeInBits, 256);
+    }
+  }
+  cost.cycles =
+      std::max(cost.intrinsics, (int32_t)llvm::divideCeil(cost.loads, 2));
+  return cost;
+}
+
+// Enumerate the fusion depths of the chain {refOp, chain} of mul/fma ops, and
+// return the cheapest configuration. Fusing any prefix of the chain is a
+// candidate, except the depths whose column offsets the scheme cannot encode.
+// Among the configurations with the same predicted cycles, prefer the one that
+// issues fewer intrinsics, and then the one with the lower register pressure.
+static SchemeCost chooseSchemeForChain(Operation *refOp,
+                                       ArrayRef<Operation *> chain,
+                                       VectState *state) {
+  SchemeCost best;
+  for (int32_t depth = 1; depth <= (int32_t)chain.size() + 1; ++depth) {
+    SchemeCost cost = computeSchemeCost(refOp, chain, depth, state);
+    LLVM_DEBUG(llvm::dbgs()
+               << "\n\tscheme " << cost.lanes << "x" << cost.depth << ": "
+               << cost.intrinsics << " intrinsics, " << cost.loads
+               << " loads, " << cost.regs << " registers, " << cost.cycles
+               << " cycles");
+    if (cost.cycles == 0)
+      continue;
+    if (best.depth == 0 || cost.cycles < best.cycles ||
+        (cost.cycles == best.cycles &&
+         (cost.intrinsics < best.intrinsics ||
+          (cost.intrinsics == best.intrinsics && cost.regs < best.regs))))
+      best = cost;
+  }
+  return best;
+}
+
+// Attach the scheme chosen by the cost model, and its predicted cycles, to the
+// AIE dialect mul/fma op. The scheme is printed as lanes x the number of
+// columns occupied by the fused ops.
+static void annotateSchemeCost(Operation *op, SchemeCost &cost,
+                               VectState *state) {
+  std::string scheme =
+      std::to_string(cost.lanes) + "x" + std::to_string(cost.depth);
+  op->setAttr("aievec.scheme", state->builder.getStringAttr(scheme));
+  op->setAttr("aievec.cycles", state->builder.getI32IntegerAttr(cost.cycles));
+}
+
 // Given the operation attributes (start, offset, step, square, etc.), generate
 // an AIE mul/fma op for the incoming vector mul/fma Op. 'nextStart' is used
 // for schemes that require two AIE dialect fma ops to be generated for one
@@ -1198,6 +1378,14 @@ static void generateMulOrFMAOp(Operation *Op, AIEOpAttributes &opAttr,
   assert(opAttr.start.size() == opAttr.offset.size() &&
          opAttr.start.size() == 2);
 
+  // Get the scheme picked by the cost model for this op. An op that was not
+  // fused with other ops occupies a single column of the intrinsic.
+  SchemeCost cost;
+  if (state->annotateCost)
+    cost = state->opToSchemeCost.count(Op)
+               ? state->opToSchemeCost[Op]
+               : computeSchemeCost(Op, {}, 1, state);
+
   // Set insertion point of the AIE dialect mul/fma op
   state->builder.setInsertionPointAfter(Op);
 
@@ -1225,6 +1413,8 @@ static void generateMulOrFMAOp(Operation *Op, AIEOpAttributes &opAttr,
   };
 
   Operation *repOp = genOp(Op, opAttr, state);
+  if (state->annotateCost)
+    annotateSchemeCost(repOp, cost, state);
   LLVM_DEBUG(llvm::dbgs() << "\n\nGenerated AIE dialect mul/fma op " << *repOp);
 
   // i8xi8 scheme generates two AIE dialect mul/fma ops for each vector dialect
@@ -1232,6 +1422,8 @@ static void generateMulOrFMAOp(Operation *Op, AIEOpAttributes &opAttr,
   if (!nextStart.empty()) {
     opAttr.start[1] = nextStart;
     Operation *pairedOp = genOp(Op, opAttr, state, true);
+    if (state->annotateCost)
+      annotateSchemeCost(pairedOp, cost, state);
     LLVM_DEBUG(llvm::dbgs() << "\n\nGenerated the paired AIE dialect "
                             << "mul/fma op for 8x8 scheme " << *repOp);
     // Link the two mul/fma ops
@@ -1468,12 +1660,88 @@ static void computeZbuffAttr_i8xi8(
   opAttr.step.push_back(stepStr);
 }
 
+// Compute the start, lo/hi offset, and step for zbuff for 16x8 scheme. The
+// 8-bit coefficients are permuted per lane like in the 16x16 scheme, but the
+// 256-bit zbuff holds 32 of them.
+static void computeZbuffAttr_i16xi8(
+    unsigned vecSize,   // #lanes
+    int32_t start,      // computed start in AIE vec
+    int32_t accIncr,    // access change with each loop increment
+    int32_t zeroOffset, // offset of 0 value in the filter
+    int32_t colOffset,  // zbuff access distance between vector cols
+    AIEOpAttributes &opAttr) {
+  std::string startStr, offsetStr, offsetHiStr, stepStr;
+  // zstart must be 5b value.
+  assert(start < 32 && "zstart must be 5b value");
+  startStr = std::to_string(start);
+
+  // If zbuff comes from splat, use default offsets
+  if (accIncr == 0)
+    offsetStr = offsetHiStr = "0";
+  else {
+    // Compute hi and lo offsets to something resembling "0x76543210" and
+    // "0xFEDCBA98" respectively.
+    offsetStr = "0x";
+    for (int i = vecSize / 2 - 1; i >= 0; --i)
+      offsetStr.push_back(getHexValue(i * accIncr));
+    offsetHiStr = "0x";
+    for (int i = vecSize - 1, e = vecSize / 2; i >= e; --i)
+      offsetHiStr.push_back(getHexValue(i * accIncr));
+  }
+
+  // Compute step between columns. Without fused columns, the step must land
+  // on the zeroes that pad the filter.
+  int32_t step = colOffset == -1 ? zeroOffset - 1 - start : colOffset;
+  assert(step >= 0 && "zstep cannot be negative");
+  stepStr = std::to_string(step);
+
+  // And now we have everything to push into opAttr
+  opAttr.start.push_back(startStr);
+  opAttr.offset.push_back(offsetStr);
+  opAttr.offset_hi.push_back(offsetHiStr);
+  opAttr.square.push_back("");
+  opAttr.step.push_back(stepStr);
+}
+
+// Compute the start, offset, and step for zbuff for 32x16 scheme. The 16-bit
+// coefficients only have one offset per lane since the scheme has 8 lanes.
+static void computeZbuffAttr_i32xi16(
+    unsigned vecSize,   // #lanes
+    int32_t start,      // computed start in AIE vec
+    int32_t accIncr,    // access change with each loop increment
+    int32_t zeroOffset, // offset of 0 value in the filter
+    int32_t colOffset,  // zbuff access distance between vector cols
+    AIEOpAttributes &opAttr) {
+  // zstart must be 4b value.
+  assert(start < 16 && "zstart must be 4b value");
+  std::string startStr = std::to_string(start);
+
+  // Compute the offset resembling "0x76543210", or use the default offset if
+  // zbuff comes from splat.
+  std::string offsetStr = accIncr == 0 ? "0" : "0x";
+  if (accIncr != 0)
+    for (int i = vecSize - 1; i >= 0; --i)
+      offsetStr.push_back(getHexValue(i * accIncr));
+
+  // Compute step between columns
+  int32_t step = colOffset == -1 ? zeroOffset - 1 - start : colOffset;
+  assert(step >= 0 && "zstep cannot be negative");
+  std::string stepStr = std::to_string(step);
+
+  // And now we have everything to push into opAttr
+  opAttr.start.push_back(startStr);
+  opAttr.offset.push_back(offsetStr);
+  opAttr.offset_hi.push_back("");
+  opAttr.square.push_back("");
+  opAttr.step.push_back(stepStr);
+}
+
 // Find a length-k chain of FMA ops such that (1) the chain is linear; (2) the
-// operand datawidth is 16 or 8 bits; (3) the access distance between lhs (rhs)
-// operands of both FMAs is compile-time constant. These FMAs will be fused
-// into a single FMA. Technically, k is equal to the number of columns in the
-// FMA topology. If fused, cache the pair indicating the access difference
-// between the operands for the two FMAs.
+// operand datawidth is 16 or 8 bits, or 32x16 bits; (3) the access distance
+// between lhs (rhs) operands of both FMAs is compile-time constant. These FMAs
+// will be fused into a single FMA. Technically, k is equal to the number of
+// columns in the FMA topology. If fused, cache the pair indicating the access
+// difference between the operands for the two FMAs.
 static void fuseFMAOps(Operation *refOp,
                        llvm::SmallSet<Operation *, 8> &fusedOpSet, int32_t cols,
                        VectState *state) {
@@ -1485,8 +1753,8 @@ static void fuseFMAOps(Operation *refOp,
 
   // Get the start offsets for left and right operands of the reference
   // operator, i.e., start of the fusion chain.
-  Operation *lOp = refOp->getOperand(0).getDefiningOp();
-  Operation *rOp = refOp->getOperand(1).getDefiningOp();
+  Operation *lOp = getMulOrFMAOperand(refOp, 0).getDefiningOp();
+  Operation *rOp = getMulOrFMAOperand(refOp, 1).getDefiningOp();
   int32_t lstart = computeStartInAIEVec(lOp, state);
   int32_t rstart = computeStartInAIEVec(rOp, state);
 
@@ -1535,8 +1803,8 @@ static void fuseFMAOps(Operation *refOp,
           cstat.isSplat != ustat.isSplat)
         break;
       // Check 2. The accesses must come from the same vector/upd op
-      Operation *cdefOp = curOp->getOperand(idx).getDefiningOp();
-      Operation *udefOp = usrOp->getOperand(idx).getDefiningOp();
+      Operation *cdefOp = getMulOrFMAOperand(curOp, idx).getDefiningOp();
+      Operation *udefOp = getMulOrFMAOperand(usrOp, idx).getDefiningOp();
       bool related = cdefOp == udefOp;
       if (!related && cstat.loadFromMemory && ustat.loadFromMemory) {
         IntervalReuse *civ = state->getIntervalForOperation(cdefOp);
@@ -1586,6 +1854,14 @@ static void fuseFMAOps(Operation *refOp,
     curOp = usrOp;
   }
 
+  // Let the cost model pick how many ops of the fusable chain are fused into
+  // the columns of refOp, and cache the cost of the chosen configuration.
+  LLVM_DEBUG(llvm::dbgs() << "\n\nCost of fusing fma ops with op " << *refOp);
+  int32_t depth = chooseSchemeForChain(refOp, fusedOps, state).depth;
+  fusedOps.resize(depth - 1);
+  state->opToSchemeCost[refOp] =
+      computeSchemeCost(refOp, fusedOps, depth, state);
+
   // If there are no ops fused, return
   if (fusedOps.empty())
     return;
@@ -1639,6 +1915,22 @@ static void computeXbuffAttributes(
     if (colOffset == -1)
       colOffset = dupFactor;
     computeXbuffAttr_i8xi8(scheme.lanes, start, colOffset, opAttr);
+  }
+  // Case 4: 16x8 real. The 16-bit xbuff is permuted as in the 16x16 scheme.
+  else if (scheme.lanes == 16 && scheme.cols == 4 && scheme.xbits == 16 &&
+           scheme.zbits == 8) {
+    // We only support a loop increment of <= 1
+    assert((accIncr <= 1 || accIncr % 2 == 0) &&
+           "loop step size value not supported");
+    computeXbuffAttr_i16xi16(scheme.lanes, start, accIncr, colOffset, opAttr);
+  }
+  // Case 5: 32x16 real. The 32-bit xbuff is permuted as in the 32x32 scheme,
+  // and the columns read consecutive xbuff lanes.
+  else if (scheme.lanes == 8 && scheme.cols == 2 && scheme.xbits == 32 &&
+           scheme.zbits == 16) {
+    assert(colOffset <= 1 &&
+           "xbuff column offset greater than 1 not supported");
+    computeBuffAttr_i32xi32(scheme.lanes, start, accIncr, opAttr);
   } else
     llvm_unreachable("Unsupported vectorization scheme");
 }
@@ -1676,6 +1968,26 @@ static void computeZbuffAttributes(
     assert(accIncr <= 1 && "loop step size greater than 1 not supported");
     computeZbuffAttr_i8xi8(scheme.lanes, start, accIncr, colOffset, opAttr,
                            nextStart);
+  }
+  // Case 4: 16x8 real
+  else if (scheme.lanes == 16 && scheme.cols == 4 && scheme.xbits == 16 &&
+           scheme.zbits == 8) {
+    // We only support a loop increment of <= 1
+    assert(accIncr <= 1 && "loop step size greater than 1 not supported");
+    zeroOffset = zeroOffset == 0 ? scheme.lanes
+                                 : start + zeroOffset - (start % zeroOffset);
+    computeZbuffAttr_i16xi8(scheme.lanes, start, accIncr, zeroOffset,
+                            colOffset, opAttr);
+  }
+  // Case 5: 32x16 real
+  else if (scheme.lanes == 8 && scheme.cols == 2 && scheme.xbits == 32 &&
+           scheme.zbits == 16) {
+    // We only support a loop increment of <= 1
+    assert(accIncr <= 1 && "loop step size greater than 1 not supported");
+    zeroOffset = zeroOffset == 0 ? scheme.lanes
+                                 : start + zeroOffset - (start % zeroOffset);
+    computeZbuffAttr_i32xi16(scheme.lanes, start, accIncr, zeroOffset,
+                             colOffset, opAttr);
   } else
     llvm_unreachable("Unsupported vectorization scheme");
 }
@@ -1707,10 +2019,10 @@ static void generateSchemeBasedMulOrFMAOp(Operation *Op, VectState *state) {
   int32_t lanes, cols;
   std::tie(lanes, cols) = getNumRowsAndCols(Op);
   // Get the data sizes for left and right operands of mul/fma
-  int32_t xbits =
-      getElementSizeInBits(Op->getOperand(0).getType().cast<VectorType>());
-  int32_t zbits =
-      getElementSizeInBits(Op->getOperand(1).getType().cast<VectorType>());
+  int32_t xbits = getElementSizeInBits(
+      getMulOrFMAOperand(Op, 0).getType().cast<VectorType>());
+  int32_t zbits = getElementSizeInBits(
+      getMulOrFMAOperand(Op, 1).getType().cast<VectorType>());
   Scheme scheme(lanes, cols, xbits, zbits);
 
   // If element size is < 32 bits ,we can fuse multiple FMAs together to
@@ -1729,7 +2041,7 @@ static void generateSchemeBasedMulOrFMAOp(Operation *Op, VectState *state) {
   // operand, and store them in opAttr.
   for (size_t idx = 0; idx < 2; ++idx) {
     AIEVecAttributes stat = getOperandVecStats(Op, state, idx);
-    Operation *op = Op->getOperand(idx).getDefiningOp();
+    Operation *op = getMulOrFMAOperand(Op, idx).getDefiningOp();
     int32_t start = 0, accIncr = 1;
     // If the operand comes from transfer_read, compute the step and start
     // values.
@@ -1761,7 +2073,8 @@ static void fuseFMAOpsForColumnTopology(func::FuncOp func, VectState *state) {
 
   // Fuse FMA ops to exploit column topology
   func.walk([&](mlir::Operation *op) {
-    if (isa<MulIOp, MulFOp, vector::FMAOp>(op)) {
+    if (isa<MulIOp, MulFOp, vector::FMAOp>(op) &&
+        op->getResult(0).getType().isa<VectorType>()) {
       // Only process fma ops that are not already fused with another mul/fma
       if (!fusedOpSet.count(op)) {
         // Get the rows and columns for this topology
@@ -1789,9 +2102,21 @@ static void generateAIEMulOrFMAOpsInFunc(func::FuncOp func, VectState *state) {
   // For each mul/fma op, compute the scheme-dependent operand attributes, and
   // generate corresponding AIE dialect ops.
   func.walk([&](mlir::Operation *op) {
-    if (isa<MulIOp, MulFOp, vector::FMAOp>(op))
+    if (isa<MulIOp, MulFOp, vector::FMAOp>(op) &&
+        op->getResult(0).getType().isa<VectorType>())
       generateSchemeBasedMulOrFMAOp(op, state);
   });
+
+  // The AIE dialect mul/fma ops of the mixed-precision schemes consume the
+  // narrow operands directly. Remove the extension ops that are now dead, so
+  // that the UPD ops can later replace the transfer_reads feeding them.
+  SmallVector<Operation *, 8> deadExtOps;
+  func.walk([&](Operation *op) {
+    if (isa<ExtSIOp, ExtUIOp, ExtFOp>(op) && op->use_empty())
+      deadExtOps.push_back(op);
+  });
+  for (auto op : deadExtOps)
+    op->erase();
 }
 
 // Given the operation attributes (start, offset, square, etc.), generate an
@@ -1929,7 +2254,8 @@ static void generateSchemeBasedAddOrSubOp(Operation *Op, VectState *state) {
 // splat, we must generate simple scheme add op.
 static void generateAIEAddOrSubOpsInFunc(func::FuncOp func, VectState *state) {
   func.walk([&](mlir::Operation *op) {
-    if (isa<AddIOp, AddFOp, SubIOp, SubFOp>(op))
+    if (isa<AddIOp, AddFOp, SubIOp, SubFOp>(op) &&
+        op->getResult(0).getType().isa<VectorType>())
       generateSchemeBasedAddOrSubOp(op, state);
   });
 }
@@ -1976,6 +2302,539 @@ static void insertUPDOpsInFunc(func::FuncOp func, VectState *state) {
   }
 }
 
+// Return true if the value is invariant in the loop forOp. This is the case if
+// the value is defined outside the loop, or if it is computed by an affine
+// apply op of the loop body whose operands are defined outside the loop.
+static bool isLoopInvariant(Value value, AffineForOp forOp) {
+  auto definedOutside = [&](Value v) {
+    return !forOp->isAncestor(v.getParentRegion()->getParentOp());
+  };
+  if (definedOutside(value))
+    return true;
+  AffineApplyOp apOf = value.getDefiningOp<AffineApplyOp>();
+  return apOf && apOf->getBlock() == forOp.getBody() &&
+         llvm::all_of(apOf->getOperands(), definedOutside);
+}
+
+// Return true if the loop forOp writes to the array source
+static bool isWrittenInLoop(Value source, AffineForOp forOp) {
+  bool written = false;
+  forOp.walk([&](Operation *op) {
+    if (auto writeOp = dyn_cast<TransferWriteOp>(op))
+      written |= writeOp.getSource() == source;
+    else if (auto storeOp = dyn_cast<AffineWriteOpInterface>(op))
+      written |= storeOp.getMemRef() == source;
+  });
+  return written;
+}
+
+// Return true if the UPD ops upd0 and upd1 (idx=0 and idx=1) load the two
+// halves of a sliding window in the loop forOp, i.e., if the lower half loaded
+// by upd0 in an iteration of forOp is the upper half loaded by upd1 in the
+// previous iteration. This is the case when (1) the innermost index of the
+// load is the induction variable of forOp plus a constant, and the other
+// indices are loop invariant, (2) each loop iteration advances the window by
+// half its size, and (3) the loop does not write to the loaded array.
+static bool isSlidingWindow(aievec::UPDOp upd0, aievec::UPDOp upd1,
+                            AffineForOp forOp) {
+  if (upd0.getIndex() != 0 || upd0.getVector() ||
+      upd0->getBlock() != forOp.getBody() ||
+      upd0.getSource() != upd1.getSource() ||
+      !llvm::equal(upd0.getIndices(), upd1.getIndices()))
+    return false;
+
+  // Check that the window advances by its upper half in each iteration
+  VectorType vecType = upd0.getResult().getType().cast<VectorType>();
+  int32_t halfSizeInBits = getVectorSizeInBits(vecType) / 2;
+  if (upd1.getOffset() - upd0.getOffset() != halfSizeInBits ||
+      forOp.getStep() * getElementSizeInBits(vecType) != halfSizeInBits)
+    return false;
+
+  // Check the indices of the load
+  SmallVector<Value, 4> indices(upd0.getIndices().begin(),
+                                upd0.getIndices().end());
+  if (indices.empty() ||
+      !llvm::all_of(ArrayRef<Value>(indices).drop_back(),
+                    [&](Value v) { return isLoopInvariant(v, forOp); }))
+    return false;
+  Value index = indices.back();
+  if (index != forOp.getInductionVar()) {
+    AffineApplyOp apOf = index.getDefiningOp<AffineApplyOp>();
+    if (!apOf || apOf.getMapOperands().size() != 1 ||
+        apOf.getMapOperands()[0] != forOp.getInductionVar())
+      return false;
+    AffineMap map = apOf.getAffineMap();
+    if (map.getNumResults() != 1 || map.getNumDims() != 1)
+      return false;
+    AffineExpr diff = simplifyAffineExpr(
+        map.getResult(0) - getAffineDimExpr(0, map.getContext()), 1, 0);
+    if (!diff.isa<AffineConstantExpr>())
+      return false;
+  }
+
+  // Check that the loop does not write to the array
+  return !isWrittenInLoop(upd0.getSource(), forOp);
+}
+
+// Carry the overlap of the sliding windows loaded in the innermost loop forOp
+// across its iterations. A vector loaded by a pair of UPD ops (idx=0 and
+// idx=1) in each iteration, whose lower half is the upper half loaded in the
+// previous iteration, is instead concatenated from the upper half of the
+// previous iteration (carried as a loop iter_arg) and a single UPD op loading
+// its upper half. The lower half for the first iteration is loaded before the
+// loop. This halves the loads for the rows of a 2D filter.
+static void reuseSlidingWindowInLoop(AffineForOp forOp, VectState *state) {
+  // The lower half of the first window is loaded before the loop, so the
+  // loop must execute at least once.
+  Optional<uint64_t> tripCount = getConstantTripCount(forOp);
+  if (!tripCount || *tripCount == 0 ||
+      forOp.getLowerBoundMap().getNumResults() != 1)
+    return;
+
+  // Collect the pairs of UPD ops that load a sliding window
+  SmallVector<std::pair<aievec::UPDOp, aievec::UPDOp>, 4> windows;
+  for (aievec::UPDOp upd1 : llvm::to_vector<8>(
+           forOp.getBody()->getOps<aievec::UPDOp>())) {
+    if (upd1.getIndex() != 1 || !upd1.getVector())
+      continue;
+    aievec::UPDOp upd0 = upd1.getVector().getDefiningOp<aievec::UPDOp>();
+    if (upd0 && isSlidingWindow(upd0, upd1, forOp))
+      windows.push_back(std::make_pair(upd0, upd1));
+  }
+  if (windows.empty())
+    return;
+
+  LLVM_DEBUG(llvm::dbgs() << "\n\nCarrying " << windows.size()
+                          << " sliding window(s) across loop " << forOp);
+
+  // Load the lower half of each window for the first iteration before the
+  // loop. These will be the initial values of the new loop iter_args.
+  OpBuilder &builder = state->builder;
+  builder.setInsertionPoint(forOp);
+  Location loc = forOp.getLoc();
+  Value lb = builder.create<AffineApplyOp>(loc, forOp.getLowerBoundMap(),
+                                           forOp.getLowerBoundOperands());
+  SmallVector<Value, 4> iterOperands(forOp.getIterOperands().begin(),
+                                     forOp.getIterOperands().end());
+  unsigned numIterArgs = iterOperands.size();
+  for (auto &window : windows) {
+    aievec::UPDOp upd0 = window.first;
+    SmallVector<Value, 4> indices(upd0.getIndices().begin(),
+                                  upd0.getIndices().end());
+    // Hoist the computation of the loop invariant indices
+    for (auto &value : ArrayRef<Value>(indices).drop_back()) {
+      Operation *defOp = value.getDefiningOp();
+      if (defOp && defOp->getBlock() == forOp.getBody())
+        defOp->moveBefore(forOp);
+    }
+    // The innermost index for the first iteration
+    if (AffineApplyOp apOf = indices.back().getDefiningOp<AffineApplyOp>())
+      indices.back() =
+          builder.create<AffineApplyOp>(loc, apOf.getAffineMap(), lb);
+    else
+      indices.back() = lb;
+    VectorType vecType = upd0.getResult().getType().cast<VectorType>();
+    VectorType halfType = createVectorType(getVectorLaneSize(vecType) / 2,
+                                           vecType.getElementType());
+    aievec::UPDOp loUpd = builder.create<aievec::UPDOp>(
+        upd0.getLoc(), halfType, upd0.getSource(), indices, upd0.getOffset(),
+        0);
+    iterOperands.push_back(loUpd);
+  }
+
+  // Create the new loop with the additional iter_args, and move the body of
+  // forOp into it.
+  AffineForOp newForOp = builder.create<AffineForOp>(
+      loc, forOp.getLowerBoundOperands(), forOp.getLowerBoundMap(),
+      forOp.getUpperBoundOperands(), forOp.getUpperBoundMap(),
+      forOp.getStep(), iterOperands);
+  Block *newBody = newForOp.getBody();
+  if (!newBody->empty())
+    newBody->back().erase();
+  newBody->getOperations().splice(newBody->end(),
+                                  forOp.getBody()->getOperations());
+  forOp.getInductionVar().replaceAllUsesWith(newForOp.getInductionVar());
+  for (auto it :
+       llvm::zip(forOp.getRegionIterArgs(), newForOp.getRegionIterArgs()))
+    std::get<0>(it).replaceAllUsesWith(std::get<1>(it));
+
+  // Replace each pair of UPD ops by the load of the upper half, concatenated
+  // with the upper half of the previous iteration.
+  SmallVector<Value, 4> yieldOperands(newBody->getTerminator()->getOperands());
+  for (auto window : llvm::enumerate(windows)) {
+    aievec::UPDOp upd0 = window.value().first;
+    aievec::UPDOp upd1 = window.value().second;
+    VectorType vecType = upd1.getResult().getType().cast<VectorType>();
+    VectorType halfType = createVectorType(getVectorLaneSize(vecType) / 2,
+                                           vecType.getElementType());
+    // Users of upd0 only read its lower half, so generate the new ops at upd0
+    builder.setInsertionPoint(upd0);
+    aievec::UPDOp hiUpd = builder.create<aievec::UPDOp>(
+        upd1.getLoc(), halfType, upd1.getSource(), upd1.getIndices(),
+        upd1.getOffset(), 0);
+    SmallVector<Value> sources = {
+        newForOp.getRegionIterArgs()[numIterArgs + window.index()], hiUpd};
+    aievec::ConcatOp concatOp =
+        generateConcatOp(sources, state, upd1.getLoc(), vecType);
+    upd1->replaceAllUsesWith(concatOp);
+    upd1->erase();
+    upd0->replaceAllUsesWith(concatOp);
+    upd0->erase();
+    yieldOperands.push_back(hiUpd);
+  }
+
+  // Yield the upper halves to the next iteration
+  Operation *yieldOp = newBody->getTerminator();
+  builder.setInsertionPoint(yieldOp);
+  builder.create<AffineYieldOp>(yieldOp->getLoc(), yieldOperands);
+  yieldOp->erase();
+
+  // Replace the results of forOp, and erase it
+  for (auto it : llvm::zip(forOp.getResults(), newForOp.getResults()))
+    std::get<0>(it).replaceAllUsesWith(std::get<1>(it));
+  forOp.erase();
+}
+
+// Carry the overlap of sliding windows across the iterations of all the
+// innermost loops in the function.
+static void reuseSlidingWindowInFunc(func::FuncOp func, VectState *state) {
+  SmallVector<AffineForOp, 8> innermostLoops;
+  func.walk([&](AffineForOp forOp) {
+    if (forOp.getBody()->getOps<AffineForOp>().empty())
+      innermostLoops.push_back(forOp);
+  });
+  for (auto forOp : innermostLoops)
+    reuseSlidingWindowInLoop(forOp, state);
+}
+
+// Return true if the UPD op loads the same data in each iteration of forOp
+static bool isLoopInvariantLoad(aievec::UPDOp updOp, AffineForOp forOp) {
+  return llvm::all_of(updOp->getOperands(), [&](Value v) {
+    if (isLoopInvariant(v, forOp) || v.getDefiningOp<arith::ConstantOp>())
+      return true;
+    auto defOp = v.getDefiningOp<aievec::UPDOp>();
+    return defOp && isLoopInvariantLoad(defOp, forOp);
+  });
+}
+
+// Collect in slice the ops of the loop body forOp that compute value, if value
+// can be computed ahead of time for another iteration of forOp. This is the
+// case if value only depends on the induction variable of forOp, the loop
+// invariants, and UPD, affine apply and constant ops of the loop body. The ops
+// are collected in topological order.
+static bool collectLoadSlice(Value value, AffineForOp forOp,
+                             llvm::SetVector<Operation *> &slice) {
+  if (value == forOp.getInductionVar() ||
+      !forOp->isAncestor(value.getParentRegion()->getParentOp()))
+    return true;
+  Operation *defOp = value.getDefiningOp();
+  if (!defOp || defOp->getBlock() != forOp.getBody() ||
+      !isa<aievec::UPDOp, AffineApplyOp, arith::ConstantOp>(defOp))
+    return false;
+  if (slice.count(defOp))
+    return true;
+  // The loop must not write to the array that the UPD op loads from
+  if (auto updOp = dyn_cast<aievec::UPDOp>(defOp))
+    if (isWrittenInLoop(updOp.getSource(), forOp))
+      return false;
+  for (Value operand : defOp->getOperands())
+    if (!collectLoadSlice(operand, forOp, slice))
+      return false;
+  slice.insert(defOp);
+  return true;
+}
+
+// Estimate the cycles of one iteration of the loop body, given the number of
+// 256-bit loads and mul/mac ops in it. The AIE core issues one vector mul/mac
+// and two loads per cycle, and a load takes 'loadLatency' cycles before its
+// result can be used. Without pipelining, the mul/mac ops wait for the loads
+// of their own iteration. With pipelining, the loads of the next iteration
+// are in flight while the mul/mac ops of the current one issue.
+static int32_t estimateLoopBodyCycles(int32_t loads, int32_t macs,
+                                      bool pipelined) {
+  const int32_t loadLatency = 7;
+  int32_t loadCycles = llvm::divideCeil(loads, 2);
+  if (pipelined)
+    return std::max({loadCycles, macs, loadLatency});
+  return loadCycles + loadLatency + macs;
+}
+
+// Software pipeline the UPD ops of the innermost loop forOp: the loads for
+// iteration i+1 are issued at the start of iteration i, ahead of its mul/mac
+// ops, and are carried to the next iteration as loop iter_args. The loads for
+// the first iteration are issued in a prologue before the loop, and the last
+// iteration is peeled into an epilogue that issues no loads.
+static void pipelineLoadsInLoop(AffineForOp forOp, VectState *state) {
+  // The loop must have constant trip count of at least two, so that the last
+  // iteration can be peeled.
+  Optional<uint64_t> tripCount = getConstantTripCount(forOp);
+  if (!tripCount || *tripCount < 2 ||
+      forOp.getLowerBoundMap().getNumResults() != 1)
+    return;
+
+  // Collect the UPD ops that can be loaded an iteration ahead, along with the
+  // ops that compute their indices.
+  Block *body = forOp.getBody();
+  llvm::SetVector<Operation *> slice;
+  int32_t loads = 0, macs = 0;
+  for (Operation &op : body->without_terminator()) {
+    if (isa<aievec::MulOp, aievec::FMAOp>(op))
+      ++macs;
+    auto updOp = dyn_cast<aievec::UPDOp>(op);
+    // Skip the loop invariant loads; they will be hoisted out of the loop
+    if (!updOp || isLoopInvariantLoad(updOp, forOp))
+      continue;
+    // A UPD op of a vector wider than 256 bits loads one of its halves
+    int32_t bits = getVectorSizeInBits(
+        updOp.getResult().getType().cast<VectorType>());
+    loads += llvm::divideCeil(bits > 256 ? bits / 2 : bits, 256);
+    llvm::SetVector<Operation *> opSlice(slice.begin(), slice.end());
+    if (collectLoadSlice(updOp, forOp, opSlice))
+      slice = opSlice;
+  }
+  // The vectors loaded by UPD ops, and used by the rest of the loop body, are
+  // carried across the iterations. A UPD op loading the lower half of a vector
+  // is updated in place by the UPD op loading its upper half. The users of
+  // the former only read the lower half, so they can use the complete vector.
+  DenseMap<Operation *, Operation *> updatedBy;
+  for (Operation *op : slice)
+    if (auto updOp = dyn_cast<aievec::UPDOp>(op))
+      if (Value vector = updOp.getVector())
+        updatedBy[vector.getDefiningOp()] = op;
+  auto getCompleteVector = [&](Operation *op) {
+    while (updatedBy.count(op))
+      op = updatedBy[op];
+    return op;
+  };
+  auto usedOutsideSlice = [&](Operation *op) {
+    return llvm::any_of(op->getUsers(),
+                        [&](Operation *user) { return !slice.count(user); });
+  };
+  llvm::SetVector<Operation *> carried;
+  for (Operation *op : slice)
+    if (isa<aievec::UPDOp>(op) && usedOutsideSlice(op))
+      carried.insert(getCompleteVector(op));
+  if (carried.empty())
+    return;
+
+  forOp.emitRemark() << "pipelined loads of " << carried.size()
+                     << " vector(s); estimated cycles per iteration: "
+                     << estimateLoopBodyCycles(loads, macs, false) << " -> "
+                     << estimateLoopBodyCycles(loads, macs, true);
+
+  OpBuilder &builder = state->builder;
+  Location loc = forOp.getLoc();
+  int64_t step = forOp.getStep();
+  AffineMap lbMap = forOp.getLowerBoundMap();
+  SmallVector<Value, 4> lbOperands(forOp.getLowerBoundOperands().begin(),
+                                   forOp.getLowerBoundOperands().end());
+  // The new loop runs from lb to the induction variable of the last iteration
+  AffineMap lastMap =
+      AffineMap::get(lbMap.getNumDims(), lbMap.getNumSymbols(),
+                     lbMap.getResult(0) + (*tripCount - 1) * step);
+
+  // Prologue: issue the loads for the first iteration
+  builder.setInsertionPoint(forOp);
+  BlockAndValueMapping prologueMap;
+  prologueMap.map(forOp.getInductionVar(),
+                  builder.create<AffineApplyOp>(loc, lbMap, lbOperands));
+  for (Operation *op : slice)
+    builder.clone(*op, prologueMap);
+  SmallVector<Value, 4> iterOperands(forOp.getIterOperands().begin(),
+                                     forOp.getIterOperands().end());
+  unsigned numIterArgs = iterOperands.size();
+  for (Operation *op : carried)
+    iterOperands.push_back(prologueMap.lookup(op->getResult(0)));
+
+  // Create the new loop with the additional iter_args, and move the body of
+  // forOp into it.
+  AffineForOp newForOp = builder.create<AffineForOp>(
+      loc, lbOperands, lbMap, lbOperands, lastMap, step, iterOperands);
+  Block *newBody = newForOp.getBody();
+  if (!newBody->empty())
+    newBody->back().erase();
+  newBody->getOperations().splice(newBody->end(), body->getOperations());
+  forOp.getInductionVar().replaceAllUsesWith(newForOp.getInductionVar());
+  for (auto it :
+       llvm::zip(forOp.getRegionIterArgs(), newForOp.getRegionIterArgs()))
+    std::get<0>(it).replaceAllUsesWith(std::get<1>(it));
+
+  // Issue the loads for the next iteration at the start of the loop body, and
+  // use the loads carried from the previous iteration in place of the
+  // original ones.
+  builder.setInsertionPointToStart(newBody);
+  llvm::SmallPtrSet<Operation *, 16> nextOps;
+  Value nextIv = builder.create<AffineApplyOp>(
+      loc, AffineMap::get(1, 0, builder.getAffineDimExpr(0) + step),
+      newForOp.getInductionVar());
+  nextOps.insert(nextIv.getDefiningOp());
+  BlockAndValueMapping nextMap;
+  nextMap.map(newForOp.getInductionVar(), nextIv);
+  for (Operation *op : slice)
+    nextOps.insert(builder.clone(*op, nextMap));
+  for (Operation *op : slice) {
+    if (!isa<aievec::UPDOp>(op) || !usedOutsideSlice(op))
+      continue;
+    unsigned idx = numIterArgs + llvm::find(carried, getCompleteVector(op)) -
+                   carried.begin();
+    op->getResult(0).replaceAllUsesWith(newForOp.getRegionIterArgs()[idx]);
+  }
+  // Yield the loads for the next iteration
+  Operation *yieldOp = newBody->getTerminator();
+  SmallVector<Value, 4> yieldOperands(yieldOp->getOperands());
+  for (Operation *op : carried)
+    yieldOperands.push_back(nextMap.lookup(op->getResult(0)));
+  builder.setInsertionPoint(yieldOp);
+  builder.create<AffineYieldOp>(yieldOp->getLoc(), yieldOperands);
+  yieldOp->erase();
+  for (Operation *op : llvm::reverse(slice))
+    if (op->use_empty())
+      op->erase();
+
+  // Epilogue: peel the last iteration, which uses the loads carried out of the
+  // loop, and issues no loads.
+  builder.setInsertionPointAfter(newForOp);
+  BlockAndValueMapping epilogueMap;
+  epilogueMap.map(newForOp.getInductionVar(),
+                  builder.create<AffineApplyOp>(loc, lastMap, lbOperands));
+  for (auto it :
+       llvm::zip(newForOp.getRegionIterArgs(), newForOp.getResults()))
+    epilogueMap.map(std::get<0>(it), std::get<1>(it));
+  for (Operation &op : newBody->without_terminator())
+    if (!nextOps.count(&op))
+      builder.clone(op, epilogueMap);
+
+  // Replace the results of forOp with the values yielded by the epilogue, and
+  // erase it.
+  Operation *terminator = newBody->getTerminator();
+  for (auto it : llvm::enumerate(forOp.getResults()))
+    it.value().replaceAllUsesWith(
+        epilogueMap.lookupOrDefault(terminator->getOperand(it.index())));
+  forOp.erase();
+}
+
+// Software pipeline the loads of all the innermost loops in the function
+static void pipelineLoadsInFunc(func::FuncOp func, VectState *state) {
+  SmallVector<AffineForOp, 8> innermostLoops;
+  func.walk([&](AffineForOp forOp) {
+    if (forOp.getBody()->getOps<AffineForOp>().empty())
+      innermostLoops.push_back(forOp);
+  });
+  for (auto forOp : innermostLoops)
+    pipelineLoadsInLoop(forOp, state);
+}
+
+// Keep the loop-carried reductions of forOp in the accumulator. A vector
+// iter_arg that is only moved into the accumulator (UPS) in the loop body, and
+// whose yielded value is moved out of the accumulator (SRS) with the same
+// shift, is replaced by an accumulator iter_arg. The UPS op then happens once
+// before the loop, and the SRS op once after it.
+static void carryAccumulatorsInLoop(AffineForOp forOp, VectState *state) {
+  Operation *yieldOp = forOp.getBody()->getTerminator();
+  SmallVector<Value, 4> iterOperands(forOp.getIterOperands().begin(),
+                                     forOp.getIterOperands().end());
+  SmallVector<Value, 4> yieldOperands(yieldOp->getOperands());
+  // The shift of the reductions carried in the accumulator, keyed by the
+  // iter_arg position
+  DenseMap<unsigned, uint8_t> accShifts;
+
+  for (auto it : llvm::enumerate(forOp.getRegionIterArgs())) {
+    Value iterArg = it.value();
+    aievec::SRSOp srsOp =
+        yieldOperands[it.index()].getDefiningOp<aievec::SRSOp>();
+    if (iterArg.use_empty() || !srsOp)
+      continue;
+    // All the uses of the iter_arg must be UPS ops that move it into the
+    // accumulator yielded by srsOp, with the same shift.
+    Type accType = srsOp.getSource().getType();
+    auto isMatchingUPS = [&](Operation *user) {
+      aievec::UPSOp upsOp = dyn_cast<aievec::UPSOp>(user);
+      return upsOp && upsOp.getShift() == srsOp.getShift() &&
+             upsOp.getResult().getType() == accType;
+    };
+    if (!llvm::all_of(iterArg.getUsers(), isMatchingUPS))
+      continue;
+
+    state->builder.setInsertionPoint(forOp);
+    iterOperands[it.index()] = state->builder.create<aievec::UPSOp>(
+        forOp.getLoc(), accType, iterOperands[it.index()], srsOp.getShift());
+    yieldOperands[it.index()] = srsOp.getSource();
+    accShifts[it.index()] = srsOp.getShift();
+  }
+  if (accShifts.empty())
+    return;
+
+  LLVM_DEBUG(llvm::dbgs() << "\n\nCarrying " << accShifts.size()
+                          << " reduction(s) in accumulator across loop "
+                          << forOp);
+
+  // Create the new loop with the accumulator iter_args, and move the body of
+  // forOp into it.
+  OpBuilder &builder = state->builder;
+  builder.setInsertionPoint(forOp);
+  AffineForOp newForOp = builder.create<AffineForOp>(
+      forOp.getLoc(), forOp.getLowerBoundOperands(), forOp.getLowerBoundMap(),
+      forOp.getUpperBoundOperands(), forOp.getUpperBoundMap(),
+      forOp.getStep(), iterOperands);
+  Block *newBody = newForOp.getBody();
+  if (!newBody->empty())
+    newBody->back().erase();
+  newBody->getOperations().splice(newBody->end(),
+                                  forOp.getBody()->getOperations());
+  forOp.getInductionVar().replaceAllUsesWith(newForOp.getInductionVar());
+  for (auto it : llvm::enumerate(llvm::zip(forOp.getRegionIterArgs(),
+                                           newForOp.getRegionIterArgs()))) {
+    Value oldArg = std::get<0>(it.value());
+    Value newArg = std::get<1>(it.value());
+    if (!accShifts.count(it.index())) {
+      oldArg.replaceAllUsesWith(newArg);
+      continue;
+    }
+    for (Operation *user : llvm::make_early_inc_range(oldArg.getUsers())) {
+      user->getResult(0).replaceAllUsesWith(newArg);
+      user->erase();
+    }
+  }
+
+  // Yield the accumulators, and remove the SRS ops that became dead
+  builder.setInsertionPoint(yieldOp);
+  builder.create<AffineYieldOp>(yieldOp->getLoc(), yieldOperands);
+  llvm::SetVector<Operation *> srsOps;
+  for (auto entry : accShifts)
+    srsOps.insert(yieldOp->getOperand(entry.first).getDefiningOp());
+  yieldOp->erase();
+  for (Operation *srsOp : srsOps)
+    if (srsOp->use_empty())
+      srsOp->erase();
+
+  // Move the accumulators out of the loop results into vectors, and replace
+  // the results of forOp.
+  builder.setInsertionPointAfter(newForOp);
+  for (auto it : llvm::enumerate(forOp.getResults())) {
+    Value result = newForOp.getResult(it.index());
+    if (accShifts.count(it.index()))
+      result = builder.create<aievec::SRSOp>(newForOp.getLoc(),
+                                             it.value().getType(), result,
+                                             accShifts[it.index()]);
+    it.value().replaceAllUsesWith(result);
+  }
+  forOp.erase();
+}
+
+// Keep the loop-carried reductions of all the loops in the function in the
+// accumulator. The loops are visited innermost first, so that a reduction
+// carried in the accumulator by an inner loop can be carried by the outer
+// loops as well.
+static void carryAccumulatorsInFunc(func::FuncOp func, VectState *state) {
+  SmallVector<AffineForOp, 8> loops;
+  func.walk([&](AffineForOp forOp) {
+    if (forOp.getNumIterOperands() > 0)
+      loops.push_back(forOp);
+  });
+  for (AffineForOp forOp : loops)
+    carryAccumulatorsInLoop(forOp, state);
+}
+
 // Incoming Op is an operation in AIE dialect whose result is an accumulator.
 // Check all its uses, and if any user of Op is a non-AIE operation, insert an
 // SRS instruction to move the value from accumulator to vector.
@@ -2234,11 +3093,17 @@ static void computeReuse(TransferReadOp readOp, VectState *state) {
   // Check if this readOp is the lhs or rhs operand of a mul/fma op. If it is,
   // then the vector size corresponding to its access extent should at least be
   // 256 bits. Otherwise, AIE vectors are at least 128 bits.
+  // The read could also reach the mul/fma op through an extension op in the
+  // mixed-precision schemes.
   unsigned minVecSize = 128;
-  for (auto user : readOp->getUsers()) {
+  SmallVector<Operation *, 8> users(readOp->getUsers());
+  for (auto user : readOp->getUsers())
+    if (isa<ExtSIOp, ExtUIOp, ExtFOp>(user))
+      users.append(user->getUsers().begin(), user->getUsers().end());
+  for (auto user : users) {
     if (isa<MulIOp, MulFOp, vector::FMAOp>(user)) {
-      if (user->getOperand(0).getDefiningOp() == readOp ||
-          user->getOperand(1).getDefiningOp() == readOp) {
+      if (getMulOrFMAOperand(user, 0).getDefiningOp() == readOp ||
+          getMulOrFMAOperand(user, 1).getDefiningOp() == readOp) {
         minVecSize = 256;
         break;
       }
@@ -2371,6 +3236,229 @@ static LogicalResult hasUnalignedLoads(func::FuncOp func, VectState *state) {
   return success();
 }
 
+// Return the number of vector lanes if the innermost index of the transfer
+// op varies with iv, and 0 otherwise.
+template <typename TransferOp>
+static unsigned getLanesAlongIV(TransferOp op, Value iv) {
+  if (op.getPermutationMap().isConstant() || op.getIndices().empty())
+    return 0;
+  Value index = op.getIndices().back();
+  bool isVariant = index == iv;
+  if (auto apOf = index.getDefiningOp<AffineApplyOp>())
+    isVariant = llvm::is_contained(apOf.getOperands(), iv);
+  if (!isVariant)
+    return 0;
+  return getVectorLaneSize(
+      op.getVector().getType().template cast<VectorType>());
+}
+
+// Return the number of lanes of the vector loads/stores in the body of the
+// innermost loop forOp that are vectorized along its induction variable, or 0
+// if there are none.
+static unsigned getVectorizedLoopLanes(AffineForOp forOp) {
+  Value iv = forOp.getInductionVar();
+  unsigned lanes = 0;
+  for (Operation &op : forOp.getBody()->without_terminator()) {
+    if (auto readOp = dyn_cast<TransferReadOp>(op))
+      lanes = std::max(lanes, getLanesAlongIV(readOp, iv));
+    else if (auto writeOp = dyn_cast<TransferWriteOp>(op))
+      lanes = std::max(lanes, getLanesAlongIV(writeOp, iv));
+  }
+  return lanes;
+}
+
+// Return true if the op in the body of a vectorized loop can be rewritten to
+// compute a single lane of its result.
+static bool canScalarize(Operation &op) {
+  if (op.getNumRegions() != 0)
+    return false;
+  // A load must either read contiguous lanes, or be splat. A store must write
+  // contiguous lanes.
+  if (auto readOp = dyn_cast<TransferReadOp>(op))
+    return !readOp.getMask() && (readOp.getPermutationMap().isConstant() ||
+                                 readOp.getPermutationMap().isMinorIdentity());
+  if (auto writeOp = dyn_cast<TransferWriteOp>(op))
+    return !writeOp.getMask() && writeOp.getPermutationMap().isMinorIdentity();
+  if (isa<vector::FMAOp, vector::BroadcastOp, AffineApplyOp>(op))
+    return true;
+  if (auto cstOp = dyn_cast<arith::ConstantOp>(op)) {
+    auto attr = cstOp.getValue().dyn_cast<DenseElementsAttr>();
+    return !cstOp.getType().isa<VectorType>() || (attr && attr.isSplat());
+  }
+  return isa<arith::ArithmeticDialect>(op.getDialect());
+}
+
+// Generate the op that computes a single lane of the vector op, and map the
+// results of op to its results in mapping.
+static void scalarizeOp(Operation &op, BlockAndValueMapping &mapping,
+                        OpBuilder &builder) {
+  Location loc = op.getLoc();
+  auto lookupIndices = [&](ValueRange indices) {
+    SmallVector<Value, 4> newIndices;
+    for (Value index : indices)
+      newIndices.push_back(mapping.lookupOrDefault(index));
+    return newIndices;
+  };
+
+  if (auto readOp = dyn_cast<TransferReadOp>(op)) {
+    Value load = builder.create<memref::LoadOp>(
+        loc, mapping.lookupOrDefault(readOp.getSource()),
+        lookupIndices(readOp.getIndices()));
+    mapping.map(readOp.getResult(), load);
+  } else if (auto writeOp = dyn_cast<TransferWriteOp>(op)) {
+    builder.create<memref::StoreOp>(
+        loc, mapping.lookupOrDefault(writeOp.getVector()),
+        mapping.lookupOrDefault(writeOp.getSource()),
+        lookupIndices(writeOp.getIndices()));
+  } else if (auto fmaOp = dyn_cast<vector::FMAOp>(op)) {
+    Value lhs = mapping.lookupOrDefault(fmaOp.getLhs());
+    Value rhs = mapping.lookupOrDefault(fmaOp.getRhs());
+    Value acc = mapping.lookupOrDefault(fmaOp.getAcc());
+    Value sum;
+    if (lhs.getType().isa<IntegerType>())
+      sum = builder.create<AddIOp>(loc, acc,
+                                   builder.create<MulIOp>(loc, lhs, rhs));
+    else
+      sum = builder.create<AddFOp>(loc, acc,
+                                   builder.create<MulFOp>(loc, lhs, rhs));
+    mapping.map(fmaOp.getResult(), sum);
+  } else if (auto bcastOp = dyn_cast<vector::BroadcastOp>(op)) {
+    mapping.map(bcastOp.getResult(),
+                mapping.lookupOrDefault(bcastOp.getSource()));
+  } else if (isa<arith::ConstantOp>(op) &&
+             op.getResult(0).getType().isa<VectorType>()) {
+    auto attr =
+        cast<arith::ConstantOp>(op).getValue().cast<DenseElementsAttr>();
+    Value cst =
+        builder.create<arith::ConstantOp>(loc, attr.getSplatValue<Attribute>());
+    mapping.map(op.getResult(0), cst);
+  } else {
+    Operation *newOp = builder.clone(op, mapping);
+    for (Value result : newOp->getResults())
+      result.setType(getElementTypeOrSelf(result.getType()));
+  }
+}
+
+// Create a scalar loop with the given bounds before the insertion point. Each
+// iteration of the scalar loop computes one lane of the body of the vectorized
+// loop forOp.
+static void generateScalarLoop(AffineForOp forOp, ValueRange lbOperands,
+                               AffineMap lbMap, ValueRange ubOperands,
+                               AffineMap ubMap, VectState *state) {
+  AffineForOp scalarForOp = state->builder.create<AffineForOp>(
+      forOp.getLoc(), lbOperands, lbMap, ubOperands, ubMap, /*step=*/1);
+  BlockAndValueMapping mapping;
+  mapping.map(forOp.getInductionVar(), scalarForOp.getInductionVar());
+  OpBuilder::InsertionGuard guard(state->builder);
+  state->builder.setInsertionPoint(scalarForOp.getBody()->getTerminator());
+  for (Operation &op : forOp.getBody()->without_terminator())
+    scalarizeOp(op, mapping, state->builder);
+}
+
+// The AIE vector loads are aligned to the vector size, and the vectorized
+// loop assumes that its induction variable starts at a multiple of the vector
+// lanes and that its trip count is a multiple of the step. Split the innermost
+// vectorized loop forOp that does not satisfy these assumptions into (1) a
+// scalar prologue loop that runs up to the first aligned iteration, if the
+// lower bound is a constant that is not aligned; (2) the vectorized loop,
+// with its upper bound rounded down to a multiple of the step; and (3) a
+// scalar remainder loop for the iterations left. A lower bound that is not
+// constant is assumed to be aligned, as before.
+static void peelUnalignedIterations(AffineForOp forOp, VectState *state) {
+  int64_t step = forOp.getStep();
+  if (!forOp.getBody()->getOps<AffineForOp>().empty() ||
+      forOp.getNumIterOperands() > 0 ||
+      step != getVectorizedLoopLanes(forOp) ||
+      forOp.getLowerBoundMap().getNumResults() != 1 ||
+      forOp.getUpperBoundMap().getNumResults() != 1 ||
+      !llvm::all_of(forOp.getBody()->without_terminator(), canScalarize))
+    return;
+  // The vectors used in the body must also be computed in it
+  auto isDefinedOutside = [&](Value value) {
+    return value.getType().isa<VectorType>() &&
+           value.getParentBlock() != forOp.getBody();
+  };
+  for (Operation &op : forOp.getBody()->without_terminator())
+    if (llvm::any_of(op.getOperands(), isDefinedOutside))
+      return;
+
+  MLIRContext *context = forOp.getContext();
+  AffineMap lbMap = forOp.getLowerBoundMap();
+  AffineMap ubMap = forOp.getUpperBoundMap();
+  SmallVector<Value, 4> lbOperands(forOp.getLowerBoundOperands());
+  SmallVector<Value, 4> ubOperands(forOp.getUpperBoundOperands());
+
+  // Peel the iterations before the first aligned one, or before the upper
+  // bound if the loop ends earlier.
+  bool peelPrologue = lbMap.isSingleConstant() &&
+                      lbMap.getSingleConstantResult() >= 0 &&
+                      lbMap.getSingleConstantResult() % step != 0;
+  if (peelPrologue) {
+    int64_t alignedLb =
+        llvm::alignTo(lbMap.getSingleConstantResult(), step);
+    AffineMap prologueUbMap = AffineMap::get(
+        ubMap.getNumDims(), ubMap.getNumSymbols(),
+        {getAffineConstantExpr(alignedLb, context), ubMap.getResult(0)},
+        context);
+    state->builder.setInsertionPoint(forOp);
+    generateScalarLoop(forOp, lbOperands, lbMap, ubOperands, prologueUbMap,
+                       state);
+    lbMap = AffineMap::getConstantMap(alignedLb, context);
+    lbOperands.clear();
+    forOp.setLowerBound(lbOperands, lbMap);
+  }
+
+  // Nothing remains if the trip count is a known multiple of the step
+  bool peelRemainder =
+      !lbMap.isSingleConstant() || !ubMap.isSingleConstant() ||
+      (ubMap.getSingleConstantResult() - lbMap.getSingleConstantResult()) %
+              step !=
+          0;
+  if (peelRemainder) {
+    // Combine the operands of the lower and upper bound into one list of dims
+    // followed by symbols, and express the aligned upper bound on them.
+    unsigned lbDims = lbMap.getNumDims(), ubDims = ubMap.getNumDims();
+    unsigned lbSyms = lbMap.getNumSymbols(), ubSyms = ubMap.getNumSymbols();
+    SmallVector<Value, 8> operands(lbOperands.begin(),
+                                   lbOperands.begin() + lbDims);
+    operands.append(ubOperands.begin(), ubOperands.begin() + ubDims);
+    operands.append(lbOperands.begin() + lbDims, lbOperands.end());
+    operands.append(ubOperands.begin() + ubDims, ubOperands.end());
+    AffineExpr lbExpr = lbMap.getResult(0);
+    AffineExpr ubExpr = ubMap.getResult(0)
+                            .shiftDims(ubDims, lbDims)
+                            .shiftSymbols(ubSyms, lbSyms);
+    AffineExpr alignedUbExpr = lbExpr + (ubExpr - lbExpr).floorDiv(step) * step;
+    AffineMap alignedUbMap = AffineMap::get(lbDims + ubDims, lbSyms + ubSyms,
+                                            alignedUbExpr, context);
+    // The remainder loop starts at the aligned upper bound, or at the lower
+    // bound if the vectorized loop does not execute.
+    AffineMap remainderLbMap = AffineMap::get(
+        lbDims + ubDims, lbSyms + ubSyms, {lbExpr, alignedUbExpr}, context);
+    state->builder.setInsertionPointAfter(forOp);
+    generateScalarLoop(forOp, operands, remainderLbMap, ubOperands, ubMap,
+                       state);
+    forOp.setUpperBound(operands, alignedUbMap);
+  }
+
+  if (peelPrologue || peelRemainder)
+    LLVM_DEBUG(llvm::dbgs() << "\n\nPeeled the unaligned iterations of loop "
+                            << forOp);
+}
+
+// Peel the unaligned iterations of all the innermost vectorized loops in the
+// function into scalar loops.
+static void peelUnalignedIterationsInFunc(func::FuncOp func,
+                                          VectState *state) {
+  SmallVector<AffineForOp, 8> innermostLoops;
+  func.walk([&](AffineForOp forOp) {
+    if (forOp.getBody()->getOps<AffineForOp>().empty())
+      innermostLoops.push_back(forOp);
+  });
+  for (auto forOp : innermostLoops)
+    peelUnalignedIterations(forOp, state);
+}
+
 // Compute the reuse interval for all the transfer_read operations. The
 // transfer_read operations capture the vector load. Since AIE only allows for
 // aligned vector loads, we need to compose multiple transfer reads together to
@@ -2396,6 +3484,77 @@ static void rewriteFMAOpsInFunc(func::FuncOp func, VectState *state) {
   });
 }
 
+// If an operand of the integer add/sub op Op is a single-use fma op, sink Op
+// below that fma op: {d = (b*c+e) + a;} becomes {d = b*c + (e+a);}. The
+// partial sum of the fma op then never leaves the accumulator. Return the
+// newly created add/sub op, or nullptr if Op could not be sunk.
+static Operation *sinkAddOrSubBelowFMAOp(Operation *Op, VectState *state) {
+  bool isSub = isa<SubIOp>(Op);
+  for (unsigned idx : {1u, 0u}) {
+    auto fmaOp = Op->getOperand(idx).getDefiningOp<vector::FMAOp>();
+    if (!fmaOp || !fmaOp->hasOneUse() || fmaOp->getBlock() != Op->getBlock())
+      continue;
+
+    // Create the add/sub of the other operand of Op and the accumulator of
+    // fmaOp, keeping the order of the operands of a sub op.
+    state->builder.setInsertionPoint(Op);
+    Value other = Op->getOperand(1 - idx);
+    Value lhs = idx == 1 ? other : fmaOp.getAcc();
+    Value rhs = idx == 1 ? fmaOp.getAcc() : other;
+    Operation *newOp =
+        isSub ? state->builder.create<SubIOp>(Op->getLoc(), lhs, rhs)
+              : state->builder.create<AddIOp>(Op->getLoc(), lhs, rhs);
+    Operation *newFMAOp = state->builder.create<vector::FMAOp>(
+        fmaOp->getLoc(), fmaOp.getLhs(), fmaOp.getRhs(), newOp->getResult(0));
+
+    // Subtracting an fma op from the other operand flips the sign of its
+    // product, i.e., a - (b*c+e) = (a-e) - b*c.
+    bool isMsc = state->mscOps.count(fmaOp);
+    if (isSub && idx == 1)
+      isMsc = !isMsc;
+    if (isMsc)
+      state->mscOps.insert(newFMAOp);
+    state->mscOps.erase(fmaOp);
+
+    LLVM_DEBUG(llvm::dbgs() << "\n\nSank " << *Op << "\n\tbelow fma op "
+                            << *fmaOp << "\n\tas " << *newOp << "\n\tand "
+                            << *newFMAOp);
+
+    Op->replaceAllUsesWith(newFMAOp);
+    Op->erase();
+    fmaOp->erase();
+    return newOp;
+  }
+  return nullptr;
+}
+
+// Keep the partial sums of integer add/sub chains in the accumulator. Each
+// add/sub op that combines fma chains is sunk below them, so that the chains
+// are joined into a single chain of fma ops. The add/sub op left at the head
+// of the chain is fused with a mul op if possible. An SRS op is then only
+// required at the end of the joined chain.
+static void sinkAddOrSubOpsInFunc(func::FuncOp func, VectState *state) {
+  SmallVector<Operation *, 8> rootOps;
+  func.walk([&](Operation *Op) {
+    if (isa<AddIOp, SubIOp>(Op) && isWellFormedVectorOp(Op))
+      rootOps.push_back(Op);
+  });
+
+  for (auto Op : rootOps) {
+    while (Operation *newOp = sinkAddOrSubBelowFMAOp(Op, state))
+      Op = newOp;
+    // The mul op must be the right operand of an add op to be fused
+    if (isa<AddIOp>(Op) && isa_and_nonnull<MulIOp>(
+                               Op->getOperand(0).getDefiningOp())) {
+      Value left = Op->getOperand(0);
+      Op->setOperand(0, Op->getOperand(1));
+      Op->setOperand(1, left);
+    }
+    if (canFuseMulAndAddOrSubIntoFMAOp(Op))
+      fuseMulAndAddOrSubIntoFMAOp(Op, state);
+  }
+}
+
 // Assuming commutativity and associativity of add and mul ops, reassociate ops
 // so that code generation becomes feasible/easier.
 static void reassociateOpsInFunc(func::FuncOp func, VectState *state) {
@@ -2410,6 +3569,206 @@ static void reassociateOpsInFunc(func::FuncOp func, VectState *state) {
   reassociateAddOpInFunc(func, state);
 }
 
+// Statistics of one iteration of a vectorized loop, as reported by the
+// vectorizer.
+struct LoopReport {
+  // enclosing function, source location of the loop, and the schemes of its
+  // mul/fma ops as "<lhs type>x<rhs type> <lanes>x<columns>"
+  std::string function, location, scheme;
+  // MACs, mul/fma ops, 256-bit loads and stores, and SRS/UPS conversions
+  int32_t macs = 0, macOps = 0, loads = 0, stores = 0, srs = 0, ups = 0;
+  // maximum number of live 256-bit vector and 384-bit accumulator registers
+  int32_t vectorRegs = 0, accRegs = 0;
+  // estimated cycles, and cycles to issue the MACs at peak throughput
+  int32_t cycles = 0;
+  double peakCycles = 0;
+};
+
+// Return the peak number of MACs per cycle of the AIE vector unit for the
+// given element types of the lhs and rhs operands of a mul/fma op.
+static int32_t getPeakMACsPerCycle(Type ltype, Type rtype) {
+  if (ltype.isBF16())
+    return 16;
+  if (ltype.isa<FloatType>())
+    return 8;
+  int32_t lsize = ltype.getIntOrFloatBitWidth();
+  int32_t rsize = rtype.getIntOrFloatBitWidth();
+  int32_t width = (lsize == 8 && rsize == 8)    ? 128
+                  : (lsize == 16 && rsize == 8) ? 64
+                                                : 32;
+  if (lsize == 32)
+    width /= 2;
+  if (rsize == 32)
+    width /= 2;
+  return width;
+}
+
+// Return the maximum number of 256-bit vector registers and 384-bit
+// accumulator registers live at once in the loop body. The vectors defined
+// outside the body are live throughout it, and the iter_args until their last
+// use.
+static std::pair<int32_t, int32_t> getMaxLiveRegisters(Block *body) {
+  DenseMap<Value, Operation *> lastUse;
+  for (Operation &op : *body)
+    for (Value operand : op.getOperands())
+      if (operand.getType().isa<VectorType>())
+        lastUse[operand] = &op;
+
+  int32_t regs = 0, accs = 0;
+  auto update = [&](Value val, int32_t sign) {
+    VectorType type = val.getType().cast<VectorType>();
+    int32_t bits = getVectorSizeInBits(type);
+    Type eltType = type.getElementType();
+    if (eltType.isInteger(48) || eltType.isInteger(80))
+      accs += sign * (int32_t)llvm::divideCeil(bits, 384);
+    else
+      regs += sign * (int32_t)llvm::divideCeil(bits, 256);
+  };
+  for (auto &it : lastUse)
+    if (it.first.getParentBlock() != body || it.first.isa<BlockArgument>())
+      update(it.first, 1);
+
+  int32_t maxRegs = regs, maxAccs = accs;
+  for (Operation &op : *body) {
+    llvm::SmallDenseSet<Value, 4> dead;
+    for (Value operand : op.getOperands())
+      if (lastUse.lookup(operand) == &op &&
+          operand.getParentBlock() == body && dead.insert(operand).second)
+        update(operand, -1);
+    for (Value result : op.getResults())
+      if (result.getType().isa<VectorType>() && !result.use_empty())
+        update(result, 1);
+    maxRegs = std::max(maxRegs, regs);
+    maxAccs = std::max(maxAccs, accs);
+  }
+  return std::make_pair(maxRegs, maxAccs);
+}
+
+// Collect the statistics of the innermost loop forOp, if it is vectorized.
+// The cycles are estimated with the slot model of the cost model: one vector
+// mul/mac, two 256-bit loads and one 256-bit store issue each cycle.
+static Optional<LoopReport> getLoopReport(scf::ForOp forOp) {
+  LoopReport report;
+  SmallVector<std::string, 2> schemes;
+  for (Operation &op : forOp.getBody()->without_terminator()) {
+    if (isa<aievec::MulOp, aievec::FMAOp>(op)) {
+      Type ltype = getElementTypeOrSelf(op.getOperand(0));
+      Type rtype = getElementTypeOrSelf(op.getOperand(1));
+      int32_t lanes =
+          getVectorLaneSize(op.getResult(0).getType().cast<VectorType>());
+      int32_t peak = getPeakMACsPerCycle(ltype, rtype);
+      // A simple scheme is lane-wise, and only uses one column
+      bool simpleScheme = isa<aievec::MulOp>(op)
+                              ? cast<aievec::MulOp>(op).getStart(0).empty()
+                              : cast<aievec::FMAOp>(op).getStart(0).empty();
+      int32_t cols = simpleScheme ? 1 : std::max(1, peak / lanes);
+      report.macs += lanes * cols;
+      report.peakCycles += (double)(lanes * cols) / peak;
+      ++report.macOps;
+
+      std::string scheme;
+      llvm::raw_string_ostream os(scheme);
+      os << ltype << "x" << rtype << " " << lanes << "x" << cols;
+      if (!llvm::is_contained(schemes, os.str()))
+        schemes.push_back(os.str());
+    } else if (auto updOp = dyn_cast<aievec::UPDOp>(op)) {
+      // A UPD op of a vector wider than 256 bits loads one of its halves
+      int32_t bits = getVectorSizeInBits(
+          updOp.getResult().getType().cast<VectorType>());
+      report.loads += llvm::divideCeil(bits > 256 ? bits / 2 : bits, 256);
+    } else if (auto writeOp = dyn_cast<TransferWriteOp>(op)) {
+      report.stores +=
+          llvm::divideCeil(getVectorSizeInBits(writeOp.getVectorType()), 256);
+    } else if (auto srsOp = dyn_cast<aievec::SRSOp>(op)) {
+      // The float srs/ups ops are no-ops
+      if (!getElementTypeOrSelf(srsOp.getSource()).isa<FloatType>())
+        ++report.srs;
+    } else if (auto upsOp = dyn_cast<aievec::UPSOp>(op)) {
+      if (!getElementTypeOrSelf(upsOp.getSource()).isa<FloatType>())
+        ++report.ups;
+    }
+  }
+  if (!report.macOps)
+    return None;
+
+  report.function = forOp->getParentOfType<func::FuncOp>().getName().str();
+  if (auto fileLoc = forOp.getLoc().dyn_cast<FileLineColLoc>())
+    report.location =
+        llvm::formatv("{0}:{1}:{2}", fileLoc.getFilename().getValue(),
+                      fileLoc.getLine(), fileLoc.getColumn())
+            .str();
+  report.scheme = llvm::join(schemes, ", ");
+  std::tie(report.vectorRegs, report.accRegs) =
+      getMaxLiveRegisters(forOp.getBody());
+  report.cycles = std::max({report.macOps,
+                            (int32_t)llvm::divideCeil(report.loads, 2),
+                            report.stores});
+  return report;
+}
+
+// Report the statistics of each vectorized loop in the module as a remark if
+// emitRemarks is set, and into the JSON file reportFile if it is not empty.
+static LogicalResult reportVectorizedLoops(ModuleOp module, bool emitRemarks,
+                                           StringRef reportFile) {
+  SmallVector<LoopReport, 8> reports;
+  module.walk([&](scf::ForOp forOp) {
+    Optional<LoopReport> report = getLoopReport(forOp);
+    if (!report)
+      return;
+    reports.push_back(*report);
+    if (!emitRemarks)
+      return;
+    int32_t utilization =
+        std::lround(100 * report->peakCycles / report->cycles);
+    forOp.emitRemark() << "vectorized loop with scheme " << report->scheme
+                       << "; per iteration: " << report->macs << " MACs in "
+                       << report->macOps << " mul/mac op(s), " << report->loads
+                       << " UPD load(s), " << report->stores << " store(s), "
+                       << report->srs << " SRS, " << report->ups << " UPS, "
+                       << report->vectorRegs << " live vector register(s), "
+                       << report->accRegs
+                       << " live accumulator(s); estimated cycles: "
+                       << report->cycles << " vs. "
+                       << llvm::formatv("{0:F2}", report->peakCycles)
+                       << " at peak (" << utilization << "% MAC utilization)";
+  });
+  if (reportFile.empty())
+    return success();
+
+  std::error_code ec;
+  llvm::raw_fd_ostream os(reportFile, ec);
+  if (ec)
+    return module.emitError()
+           << "cannot open the vectorizer report file " << reportFile << ": "
+           << ec.message();
+  llvm::json::OStream json(os, 2);
+  json.object([&] {
+    json.attributeArray("loops", [&] {
+      for (LoopReport &report : reports) {
+        json.object([&] {
+          json.attribute("function", report.function);
+          json.attribute("location", report.location);
+          json.attribute("scheme", report.scheme);
+          json.attribute("macs", report.macs);
+          json.attribute("mac_ops", report.macOps);
+          json.attribute("upd_loads", report.loads);
+          json.attribute("stores", report.stores);
+          json.attribute("srs", report.srs);
+          json.attribute("ups", report.ups);
+          json.attribute("live_vector_registers", report.vectorRegs);
+          json.attribute("live_accumulators", report.accRegs);
+          json.attribute("estimated_cycles", report.cycles);
+          json.attribute("peak_cycles", report.peakCycles);
+          json.attribute("mac_utilization",
+                         report.peakCycles / report.cycles);
+        });
+      }
+    });
+  });
+  os << "\n";
+  return success();
+}
+
 struct AIEVectorize : public AIEVectorizeBase<AIEVectorize> {
   AIEVectorize() = default;
   void runOnOperation() override;
@@ -2418,8 +3777,10 @@ struct AIEVectorize : public AIEVectorizeBase<AIEVectorize> {
 /// Generate AIE vector intrinsics for the current module. Assumption: the
 /// input to this function is the mlir output generated after vectorizing the
 /// scalar mlir input with affine superVectorizer. The vectorization factor
-/// should be appropriately set to a power of 2 (e.g., 8 for i32xi32 scheme, 16
-/// for i16xi16 scheme and i8xi8 scheme).
+/// should be appropriately set to a power of 2 (e.g., 8 for i32xi32 and
+/// i32xi16 schemes, 16 for i16xi16, i16xi8, i8xi8, and bf16 schemes). In the
+/// mixed-precision schemes, the narrower operand is widened with an
+/// arith.extsi/extui/extf op before the multiplication.
 void AIEVectorize::runOnOperation() {
   // Verify the bounds of the incoming arguments
   assert(shiftParam < 64 && "SRS shift parameter should be between 0 and 63");
@@ -2436,8 +3797,13 @@ void AIEVectorize::runOnOperation() {
   // Iterate over all the functions in this module, and vectorize them
   for (func::FuncOp func : module.getOps<func::FuncOp>()) {
     // Create a new global state
-    VectState *state =
-        new VectState(func.getContext(), shiftParam, zeroOffset, dupFactor);
+    VectState *state = new VectState(func.getContext(), shiftParam, zeroOffset,
+                                     dupFactor, annotateCost);
+
+    // Split the vectorized loops with unaligned bounds into scalar loops for
+    // the unaligned iterations, and an aligned vectorized loop.
+    if (remainderLoops)
+      peelUnalignedIterationsInFunc(func, state);
 
     // First compute the loops surrounding each load/store operation. This is
     // necessary to identify loads/stores that are nested together.
@@ -2465,6 +3831,10 @@ void AIEVectorize::runOnOperation() {
     // Rewrite vector dialect add and mul operation chains as vector dialect
     // fma operation if feasible.
     rewriteFMAOpsInFunc(func, state);
+    // Join the fma chains combined by add/sub ops, so that their partial sums
+    // stay in the accumulator.
+    if (accReductions)
+      sinkAddOrSubOpsInFunc(func, state);
     // Coalesce vectors that only appear as LHS operands of mul/fma op if their
     // size is <= 256 bits.
     coalesceLHSOpVectorsInFunc(func, state);
@@ -2488,11 +3858,29 @@ void AIEVectorize::runOnOperation() {
     // those ops need to query transfer reads to know if their operand is
     // splat.
     insertUPDOpsInFunc(func, state);
+    // Carry the loop-carried reductions in the accumulator instead of moving
+    // them between vector and accumulator in each iteration.
+    if (accReductions)
+      carryAccumulatorsInFunc(func, state);
+    // Keep the overlap of the sliding windows in registers across the
+    // iterations of the innermost loops, and only load their new part.
+    if (slidingWindowReuse)
+      reuseSlidingWindowInFunc(func, state);
+    // Issue the loads of the innermost loops one iteration ahead of their
+    // mul/mac ops.
+    if (pipelineLoads)
+      pipelineLoadsInFunc(func, state);
   }
 
   // Canonicalize the IR of all the functions in the module by running a set of
   // cleanup passes.
   postCanonicalizeIR(module);
+
+  // Report how well each vectorized loop uses the vector unit. This runs on
+  // the canonicalized IR, once the loop invariant loads are hoisted.
+  if (emitReport || !reportFile.empty())
+    if (failed(reportVectorizedLoops(module, emitReport, reportFile)))
+      signalPassFailure();
 }
 
 std::unique_ptr<Pass> xilinx::aievec::createAIEVectorizePass() {
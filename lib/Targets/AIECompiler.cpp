@@ -0,0 +1,188 @@
+//===- AIECompiler.cpp ------------------------------------------*- C++ -*-===//
+//
+// This file is licensed under the Apache License v2.0 with LLVM Exceptions.
+// See https://llvm.org/LICENSE.txt for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+//
+// (c) Copyright 2022 Xilinx Inc.
+//
+//===----------------------------------------------------------------------===//
+
+#include "aie/AIECompiler.h"
+#include "AIETargets.h"
+
+#include "aie/AIEDialect.h"
+
+#include "mlir/IR/Threading.h"
+#include "mlir/Parser/Parser.h"
+#include "mlir/Pass/PassManager.h"
+#include "mlir/Pass/PassRegistry.h"
+#include "mlir/Support/FileUtilities.h"
+#include "mlir/Target/LLVMIR/Dialect/LLVMIR/LLVMToLLVMIRTranslation.h"
+#include "mlir/Target/LLVMIR/Export.h"
+
+#include "llvm/IR/LLVMContext.h"
+#include "llvm/IR/Module.h"
+#include "llvm/Support/FileSystem.h"
+#include "llvm/Support/FormatVariadic.h"
+#include "llvm/Support/Path.h"
+#include "llvm/Support/ToolOutputFile.h"
+
+using namespace mlir;
+using namespace xilinx;
+using namespace xilinx::AIE;
+
+// The pipelines below are the ones run by aiecc.
+
+// Lower the logical design to its physical form.
+static const char *physicalPipeline =
+    "aie-create-locks,lower-affine,aie-register-objectFifos,"
+    "aie-unroll-objectFifos,aie-objectFifo-stateful-transform,"
+    "aie-route-traces,aie-lower-broadcast-packet,aie-create-packet-flows,"
+    "aie-assign-buffer-addresses,convert-scf-to-cf";
+
+// Route the flows for the host interface, {0} is the router.
+static const char *routingPipeline =
+    "{0},aie-lower-broadcast-packet,aie-create-packet-flows";
+
+// Lower the cores to the LLVM dialect, and write each of them to
+// {0}/core_<col>_<row>.mlir.  aie-standard-lowering lowers the cores in
+// parallel, and checks their size against the program memory budget {1}.
+static const char *corePipeline =
+    "aie-localize-locks,"
+    "aie-standard-lowering{{output-dir={0} core-pipeline={{"
+    "aie-normalize-address-spaces,aievec-standard-lowering,canonicalize,cse,"
+    "convert-vector-to-llvm,convert-memref-to-llvm,"
+    "convert-func-to-llvm{{use-bare-ptr-memref-call-conv=1},"
+    "convert-cf-to-llvm,canonicalize,cse,"
+    "aie-estimate-code-size{{budget={1}}}}";
+
+static LogicalResult runPipeline(ModuleOp module, StringRef pipeline,
+                                 const AIECompilerOptions &options) {
+  if (options.verbose)
+    llvm::errs() << "pipeline: " << pipeline << "\n";
+  PassManager pm(module.getContext());
+  if (failed(parsePassPipeline(pipeline, pm, llvm::errs())))
+    return module.emitError("invalid pipeline: ") << pipeline;
+  return pm.run(module);
+}
+
+static LogicalResult writeFile(ModuleOp module, StringRef dir, StringRef name,
+                               function_ref<void(raw_ostream &)> write) {
+  SmallString<128> path(dir);
+  llvm::sys::path::append(path, name);
+  std::string errorMessage;
+  auto output = openOutputFile(path, &errorMessage);
+  if (!output)
+    return module.emitError(errorMessage);
+  write(output->os());
+  output->keep();
+  return success();
+}
+
+// Generate the host interface in aie_inc.cpp.
+static LogicalResult compileHost(ModuleOp physical,
+                                 const AIECompilerOptions &options) {
+  LogicalResult result = success();
+  if (failed(writeFile(physical, options.tmpDir, "aie_inc.cpp",
+                       [&](raw_ostream &os) {
+                         result = options.xaieTarget == 1
+                                      ? AIETranslateToXAIEV1(physical, os)
+                                      : AIETranslateToXAIEV2(physical, os);
+                       })))
+    return failure();
+  return result;
+}
+
+// Translate the given core, lowered in core_<col>_<row>.mlir, to LLVM IR in
+// core_<col>_<row>.ll.
+static LogicalResult compileCore(ModuleOp module, const AIECoreInfo &core,
+                                 const AIECompilerOptions &options) {
+  SmallString<128> path(options.tmpDir);
+  llvm::sys::path::append(
+      path, llvm::formatv("core_{0}_{1}.mlir", core.col, core.row).str());
+  OwningOpRef<ModuleOp> coreModule =
+      parseSourceFile<ModuleOp>(path, module.getContext());
+  if (!coreModule)
+    return failure();
+
+  // Each core gets its own LLVMContext, so that they can be translated in
+  // parallel.
+  llvm::LLVMContext llvmContext;
+  llvmContext.setOpaquePointers(false);
+  auto llvmModule = translateModuleToLLVMIR(*coreModule, llvmContext);
+  if (!llvmModule)
+    return coreModule->emitError("failed to translate core (")
+           << core.col << ", " << core.row << ") to LLVM IR";
+  return writeFile(
+      module, options.tmpDir,
+      llvm::formatv("core_{0}_{1}.ll", core.col, core.row).str(),
+      [&](raw_ostream &os) { llvmModule->print(os, nullptr); });
+}
+
+LogicalResult
+xilinx::AIE::compileAIEModule(ModuleOp module,
+                              const AIECompilerOptions &options,
+                              SmallVectorImpl<AIECoreInfo> &cores) {
+  MLIRContext *context = module.getContext();
+  // The directory is passed as the value of a pass option, which ends at a
+  // space and cannot hold unbalanced braces.
+  if (StringRef(options.tmpDir).find_first_of(" {}") != StringRef::npos)
+    return module.emitError("the temporary directory ")
+           << options.tmpDir << " cannot contain spaces or braces";
+  if (auto ec = llvm::sys::fs::create_directories(options.tmpDir))
+    return module.emitError("cannot create ")
+           << options.tmpDir << ": " << ec.message();
+
+  if (failed(runPipeline(module, physicalPipeline, options)) ||
+      failed(writeFile(module, options.tmpDir, "input_with_addresses.mlir",
+                       [&](raw_ostream &os) { module.print(os); })) ||
+      failed(writeCoreLinkerFiles(module, options.tmpDir, llvm::nulls())))
+    return failure();
+
+  size_t firstCore = cores.size();
+  for (auto tile : module.getOps<TileOp>())
+    if (auto core = tile.getCoreOp()) {
+      std::string elfFile;
+      if (auto fileAttr = core->getAttrOfType<StringAttr>("elf_file"))
+        elfFile = fileAttr.getValue().str();
+      cores.push_back({tile.colIndex(), tile.rowIndex(), elfFile});
+    }
+
+  // The pipelines are run before the threaded region below, since a pass
+  // manager cannot run in it: the host interface is routed in a copy of the
+  // module, and the cores are lowered in parallel by aie-standard-lowering in
+  // another.
+  OwningOpRef<ModuleOp> physical(module.clone());
+  std::string pipeline = llvm::formatv(
+      routingPipeline, options.pathfinder ? "aie-create-pathfinder-flows"
+                                          : "aie-create-flows");
+  if (failed(runPipeline(*physical, pipeline, options)) ||
+      failed(writeFile(*physical, options.tmpDir, "input_physical.mlir",
+                       [&](raw_ostream &os) { physical->print(os); })))
+    return failure();
+
+  OwningOpRef<ModuleOp> lowered(module.clone());
+  pipeline =
+      llvm::formatv(corePipeline, options.tmpDir, options.codeSizeBudget).str();
+  if (failed(runPipeline(*lowered, pipeline, options)))
+    return failure();
+
+  // Dialects cannot be loaded once the cores are processed in parallel, so
+  // load those of the LLVM IR translation now.
+  DialectRegistry registry;
+  registerLLVMDialectTranslation(registry);
+  context->appendDialectRegistry(registry);
+  context->loadAllAvailableDialects();
+
+  // The host interface is generated alongside the translation of the cores.
+  SmallVector<int, 16> tasks;
+  tasks.push_back(-1);
+  for (size_t i = firstCore; i < cores.size(); ++i)
+    tasks.push_back(i);
+  return failableParallelForEach(context, tasks, [&](int task) {
+    if (task < 0)
+      return compileHost(*physical, options);
+    return compileCore(module, cores[task], options);
+  });
+}
@@ -0,0 +1,117 @@
+//===- AIEDependencies.cpp --------------------------------------*- C++ -*-===//
+//
+// This file is licensed under the Apache License v2.0 with LLVM Exceptions.
+// See https://llvm.org/LICENSE.txt for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+//
+// (c) Copyright 2022 Xilinx Inc.
+//
+//===----------------------------------------------------------------------===//
+
+/*
+ * Takes as input the mlir after AIEAssignBufferAddresses, and prints, for
+ * each artifact built by aiecc, a hash of the parts of the design it depends
+ * on, so that aiecc only rebuilds the artifacts whose hash changed:
+ *
+ * - aie_inc.cpp depends on everything but the bodies of the cores.
+ * - The ELF of a core depends on its body, on the buffers and locks in the
+ *   memories it can access, and on the functions of the module it may call.
+ */
+
+#include "mlir/Dialect/Func/IR/FuncOps.h"
+#include "mlir/Dialect/MemRef/IR/MemRef.h"
+#include "mlir/IR/AsmState.h"
+#include "mlir/IR/Attributes.h"
+
+#include "llvm/ADT/StringExtras.h"
+#include "llvm/Support/JSON.h"
+#include "llvm/Support/SHA1.h"
+
+#include "aie/AIEDialect.h"
+
+#include "AIETargets.h"
+
+using namespace mlir;
+using namespace xilinx;
+using namespace xilinx::AIE;
+
+namespace xilinx {
+namespace AIE {
+
+static std::string hashOps(ArrayRef<Operation *> ops, AsmState &state) {
+  std::string text;
+  llvm::raw_string_ostream os(text);
+  for (Operation *op : ops) {
+    op->print(os, state);
+    os << "\n";
+  }
+  llvm::SHA1 sha;
+  sha.update(os.str());
+  return llvm::toHex(sha.final(), /*LowerCase=*/true);
+}
+
+LogicalResult AIEGenerateDependencies(ModuleOp module, raw_ostream &output) {
+  AsmState state(module);
+
+  // Everything but the cores, which are replaced by their tile and
+  // attributes.
+  SmallVector<Operation *, 64> hostOps;
+  std::string coreSummary;
+  llvm::raw_string_ostream coreSummaryOS(coreSummary);
+  DenseMap<TileID, SmallVector<Operation *, 8>> memoryOps;
+  SmallVector<Operation *, 16> functionOps;
+  for (Operation &op : module.getBody()->without_terminator()) {
+    if (auto core = dyn_cast<CoreOp>(op)) {
+      coreSummaryOS << "core(" << core.colIndex() << ", " << core.rowIndex()
+                    << ") " << core->getAttrDictionary() << "\n";
+      continue;
+    }
+    hostOps.push_back(&op);
+    if (auto buffer = dyn_cast<BufferOp>(op))
+      memoryOps[{buffer.getTileOp().colIndex(),
+                 buffer.getTileOp().rowIndex()}]
+          .push_back(&op);
+    else if (auto lock = dyn_cast<LockOp>(op))
+      if (auto tile = lock.getTile().getDefiningOp<TileOp>())
+        memoryOps[{tile.colIndex(), tile.rowIndex()}].push_back(&op);
+    if (isa<func::FuncOp, memref::GlobalOp>(op))
+      functionOps.push_back(&op);
+  }
+
+  llvm::SHA1 hostSha;
+  hostSha.update(hashOps(hostOps, state));
+  hostSha.update(coreSummaryOS.str());
+
+  llvm::json::OStream json(output, 2);
+  json.object([&] {
+    json.attribute("aie_inc.cpp",
+                   llvm::toHex(hostSha.final(), /*LowerCase=*/true));
+    json.attributeObject("cores", [&] {
+      for (auto core : module.getOps<CoreOp>()) {
+        TileID coord = {core.colIndex(), core.rowIndex()};
+        SmallVector<Operation *, 32> ops = {core.getTileOp(), core};
+        for (auto tile : {getMemSouth(coord), getMemWest(coord),
+                          getMemNorth(coord), getMemEast(coord)})
+          if (tile && memoryOps.count(*tile))
+            ops.append(memoryOps[*tile]);
+        ops.append(functionOps);
+
+        std::string name = "core_" + std::to_string(coord.first) + "_" +
+                           std::to_string(coord.second);
+        json.attributeObject(name, [&] {
+          json.attribute("hash", hashOps(ops, state));
+          // Files linked into the core, whose contents are hashed by aiecc.
+          json.attributeArray("files", [&] {
+            if (auto fileAttr = core->getAttrOfType<StringAttr>("link_with"))
+              json.value(fileAttr.getValue());
+          });
+        });
+      }
+    });
+  });
+  output << "\n";
+  return success();
+}
+
+} // namespace AIE
+} // namespace xilinx
@@ -28,6 +28,9 @@
 
 #include "AIETargets.h"
 
+#include <map>
+#include <set>
+
 using namespace mlir;
 using namespace xilinx;
 using namespace xilinx::AIE;
@@ -113,41 +116,79 @@ mlir::LogicalResult AIETranslateToXAIEV2(ModuleOp module, raw_ostream &output) {
   NL.collectTiles(tiles);
   NL.collectBuffers(buffers);
 
+  // Columns are configured independently of each other, so each phase of the
+  // configuration (cores, tile DMAs, switchboxes) is emitted as one function
+  // per column.  The serial entry points, which are the default, call them in
+  // column order.  The *_parallel entry points hand them to the runtime to run
+  // concurrently, which callers have to opt into since libxaie does not
+  // promise a device instance to be thread-safe.
+  auto outputColumnDispatch = [&](StringRef phase,
+                                  const std::set<int> &columns,
+                                  StringRef prologue = "") {
+    output << "void mlir_aie_" << phase << "(" << ctx_p << ") {\n";
+    output << prologue;
+    for (int col : columns)
+      output << "mlir_aie_" << phase << "_column_" << col << "(ctx);\n";
+    output << "} // mlir_aie_" << phase << "\n\n";
+
+    output << "void mlir_aie_" << phase << "_parallel(" << ctx_p
+           << ", int nthreads) {\n";
+    output << prologue;
+    if (columns.empty()) {
+      output << "(void)nthreads;\n";
+    } else {
+      output << "static const mlir_aie_column_fn_t columns[] = {\n";
+      for (int col : columns)
+        output << "  mlir_aie_" << phase << "_column_" << col << ",\n";
+      output << "};\n";
+      output << "mlir_aie_configure_columns(ctx, columns, " << columns.size()
+             << ", nthreads);\n";
+    }
+    output << "} // mlir_aie_" << phase << "_parallel\n\n";
+  };
+
   //---------------------------------------------------------------------------
   // mlir_aie_configure_cores
   //---------------------------------------------------------------------------
-  output << "void mlir_aie_configure_cores(" << ctx_p << ") {\n";
-  // Reset each core.  Load the corresponding ELF file, if necessary.
-  for (auto tileOp : module.getOps<TileOp>()) {
-    int col = tileOp.colIndex();
-    int row = tileOp.rowIndex();
-    if (tileOp.isShimTile()) {
-      // Resets no needed with V2 kernel driver
-    } else {
-      // Resets no needed with V2 kernel driver
-      if (auto coreOp = tileOp.getCoreOp()) {
-        std::string fileName;
-        if (auto fileAttr = coreOp->getAttrOfType<StringAttr>("elf_file")) {
-          fileName = std::string(fileAttr.getValue());
-        } else {
-          fileName = std::string("core_") + std::to_string(col) + "_" +
-                     std::to_string(row) + ".elf";
-        }
-        output << "{\n"
-               << "AieRC RC = XAie_LoadElf(" << deviceInstRef << ", "
-               << tileLocStr(col, row) << ", "
-               << "(const char*)\"" << fileName << "\",0);\n";
-        output << "if (RC != XAIE_OK)\n"
-               << "    printf(\"Failed to load elf for Core[%d,%d], ret is "
-                  "%d\\n\", "
-               << std::to_string(col) << ", " << std::to_string(row)
-               << ", RC);\n"
-               << "assert(RC == XAIE_OK);\n"
-               << "}\n";
+  // Resets no needed with V2 kernel driver
+  std::map<int, SmallVector<TileOp, 8>> coreColumns;
+  for (auto tileOp : module.getOps<TileOp>())
+    if (!tileOp.isShimTile() && tileOp.getCoreOp())
+      coreColumns[tileOp.colIndex()].push_back(tileOp);
+
+  std::set<int> coreColumnIds;
+  for (auto &column : coreColumns) {
+    int col = column.first;
+    coreColumnIds.insert(col);
+    output << "void mlir_aie_configure_cores_column_" << col << "(" << ctx_p
+           << ") {\n";
+    // Load the corresponding ELF file for each core in this column.  The
+    // runtime caches ELF images by file name, so a kernel shared by many cores
+    // is only read once.
+    for (auto tileOp : column.second) {
+      int row = tileOp.rowIndex();
+      auto coreOp = tileOp.getCoreOp();
+      std::string fileName;
+      if (auto fileAttr = coreOp->getAttrOfType<StringAttr>("elf_file")) {
+        fileName = std::string(fileAttr.getValue());
+      } else {
+        fileName = std::string("core_") + std::to_string(col) + "_" +
+                   std::to_string(row) + ".elf";
       }
+      output << "{\n"
+             << "AieRC RC = mlir_aie_load_elf(ctx, " << col << ", " << row
+             << ", (const char*)\"" << fileName << "\");\n";
+      output << "if (RC != XAIE_OK)\n"
+             << "    printf(\"Failed to load elf for Core[%d,%d], ret is "
+                "%d\\n\", "
+             << std::to_string(col) << ", " << std::to_string(row)
+             << ", RC);\n"
+             << "assert(RC == XAIE_OK);\n"
+             << "}\n";
     }
+    output << "} // mlir_aie_configure_cores_column_" << col << "\n\n";
   }
-  output << "} // mlir_aie_configure_cores\n\n";
+  outputColumnDispatch("configure_cores", coreColumnIds);
 
   //---------------------------------------------------------------------------
   // mlir_aie_start_cores
@@ -169,8 +210,6 @@ mlir::LogicalResult AIETranslateToXAIEV2(ModuleOp module, raw_ostream &output) {
   //---------------------------------------------------------------------------
   // mlir_aie_configure_dmas
   //---------------------------------------------------------------------------
-  output << "void mlir_aie_configure_dmas(" << ctx_p << ") {\n";
-
   // DMA configuration
   // AieRC XAie_DmaDescInit(XAie_DevInst *DevInst, XAie_DmaDesc *DmaDesc,
   // XAie_LocType Loc); AieRC XAie_DmaSetLock(XAie_DmaDesc *DmaDesc, XAie_Lock
@@ -203,162 +242,174 @@ mlir::LogicalResult AIETranslateToXAIEV2(ModuleOp module, raw_ostream &output) {
   // XAie_DmaChannelEnable(XAie_DevInst *DevInst, XAie_LocType Loc, u8 ChNum,
   // XAie_DmaDirection Dir); AieRC XAie_DmaChannelDisable(XAie_DevInst *DevInst,
   // XAie_LocType Loc, u8 ChNum, XAie_DmaDirection Dir);
-  for (auto memOp : module.getOps<MemOp>()) {
-    int col = memOp.colIndex();
-    int row = memOp.rowIndex();
-    // Reset not needed with V2 kernel driver
-
-    DenseMap<Block *, int> blockMap;
-
-    {
-      // Assign each block a BD number
-      int bdNum = 0;
-      for (auto &block : memOp.getBody()) {
-        if (!block.getOps<DMABDOp>().empty()) {
-          blockMap[&block] = bdNum;
-          bdNum++;
+  std::map<int, SmallVector<MemOp, 8>> memColumns;
+  for (auto memOp : module.getOps<MemOp>())
+    memColumns[memOp.colIndex()].push_back(memOp);
+
+  std::set<int> memColumnIds;
+  for (auto &column : memColumns) {
+    memColumnIds.insert(column.first);
+    output << "void mlir_aie_configure_dmas_column_" << column.first << "("
+           << ctx_p << ") {\n";
+    for (auto memOp : column.second) {
+      int col = memOp.colIndex();
+      int row = memOp.rowIndex();
+      // Reset not needed with V2 kernel driver
+
+      DenseMap<Block *, int> blockMap;
+
+      {
+        // Assign each block a BD number
+        int bdNum = 0;
+        for (auto &block : memOp.getBody()) {
+          if (!block.getOps<DMABDOp>().empty()) {
+            blockMap[&block] = bdNum;
+            bdNum++;
+          }
         }
       }
-    }
-    for (auto &block : memOp.getBody()) {
-      bool foundBdPacket = false;
-      int packetType = 0;
-      int packetID = 0;
-      bool foundBd = false;
-      int lenA = 0;
-      int lenB = 0;
-      int bytesA = 0;
-      int bytesB = 0;
-      int offsetA = 0;
-      int offsetB = 0;
-      int BaseAddrA = 0;
-      int BaseAddrB = 0;
-      bool hasA = false;
-      bool hasB = false;
-      StringRef bufA = "0";
-      StringRef bufB = "0";
-      StringRef AbMode = disable;
-      //      StringRef FifoMode = disable; // FIXME: when to enable FIFO mode?
-      for (auto op : block.getOps<DMABDOp>()) {
-        foundBd = true;
-        ShapedType bufferType =
-            op.getBuffer().getType().cast<::mlir::MemRefType>();
-        if (op.isA()) {
-          BaseAddrA = NL.getBufferBaseAddress(op.getBuffer().getDefiningOp());
-          lenA = op.getLenValue();
-          bytesA = bufferType.getElementTypeBitWidth() / 8;
-          offsetA = op.getOffsetValue();
-          bufA = "XAIEDMA_TILE_BD_ADDRA";
-          hasA = true;
-        }
-        if (op.isB()) {
-          BaseAddrB = NL.getBufferBaseAddress(op.getBuffer().getDefiningOp());
-          lenB = op.getLenValue();
-          bytesB = bufferType.getElementTypeBitWidth() / 8;
-          offsetB = op.getOffsetValue();
-          bufB = "XAIEDMA_TILE_BD_ADDRB";
-          hasB = true;
+      for (auto &block : memOp.getBody()) {
+        bool foundBdPacket = false;
+        int packetType = 0;
+        int packetID = 0;
+        bool foundBd = false;
+        int lenA = 0;
+        int lenB = 0;
+        int bytesA = 0;
+        int bytesB = 0;
+        int offsetA = 0;
+        int offsetB = 0;
+        int BaseAddrA = 0;
+        int BaseAddrB = 0;
+        bool hasA = false;
+        bool hasB = false;
+        StringRef bufA = "0";
+        StringRef bufB = "0";
+        StringRef AbMode = disable;
+        // StringRef FifoMode = disable; // FIXME: when to enable FIFO mode?
+        for (auto op : block.getOps<DMABDOp>()) {
+          foundBd = true;
+          ShapedType bufferType =
+              op.getBuffer().getType().cast<::mlir::MemRefType>();
+          if (op.isA()) {
+            BaseAddrA = NL.getBufferBaseAddress(op.getBuffer().getDefiningOp());
+            lenA = op.getLenValue();
+            bytesA = bufferType.getElementTypeBitWidth() / 8;
+            offsetA = op.getOffsetValue();
+            bufA = "XAIEDMA_TILE_BD_ADDRA";
+            hasA = true;
+          }
+          if (op.isB()) {
+            BaseAddrB = NL.getBufferBaseAddress(op.getBuffer().getDefiningOp());
+            lenB = op.getLenValue();
+            bytesB = bufferType.getElementTypeBitWidth() / 8;
+            offsetB = op.getOffsetValue();
+            bufB = "XAIEDMA_TILE_BD_ADDRB";
+            hasB = true;
+          }
         }
-      }
 
-      if (hasA && hasB) {
-        AbMode = enable;
-        if (lenA != lenB)
-          llvm::errs() << "ABmode must have matching lengths.\n";
-        if (bytesA != bytesB)
-          llvm::errs() << "ABmode must have matching element data types.\n";
-      }
-      int acqValue = 0, relValue = 0;
-      StringRef acqEnable = disable;
-      StringRef relEnable = disable;
-      int lockID;
-      for (auto op : block.getOps<UseLockOp>()) {
-        LockOp lock = dyn_cast<LockOp>(op.getLock().getDefiningOp());
-        lockID = lock.getLockIDValue();
-        if (op.acquire()) {
-          acqEnable = enable;
-          acqValue = op.getLockValue();
-        } else if (op.release()) {
-          relEnable = enable;
-          relValue = op.getLockValue();
+        if (hasA && hasB) {
+          AbMode = enable;
+          if (lenA != lenB)
+            llvm::errs() << "ABmode must have matching lengths.\n";
+          if (bytesA != bytesB)
+            llvm::errs() << "ABmode must have matching element data types.\n";
+        }
+        int acqValue = 0, relValue = 0;
+        StringRef acqEnable = disable;
+        StringRef relEnable = disable;
+        int lockID;
+        for (auto op : block.getOps<UseLockOp>()) {
+          LockOp lock = dyn_cast<LockOp>(op.getLock().getDefiningOp());
+          lockID = lock.getLockIDValue();
+          if (op.acquire()) {
+            acqEnable = enable;
+            acqValue = op.getLockValue();
+          } else if (op.release()) {
+            relEnable = enable;
+            relValue = op.getLockValue();
+          }
         }
-      }
-
-      for (auto op : block.getOps<DMABDPACKETOp>()) {
-        foundBdPacket = true;
-        packetType = op.getPacketType();
-        packetID = op.getPacketID();
-      }
-
-      int bdNum = blockMap[&block];
-      if (foundBd) {
-        // TODO AB mode separated
 
-        // TODO For now, we are going to name each dma desc with loc and bd
-        // which we assume is unique. This is strictly not enforced but in
-        // practice, this is true
-        output << "XAie_DmaDesc " << tileDMAInstStr(col, row, bdNum) << ";\n";
-        output << "XAie_DmaDescInit(" << deviceInstRef << ", "
-               << tileDMAInstRefStr(col, row, bdNum) << ", "
-               << tileLocStr(col, row) << ");\n";
-        output << "XAie_DmaSetLock(" << tileDMAInstRefStr(col, row, bdNum)
-               << ", "
-               << "XAie_LockInit(" << lockID << "," << acqValue << "),"
-               << "XAie_LockInit(" << lockID << "," << relValue << "));\n";
-        output << "XAie_DmaSetAddrLen(" << tileDMAInstRefStr(col, row, bdNum)
-               << ", "
-               << " /* addrA */ "
-               << "0x" << llvm::utohexstr(BaseAddrA + offsetA) << ", "
-               << " /* len */ " << lenA << " * " << bytesA << ");\n";
+        for (auto op : block.getOps<DMABDPACKETOp>()) {
+          foundBdPacket = true;
+          packetType = op.getPacketType();
+          packetID = op.getPacketID();
+        }
 
-        if (block.getNumSuccessors() > 0) {
-          Block *nextBlock = block.getSuccessors()[0]; // should have only one
-                                                       // successor block
-          int nextBdNum = blockMap[nextBlock];
-          output << "XAie_DmaSetNextBd(" << tileDMAInstRefStr(col, row, bdNum)
+        int bdNum = blockMap[&block];
+        if (foundBd) {
+          // TODO AB mode separated
+
+          // TODO For now, we are going to name each dma desc with loc and bd
+          // which we assume is unique. This is strictly not enforced but in
+          // practice, this is true
+          output << "XAie_DmaDesc " << tileDMAInstStr(col, row, bdNum) << ";\n";
+          output << "XAie_DmaDescInit(" << deviceInstRef << ", "
+                 << tileDMAInstRefStr(col, row, bdNum) << ", "
+                 << tileLocStr(col, row) << ");\n";
+          output << "XAie_DmaSetLock(" << tileDMAInstRefStr(col, row, bdNum)
                  << ", "
-                 << " /* nextbd */ " << nextBdNum << ", "
-                 << " /* enableNextBd */ 1);\n"; // TODO Check if br ^end: to
-                                                 // disable this?
-        }
-        if (foundBdPacket) {
-          output << "XAie_DmaSetPkt(" << tileDMAInstRefStr(col, row, bdNum)
-                 << ", " << packetStr(packetID, packetType) << ");\n";
+                 << "XAie_LockInit(" << lockID << "," << acqValue << "),"
+                 << "XAie_LockInit(" << lockID << "," << relValue << "));\n";
+          output << "XAie_DmaSetAddrLen(" << tileDMAInstRefStr(col, row, bdNum)
+                 << ", "
+                 << " /* addrA */ "
+                 << "0x" << llvm::utohexstr(BaseAddrA + offsetA) << ", "
+                 << " /* len */ " << lenA << " * " << bytesA << ");\n";
+
+          if (block.getNumSuccessors() > 0) {
+            Block *nextBlock = block.getSuccessors()[0]; // should have only one
+                                                         // successor block
+            int nextBdNum = blockMap[nextBlock];
+            output << "XAie_DmaSetNextBd(" << tileDMAInstRefStr(col, row, bdNum)
+                   << ", "
+                   << " /* nextbd */ " << nextBdNum << ", "
+                   << " /* enableNextBd */ 1);\n"; // TODO Check if br ^end: to
+                                                   // disable this?
+          }
+          if (foundBdPacket) {
+            output << "XAie_DmaSetPkt(" << tileDMAInstRefStr(col, row, bdNum)
+                   << ", " << packetStr(packetID, packetType) << ");\n";
+          }
+          output << "XAie_DmaEnableBd(" << tileDMAInstRefStr(col, row, bdNum)
+                 << ");\n";
+          output << "XAie_DmaWriteBd(" << deviceInstRef << ", "
+                 << tileDMAInstRefStr(col, row, bdNum) << ", "
+                 << tileLocStr(col, row) << ", "
+                 << " /* bd */ " << bdNum << ");\n";
         }
-        output << "XAie_DmaEnableBd(" << tileDMAInstRefStr(col, row, bdNum)
-               << ");\n";
-        output << "XAie_DmaWriteBd(" << deviceInstRef << ", "
-               << tileDMAInstRefStr(col, row, bdNum) << ", "
-               << tileLocStr(col, row) << ", "
-               << " /* bd */ " << bdNum << ");\n";
       }
-    }
 
-    for (auto &block : memOp.getBody()) {
-      for (auto op : block.getOps<DMAStartOp>()) {
-        int bdNum = blockMap[op.getDest()];
+      for (auto &block : memOp.getBody()) {
+        for (auto op : block.getOps<DMAStartOp>()) {
+          int bdNum = blockMap[op.getDest()];
 
-        llvm::StringRef dmaChan = stringifyDMAChan(op.getDmaChan());
-        llvm::StringRef dmaDir = dmaChan.substr(0, 4);
-        llvm::StringRef chNum = dmaChan.substr(4, 1);
+          llvm::StringRef dmaChan = stringifyDMAChan(op.getDmaChan());
+          llvm::StringRef dmaDir = dmaChan.substr(0, 4);
+          llvm::StringRef chNum = dmaChan.substr(4, 1);
 
-        output << "XAie_DmaChannelPushBdToQueue(" << deviceInstRef << ", "
-               << tileLocStr(col, row) << ", "
-               << "/* ChNum */" << chNum
-               << ", "
-               // TODO hack until physical dialect changes
-               << "/* dmaDir */ DMA_" << dmaDir << ", "
-               << "/* BdNum */" << bdNum << ");\n";
-        output << "XAie_DmaChannelEnable(" << deviceInstRef << ", "
-               << tileLocStr(col, row) << ", "
-               << "/* ChNum */ " << chNum
-               << ", "
-               // TODO hack until physical dialect changes
-               << "/* dmaDir */ DMA_" << dmaDir << ");\n";
+          output << "XAie_DmaChannelPushBdToQueue(" << deviceInstRef << ", "
+                 << tileLocStr(col, row) << ", "
+                 << "/* ChNum */" << chNum
+                 << ", "
+                 // TODO hack until physical dialect changes
+                 << "/* dmaDir */ DMA_" << dmaDir << ", "
+                 << "/* BdNum */" << bdNum << ");\n";
+          output << "XAie_DmaChannelEnable(" << deviceInstRef << ", "
+                 << tileLocStr(col, row) << ", "
+                 << "/* ChNum */ " << chNum
+                 << ", "
+                 // TODO hack until physical dialect changes
+                 << "/* dmaDir */ DMA_" << dmaDir << ");\n";
+        }
       }
     }
+    output << "} // mlir_aie_configure_dmas_column_" << column.first
+           << "\n\n";
   }
-  output << "} // mlir_aie_configure_dmas\n\n";
+  outputColumnDispatch("configure_dmas", memColumnIds);
 
   // ShimDMA Config
   //  int index = 0;
@@ -399,6 +450,13 @@ mlir::LogicalResult AIETranslateToXAIEV2(ModuleOp module, raw_ostream &output) {
                  << "_" << bdNum << ";\n"
                  << "}\n";
 
+          // Bind a buffer from the runtime's host buffer pool.
+          output << "void mlir_aie_external_set_buffer_myBuffer_" << col
+                 << row << "_" << bdNum << "(mlir_aie_host_buffer_t *buf) {\n"
+                 << "    _mlir_aie_external_myBuffer_" << col << row << "_"
+                 << bdNum << " = buf->devaddr;\n"
+                 << "}\n";
+
           bdNum++;
         }
       }
@@ -557,11 +615,8 @@ mlir::LogicalResult AIETranslateToXAIEV2(ModuleOp module, raw_ostream &output) {
   //---------------------------------------------------------------------------
   // mlir_aie_configure_switchboxes
   //---------------------------------------------------------------------------
-  output << "void mlir_aie_configure_switchboxes(" << ctx_p << ") {\n";
-  output << "  int x, y;\n";
-
   // StreamSwitch (switchbox) configuration
-  for (auto switchboxOp : module.getOps<SwitchboxOp>()) {
+  auto outputSwitchbox = [&](SwitchboxOp switchboxOp) {
     Region &r = switchboxOp.getConnections();
     Block &b = r.front();
     bool isEmpty = b.getOps<ConnectOp>().empty() &&
@@ -672,8 +727,8 @@ mlir::LogicalResult AIETranslateToXAIEV2(ModuleOp module, raw_ostream &output) {
       output << "}\n";
       output << "}\n";
     }
-  }
-  for (auto op : module.getOps<ShimMuxOp>()) {
+  };
+  auto outputShimMux = [&](ShimMuxOp op) {
     Region &r = op.getConnections();
     Block &b = r.front();
     bool isEmpty = b.getOps<ConnectOp>().empty();
@@ -712,8 +767,8 @@ mlir::LogicalResult AIETranslateToXAIEV2(ModuleOp module, raw_ostream &output) {
             << connectOp.destIndex() << ");\n";
       }
     }
-  }
-  for (auto switchboxOp : module.getOps<ShimSwitchboxOp>()) {
+  };
+  auto outputShimSwitchbox = [&](ShimSwitchboxOp switchboxOp) {
     Region &r = switchboxOp.getConnections();
     Block &b = r.front();
     bool isEmpty = b.getOps<ConnectOp>().empty();
@@ -729,9 +784,82 @@ mlir::LogicalResult AIETranslateToXAIEV2(ModuleOp module, raw_ostream &output) {
              << stringifyWireBundle(connectOp.getDestBundle()).upper() << ", "
              << connectOp.destIndex() << ");\n";
     }
+  };
+
+  // Switchboxes parameterized over a herd may span several columns, so they
+  // are configured up front, before the per-column functions run.
+  SmallVector<SwitchboxOp, 4> herdSwitchboxes;
+  std::map<int, SmallVector<Operation *, 8>> switchboxColumns;
+  for (auto switchboxOp : module.getOps<SwitchboxOp>()) {
+    if (isa<TileOp>(switchboxOp.getTile().getDefiningOp()))
+      switchboxColumns[switchboxOp.colIndex()].push_back(switchboxOp);
+    else
+      herdSwitchboxes.push_back(switchboxOp);
+  }
+  for (auto op : module.getOps<ShimMuxOp>())
+    switchboxColumns[op.colIndex()].push_back(op);
+  for (auto op : module.getOps<ShimSwitchboxOp>())
+    switchboxColumns[op.getCol()].push_back(op);
+
+  std::string herdPrologue;
+  if (!herdSwitchboxes.empty()) {
+    herdPrologue = "mlir_aie_configure_switchboxes_herds(ctx);\n";
+    output << "static void mlir_aie_configure_switchboxes_herds(" << ctx_p
+           << ") {\n";
+    output << "  int x, y;\n";
+    for (auto switchboxOp : herdSwitchboxes)
+      outputSwitchbox(switchboxOp);
+    output << "} // mlir_aie_configure_switchboxes_herds\n\n";
   }
 
-  output << "} // mlir_aie_configure_switchboxes\n\n";
+  std::set<int> switchboxColumnIds;
+  for (auto &column : switchboxColumns) {
+    switchboxColumnIds.insert(column.first);
+    output << "void mlir_aie_configure_switchboxes_column_" << column.first
+           << "(" << ctx_p << ") {\n";
+    output << "  int x, y;\n";
+    for (Operation *op : column.second) {
+      if (auto switchboxOp = dyn_cast<SwitchboxOp>(op))
+        outputSwitchbox(switchboxOp);
+      else if (auto shimMuxOp = dyn_cast<ShimMuxOp>(op))
+        outputShimMux(shimMuxOp);
+      else if (auto shimSwitchboxOp = dyn_cast<ShimSwitchboxOp>(op))
+        outputShimSwitchbox(shimSwitchboxOp);
+    }
+    output << "} // mlir_aie_configure_switchboxes_column_" << column.first
+           << "\n\n";
+  }
+  outputColumnDispatch("configure_switchboxes", switchboxColumnIds,
+                       herdPrologue);
+
+  // mlir_aie_configure_trace
+  output << "void mlir_aie_configure_trace(" << ctx_p << ") {\n";
+  for (auto trace : module.getOps<TraceOp>()) {
+    auto tileLoc = tileLocStr(trace.colIndex(), trace.rowIndex());
+    bool isCore = trace.getModule() == TraceModule::Core;
+    StringRef mod = isCore ? "XAIE_CORE_MOD" : "XAIE_MEM_MOD";
+    StringRef suffix = isCore ? "_CORE" : "_MEM";
+    auto event = [&](StringRef name) {
+      return ("XAIE_EVENT_" + name + suffix).str();
+    };
+    StringRef mode = "XAIE_TRACE_EVENT_TIME";
+    if (trace.getMode() == TraceMode::EventPC)
+      mode = "XAIE_TRACE_EVENT_PC";
+    else if (trace.getMode() == TraceMode::Execution)
+      mode = "XAIE_TRACE_INST_EXEC";
+
+    int slot = 0;
+    for (auto name : trace.getEvents().getAsValueRange<StringAttr>())
+      output << "XAie_TraceEvent(" << deviceInstRef << ", " << tileLoc << ", "
+             << mod << ", " << event(name) << ", " << slot++ << ");\n";
+    output << "XAie_TracePktConfig(" << deviceInstRef << ", " << tileLoc
+           << ", " << mod << ", " << packetStr(trace.getPacketID(), 0)
+           << ");\n";
+    output << "XAie_TraceControlConfig(" << deviceInstRef << ", " << tileLoc
+           << ", " << mod << ", " << event(trace.getStart()) << ", "
+           << event(trace.getStop()) << ", " << mode << ");\n";
+  }
+  output << "} // mlir_aie_configure_trace\n\n";
 
   // Output Lock Accessors
   // accessors[accName][accState] = {(lockOp, phyState), ...}
@@ -18,6 +18,7 @@
 #include "mlir/IR/Location.h"
 #include "mlir/IR/PatternMatch.h"
 #include "mlir/Pass/Pass.h"
+#include "mlir/Support/FileUtilities.h"
 #include "mlir/Target/LLVMIR/Export.h"
 #include "mlir/Target/LLVMIR/Import.h"
 #include "mlir/Tools/mlir-translate/MlirTranslateMain.h"
@@ -26,7 +27,11 @@
 #include "mlir/Transforms/Passes.h"
 
 #include "llvm/IR/Module.h"
+#include "llvm/Support/FileSystem.h"
+#include "llvm/Support/JSON.h"
+#include "llvm/Support/Path.h"
 #include "llvm/Support/TargetSelect.h"
+#include "llvm/Support/ToolOutputFile.h"
 
 #include "aie/AIEDialect.h"
 #include "aie/AIENetlistAnalysis.h"
@@ -46,6 +51,11 @@ static llvm::cl::opt<int>
     tileRow("tilerow", llvm::cl::desc("row coordinate of core to translate"),
             llvm::cl::init(0));
 
+static llvm::cl::opt<std::string> outputDir(
+    "output-dir",
+    llvm::cl::desc("directory written by aie-generate-linker-files"),
+    llvm::cl::init("."));
+
 static llvm::cl::opt<std::string>
     xaieTarget("xaie-target",
                llvm::cl::desc("target of aie-generate-xaie option: v1|v2"),
@@ -91,6 +101,154 @@ void writeLDScriptMap(raw_ostream &output, BufferOp buf, int offset,
   output << ". += 0x" << llvm::utohexstr(numBytes) << ";\n";
 }
 
+using TileMap = DenseMap<std::pair<int, int>, Operation *>;
+using BufferMap = DenseMap<Operation *, SmallVector<BufferOp, 4>>;
+
+// Output the gnu linker script of the core in the given tile.
+void writeLDScript(raw_ostream &output, TileOp tile, TileMap &tiles,
+                   BufferMap &buffers, NetlistAnalysis &NL) {
+  // output << "// Tile(" << tileCol << ", " << tileRow << ")\n";
+  // output << "// Memory map: name base_address num_bytes\n";
+  output << R"THESCRIPT(
+MEMORY
+{
+   program (RX) : ORIGIN = 0, LENGTH = 0x0020000
+   data (!RX) : ORIGIN = 0x20000, LENGTH = 0x0020000
+}
+ENTRY(_main_init)
+SECTIONS
+{
+  . = 0x0;
+  .text : { 
+     // the _main_init symbol from me_basic.o has to come at address zero.
+     *me_basic.o(.text)
+     . = 0x200;
+     _ctors_start = .;
+     _init_array_start = .;
+     KEEP(SORT(*.init_array))
+     _ctors_end = .;
+     _init_array_end = .;
+     _dtors_start = .;
+     _dtors_end = .;
+     *(.text)
+  } > program
+  .data : { 
+     *(.data*);
+     *(.rodata*)
+  } > data
+  . = 0x20000;
+  _sp_start_value_DM_stack = .;
+  . = 0x24000;
+)THESCRIPT";
+  auto doBuffer = [&](Optional<TileID> tile, int offset) {
+    if (tiles.count(tile.value()))
+      for (auto buf : buffers[tiles[tile.value()]])
+        writeLDScriptMap(output, buf, offset, NL);
+  };
+  auto srcCoord = std::make_pair(tile.colIndex(), tile.rowIndex());
+  if (auto tile = getMemSouth(srcCoord))
+    doBuffer(tile, 0x00020000);
+  if (auto tile = getMemWest(srcCoord))
+    doBuffer(tile, 0x00028000);
+  if (auto tile = getMemNorth(srcCoord))
+    doBuffer(tile, 0x00030000);
+  if (auto tile = getMemEast(srcCoord))
+    doBuffer(tile, 0x00038000);
+  output << "  .bss : { *(.bss) } > data\n";
+  output << "  .bss.DMb.4 : { *(.bss.DMb.4) } > data\n";
+  output << "}\n";
+  if (auto coreOp = tile.getCoreOp()) {
+    if (auto fileAttr = coreOp->getAttrOfType<StringAttr>("link_with")) {
+      auto fileName = std::string(fileAttr.getValue());
+      output << "INPUT(" << fileName << ")\n";
+    }
+  }
+}
+
+// Output the BCF file of the core in the given tile, used when linking with
+// xchesscc.
+void writeBCF(raw_ostream &output, TileOp tile, TileMap &tiles,
+              BufferMap &buffers, NetlistAnalysis &NL) {
+  output << "_entry_point _main_init\n";
+  output << "_symbol      _main _after _main_init\n";
+  output << "_symbol      _main_init 0\n";
+  output << "_reserved DMb      0x00000 0x20000 //Don't put data in code "
+            "memory\n";
+
+  auto doBuffer = [&](Optional<TileID> tile, int offset) {
+    if (tiles.count(tile.value()))
+      for (auto buf : buffers[tiles[tile.value()]])
+        writeBCFMap(output, buf, offset, NL);
+  };
+  auto srcCoord = std::make_pair(tile.colIndex(), tile.rowIndex());
+  if (auto tile = getMemSouth(srcCoord))
+    doBuffer(tile, 0x00020000);
+  if (auto tile = getMemWest(srcCoord))
+    doBuffer(tile, 0x00028000);
+  if (auto tile = getMemNorth(srcCoord))
+    doBuffer(tile, 0x00030000);
+  if (auto tile = getMemEast(srcCoord))
+    doBuffer(tile, 0x00038000);
+  output << "_stack    DM_stack 0x20000  0x400 //stack for core\n";
+  output << "_reserved DMb 0x40000 0xc0000 // And everything else "
+            "the core can't see\n";
+  if (auto coreOp = tile.getCoreOp()) {
+    if (auto fileAttr = coreOp->getAttrOfType<StringAttr>("link_with")) {
+      auto fileName = std::string(fileAttr.getValue());
+      output << "_include _file " << fileName << "\n";
+    }
+  }
+}
+
+// Write core_<col>_<row>.ld.script and core_<col>_<row>.bcf for every core of
+// the module into the given directory, from a single netlist analysis.  The
+// names of the files written are printed to output.
+LogicalResult writeCoreLinkerFiles(ModuleOp module, StringRef dir,
+                                   raw_ostream &output) {
+  TileMap tiles;
+  DenseMap<Operation *, CoreOp> cores;
+  DenseMap<Operation *, MemOp> mems;
+  DenseMap<std::pair<Operation *, int>, LockOp> locks;
+  BufferMap buffers;
+  DenseMap<Operation *, SwitchboxOp> switchboxes;
+
+  NetlistAnalysis NL(module, tiles, cores, mems, locks, buffers, switchboxes);
+  NL.collectTiles(tiles);
+  NL.collectBuffers(buffers);
+
+  if (auto ec = llvm::sys::fs::create_directories(dir))
+    return module.emitError("cannot create ") << dir << ": " << ec.message();
+
+  auto writeFile = [&](TileOp tile, StringRef ext,
+                       function_ref<void(raw_ostream &)> write)
+      -> LogicalResult {
+    SmallString<128> path(dir);
+    llvm::sys::path::append(path, "core_" + std::to_string(tile.colIndex()) +
+                                      "_" + std::to_string(tile.rowIndex()) +
+                                      "." + ext);
+    std::string errorMessage;
+    auto file = openOutputFile(path, &errorMessage);
+    if (!file)
+      return tile.emitError(errorMessage);
+    write(file->os());
+    file->keep();
+    output << path << "\n";
+    return success();
+  };
+  for (auto tile : module.getOps<TileOp>()) {
+    if (!tile.getCoreOp())
+      continue;
+    if (failed(writeFile(tile, "ld.script", [&](raw_ostream &os) {
+          writeLDScript(os, tile, tiles, buffers, NL);
+        })) ||
+        failed(writeFile(tile, "bcf", [&](raw_ostream &os) {
+          writeBCF(os, tile, tiles, buffers, NL);
+        })))
+      return failure();
+  }
+  return success();
+}
+
 void registerAIETranslations() {
   TranslateFromMLIRRegistration registrationMMap(
       "aie-generate-mmap",
@@ -193,65 +351,8 @@ void registerAIETranslations() {
         NL.collectBuffers(buffers);
 
         for (auto tile : module.getOps<TileOp>())
-          if (tile.colIndex() == tileCol && tile.rowIndex() == tileRow) {
-            // output << "// Tile(" << tileCol << ", " << tileRow << ")\n";
-            // output << "// Memory map: name base_address num_bytes\n";
-            output << R"THESCRIPT(
-MEMORY
-{
-   program (RX) : ORIGIN = 0, LENGTH = 0x0020000
-   data (!RX) : ORIGIN = 0x20000, LENGTH = 0x0020000
-}
-ENTRY(_main_init)
-SECTIONS
-{
-  . = 0x0;
-  .text : { 
-     // the _main_init symbol from me_basic.o has to come at address zero.
-     *me_basic.o(.text)
-     . = 0x200;
-     _ctors_start = .;
-     _init_array_start = .;
-     KEEP(SORT(*.init_array))
-     _ctors_end = .;
-     _init_array_end = .;
-     _dtors_start = .;
-     _dtors_end = .;
-     *(.text)
-  } > program
-  .data : { 
-     *(.data*);
-     *(.rodata*)
-  } > data
-  . = 0x20000;
-  _sp_start_value_DM_stack = .;
-  . = 0x24000;
-)THESCRIPT";
-            auto doBuffer = [&](Optional<TileID> tile, int offset) {
-              if (tiles.count(tile.value()))
-                for (auto buf : buffers[tiles[tile.value()]])
-                  writeLDScriptMap(output, buf, offset, NL);
-            };
-            auto srcCoord = std::make_pair(tile.colIndex(), tile.rowIndex());
-            if (auto tile = getMemSouth(srcCoord))
-              doBuffer(tile, 0x00020000);
-            if (auto tile = getMemWest(srcCoord))
-              doBuffer(tile, 0x00028000);
-            if (auto tile = getMemNorth(srcCoord))
-              doBuffer(tile, 0x00030000);
-            if (auto tile = getMemEast(srcCoord))
-              doBuffer(tile, 0x00038000);
-            output << "  .bss : { *(.bss) } > data\n";
-            output << "  .bss.DMb.4 : { *(.bss.DMb.4) } > data\n";
-            output << "}\n";
-            if (auto coreOp = tile.getCoreOp()) {
-              if (auto fileAttr =
-                      coreOp->getAttrOfType<StringAttr>("link_with")) {
-                auto fileName = std::string(fileAttr.getValue());
-                output << "INPUT(" << fileName << ")\n";
-              }
-            }
-          }
+          if (tile.colIndex() == tileCol && tile.rowIndex() == tileRow)
+            writeLDScript(output, tile, tiles, buffers, NL);
         return success();
       },
       [](DialectRegistry &registry) {
@@ -300,38 +401,8 @@ SECTIONS
         // // Include all symbols from rom.c
         // _include _file rom.o
         for (auto tile : module.getOps<TileOp>())
-          if (tile.colIndex() == tileCol && tile.rowIndex() == tileRow) {
-            output << "_entry_point _main_init\n";
-            output << "_symbol      _main _after _main_init\n";
-            output << "_symbol      _main_init 0\n";
-            output << "_reserved DMb      0x00000 0x20000 //Don't put data in "
-                      "code memory\n";
-
-            auto doBuffer = [&](Optional<TileID> tile, int offset) {
-              if (tiles.count(tile.value()))
-                for (auto buf : buffers[tiles[tile.value()]])
-                  writeBCFMap(output, buf, offset, NL);
-            };
-            auto srcCoord = std::make_pair(tile.colIndex(), tile.rowIndex());
-            if (auto tile = getMemSouth(srcCoord))
-              doBuffer(tile, 0x00020000);
-            if (auto tile = getMemWest(srcCoord))
-              doBuffer(tile, 0x00028000);
-            if (auto tile = getMemNorth(srcCoord))
-              doBuffer(tile, 0x00030000);
-            if (auto tile = getMemEast(srcCoord))
-              doBuffer(tile, 0x00038000);
-            output << "_stack    DM_stack 0x20000  0x400 //stack for core\n";
-            output << "_reserved DMb 0x40000 0xc0000 // And everything else "
-                      "the core can't see\n";
-            if (auto coreOp = tile.getCoreOp()) {
-              if (auto fileAttr =
-                      coreOp->getAttrOfType<StringAttr>("link_with")) {
-                auto fileName = std::string(fileAttr.getValue());
-                output << "_include _file " << fileName << "\n";
-              }
-            }
-          }
+          if (tile.colIndex() == tileCol && tile.rowIndex() == tileRow)
+            writeBCF(output, tile, tiles, buffers, NL);
         return success();
       },
       [](DialectRegistry &registry) {
@@ -345,6 +416,38 @@ SECTIONS
         registry.insert<LLVM::LLVMDialect>();
       });
 
+  TranslateFromMLIRRegistration registrationLinkerFiles(
+      "aie-generate-linker-files",
+      [](ModuleOp module, raw_ostream &output) {
+        return writeCoreLinkerFiles(module, outputDir, output);
+      },
+      [](DialectRegistry &registry) {
+        registry.insert<xilinx::AIE::AIEDialect>();
+        registry.insert<func::FuncDialect>();
+        registry.insert<cf::ControlFlowDialect>();
+        registry.insert<DLTIDialect>();
+        registry.insert<arith::ArithmeticDialect>();
+        registry.insert<memref::MemRefDialect>();
+        registry.insert<VectorDialect>();
+        registry.insert<LLVM::LLVMDialect>();
+      });
+
+  TranslateFromMLIRRegistration registrationDependencies(
+      "aie-generate-dependencies",
+      [](ModuleOp module, raw_ostream &output) {
+        return AIEGenerateDependencies(module, output);
+      },
+      [](DialectRegistry &registry) {
+        registry.insert<xilinx::AIE::AIEDialect>();
+        registry.insert<func::FuncDialect>();
+        registry.insert<cf::ControlFlowDialect>();
+        registry.insert<DLTIDialect>();
+        registry.insert<arith::ArithmeticDialect>();
+        registry.insert<memref::MemRefDialect>();
+        registry.insert<VectorDialect>();
+        registry.insert<LLVM::LLVMDialect>();
+      });
+
   TranslateFromMLIRRegistration registrationCoreList(
       "aie-generate-corelist",
       [](ModuleOp module, raw_ostream &output) {
@@ -407,6 +510,44 @@ SECTIONS
         registry.insert<VectorDialect>();
         registry.insert<LLVM::LLVMDialect>();
       });
+  TranslateFromMLIRRegistration registrationTraceMetadata(
+      "aie-trace-metadata",
+      [](ModuleOp module, raw_ostream &output) {
+        // The trace words only identify events by their slot, so the decoder
+        // needs to know which events each trace stream was configured with.
+        llvm::json::OStream json(output, 2);
+        json.object([&] {
+          json.attributeArray("traces", [&] {
+            for (auto trace : module.getOps<TraceOp>()) {
+              json.object([&] {
+                json.attribute("packet_id", (int64_t)trace.getPacketID());
+                json.attribute("col", trace.colIndex());
+                json.attribute("row", trace.rowIndex());
+                json.attribute("module",
+                               stringifyTraceModule(trace.getModule()));
+                json.attribute("mode", stringifyTraceMode(trace.getMode()));
+                json.attributeArray("events", [&] {
+                  for (auto event :
+                       trace.getEvents().getAsValueRange<StringAttr>())
+                    json.value(event);
+                });
+              });
+            }
+          });
+        });
+        output << "\n";
+        return success();
+      },
+      [](DialectRegistry &registry) {
+        registry.insert<xilinx::AIE::AIEDialect>();
+        registry.insert<func::FuncDialect>();
+        registry.insert<cf::ControlFlowDialect>();
+        registry.insert<DLTIDialect>();
+        registry.insert<arith::ArithmeticDialect>();
+        registry.insert<memref::MemRefDialect>();
+        registry.insert<VectorDialect>();
+        registry.insert<LLVM::LLVMDialect>();
+      });
   TranslateFromMLIRRegistration registrationXJSON(
       "aie-flows-to-json",
       [](ModuleOp module, raw_ostream &output) {
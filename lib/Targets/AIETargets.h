@@ -20,5 +20,10 @@ mlir::LogicalResult AIEFlowsToJSON(mlir::ModuleOp module,
                                    llvm::raw_ostream &output);
 mlir::LogicalResult ADFGenerateCPPGraph(mlir::ModuleOp module,
                                         llvm::raw_ostream &output);
+mlir::LogicalResult AIEGenerateDependencies(mlir::ModuleOp module,
+                                            llvm::raw_ostream &output);
+mlir::LogicalResult writeCoreLinkerFiles(mlir::ModuleOp module,
+                                         llvm::StringRef dir,
+                                         llvm::raw_ostream &output);
 }
 }
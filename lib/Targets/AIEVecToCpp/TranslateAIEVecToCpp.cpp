@@ -17,6 +17,7 @@
 #include "mlir/Dialect/ControlFlow/IR/ControlFlowOps.h"
 #include "mlir/Dialect/EmitC/IR/EmitC.h"
 #include "mlir/Dialect/Func/IR/FuncOps.h"
+#include "mlir/Dialect/LLVMIR/LLVMDialect.h"
 #include "mlir/Dialect/MemRef/IR/MemRef.h"
 #include "mlir/Dialect/SCF/IR/SCF.h"
 #include "mlir/Dialect/Vector/IR/VectorOps.h"
@@ -30,6 +31,7 @@
 #include "llvm/ADT/StringExtras.h"
 #include "llvm/ADT/StringMap.h"
 #include "llvm/ADT/TypeSwitch.h"
+#include "llvm/Support/CommandLine.h"
 #include "llvm/Support/Debug.h"
 #include "llvm/Support/FormatVariadic.h"
 
@@ -40,6 +42,44 @@ using namespace xilinx;
 using namespace xilinx::aievec;
 using llvm::formatv;
 
+namespace {
+/// The memref pointers that are declared restrict in the generated code
+enum class RestrictKind { All, NoAlias, None };
+} // namespace
+
+static llvm::cl::opt<RestrictKind> restrictPointers(
+    "aievec-to-cpp-restrict",
+    llvm::cl::desc("Select the memref pointers declared restrict"),
+    llvm::cl::values(
+        clEnumValN(RestrictKind::All, "all", "All the memref pointers"),
+        clEnumValN(RestrictKind::NoAlias, "noalias",
+                   "Only the memref arguments marked llvm.noalias"),
+        clEnumValN(RestrictKind::None, "none", "None of the memref pointers")),
+    llvm::cl::init(RestrictKind::All));
+
+static llvm::cl::opt<bool> assumeAligned(
+    "aievec-to-cpp-assume-aligned",
+    llvm::cl::desc("Emit memref.assume_alignment ops as "
+                   "__builtin_assume_aligned hints"),
+    llvm::cl::init(false));
+
+static llvm::cl::opt<bool>
+    loopHints("aievec-to-cpp-loop-hints",
+              llvm::cl::desc("Flatten the loops with a small static trip "
+                             "count, and unroll the loops whose trip count is "
+                             "a known multiple of 2 or 4"),
+              llvm::cl::init(false));
+
+static llvm::cl::opt<bool>
+    aieml("aievec-to-cpp-aieml",
+          llvm::cl::desc("Target AIE-ML, whose elementwise intrinsics "
+                         "multiply bf16 vectors into f32 accumulators. AIE1 "
+                         "has no bf16 multiplier"),
+          llvm::cl::init(false));
+
+// Loops with at most this many iterations are flattened with loop hints
+static const int64_t maxFlattenedTripCount = 4;
+
 /// Convenience functions to produce interleaved output with functions returning
 /// a LogicalResult. This is different than those in STLExtras as functions used
 /// on each element doesn't return a string.
@@ -223,8 +263,10 @@ private:
 static bool skippedOp(Operation *op, CppEmitter &emitter,
                       bool checkStrongLiveness = true) {
   // Ops that must be skipped:
-  // skip op 1 : all dimOp
-  bool skip = isa<memref::DimOp>(op);
+  // skip op 1 : all dimOp, and the assume_alignment ops if the alignment
+  // hints are not requested
+  bool skip = isa<memref::DimOp>(op) ||
+              (isa<memref::AssumeAlignmentOp>(op) && !assumeAligned);
   // skip op 2 : some aievec::srs for float types
   if (auto srsOp = dyn_cast<aievec::SRSOp>(op)) {
     // Get the datatype of the source accumulator and result vector
@@ -417,6 +459,57 @@ static std::pair<bool, int64_t> getStep(scf::ForOp forOp) {
   return std::make_pair(false, 0);
 }
 
+// Return a known divisor of the integer value, or 0 if the value is the
+// constant 0
+static uint64_t getKnownDivisor(Value val, unsigned depth = 0) {
+  if (auto cst = val.getDefiningOp<arith::ConstantOp>()) {
+    if (auto attr = cst.getValue().dyn_cast<IntegerAttr>())
+      return std::abs(attr.getValue().getSExtValue());
+    return 1;
+  }
+  // Bound the recursion on long chains of arithmetic ops
+  Operation *op = val.getDefiningOp();
+  if (!op || depth > 8)
+    return 1;
+  if (auto mulOp = dyn_cast<arith::MulIOp>(op))
+    return getKnownDivisor(mulOp.getLhs(), depth + 1) *
+           getKnownDivisor(mulOp.getRhs(), depth + 1);
+  if (isa<arith::AddIOp, arith::SubIOp>(op))
+    return llvm::GreatestCommonDivisor64(
+        getKnownDivisor(op->getOperand(0), depth + 1),
+        getKnownDivisor(op->getOperand(1), depth + 1));
+  if (auto castOp = dyn_cast<arith::IndexCastOp>(op))
+    return getKnownDivisor(castOp.getIn(), depth + 1);
+  return 1;
+}
+
+// Return a known multiple of the number of iterations of the for operator.
+// The upper bound of the main loop peeled by the vectorizer is its lower
+// bound plus a multiple of the step, so this also covers dynamic bounds.
+static int64_t getTripCountMultiple(scf::ForOp forOp) {
+  auto step = getStep(forOp);
+  if (!step.first || step.second <= 0)
+    return 1;
+
+  uint64_t diff;
+  auto tc = getTripCount(forOp);
+  Value lb = forOp.getLowerBound();
+  auto addOp = forOp.getUpperBound().getDefiningOp<arith::AddIOp>();
+  if (tc.first)
+    diff = std::abs(tc.second);
+  else if (addOp && addOp.getLhs() == lb)
+    diff = getKnownDivisor(addOp.getRhs());
+  else if (addOp && addOp.getRhs() == lb)
+    diff = getKnownDivisor(addOp.getLhs());
+  else
+    diff = llvm::GreatestCommonDivisor64(
+        getKnownDivisor(forOp.getUpperBound()), getKnownDivisor(lb));
+
+  if (diff == 0 || diff % step.second)
+    return 1;
+  return diff / step.second;
+}
+
 // Return the operator string of the SCF dialect binary operator
 template <typename T> static StringRef getOperator(T binOp) {
   if (isa<arith::AddIOp, arith::AddFOp>(binOp))
@@ -453,6 +546,24 @@ static LogicalResult printOperation(CppEmitter &emitter, T binOp) {
 // Print AIE dialect ops
 //===----------------------------------------------------------------------===//
 
+// Print the memref assume_alignment op as an alignment hint on the pointer
+static LogicalResult printOperation(CppEmitter &emitter,
+                                    memref::AssumeAlignmentOp assumeOp) {
+  Value memref = assumeOp.memref();
+  // The memref should have already been emitted
+  if (!emitter.hasValueInScope(memref))
+    return failure();
+
+  raw_indented_ostream &os = emitter.ostream();
+  StringRef name = emitter.getOrCreateName(memref);
+  os << name << " = (";
+  if (failed(emitter.emitType(assumeOp->getLoc(), memref.getType())))
+    return failure();
+  os << ")__builtin_assume_aligned(" << name << ", " << assumeOp.alignment()
+     << ")";
+  return success();
+}
+
 // Print the AIE dialect UPD op
 static LogicalResult printOperation(CppEmitter &emitter, aievec::UPDOp updOp) {
   Value source = updOp.getSource();
@@ -878,14 +989,23 @@ static LogicalResult printOperation(CppEmitter &emitter, aievec::MulOp mulOp) {
   // Create opname based on the result type
   VectorType resType = mulOp.getResult().getType().cast<VectorType>();
   Type eltType = resType.getElementType();
-  if (!simpleScheme) {
-    if (auto iType = eltType.dyn_cast<IntegerType>()) {
+  // bf16 operands are multiplied lane-wise into an f32 accumulator, with the
+  // AIE-ML elementwise intrinsics
+  bool bf16Scheme = lhs.getType().cast<VectorType>().getElementType().isBF16();
+  if (bf16Scheme && !aieml)
+    return mulOp.emitOpError("bf16 operands need the AIE-ML target "
+                             "(--aievec-to-cpp-aieml)");
+  if (bf16Scheme)
+    opname = "mul_elem_" + std::to_string(getVectorLaneSize(resType));
+  else if (eltType.isa<FloatType>())
+    opname = "fp";
+  else if (!simpleScheme) {
+    if (auto iType = eltType.dyn_cast<IntegerType>())
       if (iType.getWidth() == 80)
         opname = "l";
-    } else if (eltType.isa<FloatType>())
-      opname = "fp";
   }
-  opname += "mul";
+  if (!bf16Scheme)
+    opname += "mul";
   if (!simpleScheme && !eltType.isa<FloatType>())
     opname += std::to_string(getVectorLaneSize(resType));
 
@@ -1033,14 +1153,24 @@ static LogicalResult printOperation(CppEmitter &emitter, aievec::FMAOp fmaOp) {
   // Create opname based on the result type
   VectorType resType = fmaOp.getResult().getType().cast<VectorType>();
   Type eltType = resType.getElementType();
-  if (!simpleScheme) {
-    if (auto iType = eltType.dyn_cast<IntegerType>()) {
+  // bf16 operands are multiplied lane-wise into an f32 accumulator, with the
+  // AIE-ML elementwise intrinsics
+  bool bf16Scheme = lhs.getType().cast<VectorType>().getElementType().isBF16();
+  if (bf16Scheme && !aieml)
+    return fmaOp.emitOpError("bf16 operands need the AIE-ML target "
+                             "(--aievec-to-cpp-aieml)");
+  if (bf16Scheme)
+    opname = std::string(fmaOp.getFmsub() ? "msc" : "mac") + "_elem_" +
+             std::to_string(getVectorLaneSize(resType));
+  else if (eltType.isa<FloatType>())
+    opname = "fp";
+  else if (!simpleScheme) {
+    if (auto iType = eltType.dyn_cast<IntegerType>())
       if (iType.getWidth() == 80)
         opname = "l";
-    } else if (eltType.isa<FloatType>())
-      opname = "fp";
   }
-  opname += fmaOp.getFmsub() ? "msc" : "mac";
+  if (!bf16Scheme)
+    opname += fmaOp.getFmsub() ? "msc" : "mac";
   if (!simpleScheme && !eltType.isa<FloatType>())
     opname += std::to_string(getVectorLaneSize(resType));
 
@@ -1051,13 +1181,18 @@ static LogicalResult printOperation(CppEmitter &emitter, aievec::FMAOp fmaOp) {
   os << " = ";
   os << opname;
   os << "(";
-  os << accName;
-  os << ", ";
+  // The elementwise bf16 intrinsics take the accumulator last
+  if (!bf16Scheme) {
+    os << accName;
+    os << ", ";
+  }
   if (failed(printFMAOrMulOperand<aievec::FMAOp>(emitter, fmaOp, 0)))
     return failure();
   os << ", ";
   if (failed(printFMAOrMulOperand<aievec::FMAOp>(emitter, fmaOp, 1)))
     return failure();
+  if (bf16Scheme)
+    os << ", " << accName;
   os << ")";
 
   // Finally, set the name of the result to the accumulator's name
@@ -1340,12 +1475,15 @@ static LogicalResult printOperation(CppEmitter &emitter, scf::ForOp forOp) {
   os << " += ";
   os << emitter.getOrCreateName(forOp.getStep());
   os << ")\n";
-  os << "chess_prepare_for_pipelining\n";
   // Try to find the upper bound and step of the for operator.
   // If the bounds are found, print them
   auto tc = getTripCount(forOp);
+  auto step = getStep(forOp);
+  // Fully unroll the loops that only run a few iterations
+  bool flatten = loopHints && tc.first && step.first && step.second > 0 &&
+                 ceilDiv(tc.second, step.second) <= maxFlattenedTripCount;
+  os << (flatten ? "chess_flatten_loop\n" : "chess_prepare_for_pipelining\n");
   if (tc.first) {
-    auto step = getStep(forOp);
     int64_t lb =
         step.first && step.second > 0 ? floorDiv(tc.second, step.second) : 1;
     int64_t ub =
@@ -1357,6 +1495,14 @@ static LogicalResult printOperation(CppEmitter &emitter, scf::ForOp forOp) {
       os << std::to_string(ub);
     os << ")\n";
   }
+  // Unroll the pipelined loops whose trip count is a known multiple of the
+  // unroll factor, so that no remainder iterations are generated
+  if (loopHints && !flatten) {
+    int64_t multiple = getTripCountMultiple(forOp);
+    int64_t unroll = multiple % 4 == 0 ? 4 : multiple % 2 == 0 ? 2 : 1;
+    if (unroll > 1)
+      os << "chess_unroll_loop(" << unroll << ")\n";
+  }
   os << "{\n";
   os.indent();
 
@@ -1524,6 +1670,13 @@ static LogicalResult printOperation(CppEmitter &emitter,
           [&](BlockArgument arg) -> LogicalResult {
             if (failed(emitter.emitType(functionOp.getLoc(), arg.getType())))
               return failure();
+            // Only the memref arguments marked noalias are restrict pointers,
+            // if requested
+            if (restrictPointers == RestrictKind::NoAlias &&
+                arg.getType().isa<MemRefType>() &&
+                functionOp.getArgAttr(arg.getArgNumber(),
+                                      LLVM::LLVMDialect::getNoAliasAttrName()))
+              os << " restrict";
             os << " " << emitter.getOrCreateName(arg);
             // If it is a memref argument, we need to check if it has dynamic
             // shape. If so, the dimensions have to be printed out
@@ -1905,6 +2058,11 @@ LogicalResult CppEmitter::emitOperation(Operation &op, bool trailingSemicolon) {
           //  Arithmetic ops.
           .Case<arith::AddIOp>(
               [&](auto op) { return printOperation<arith::AddIOp>(*this, op); })
+          .Case<arith::MulIOp>(
+              [&](auto op) { return printOperation<arith::MulIOp>(*this, op); })
+          // MemRef ops
+          .Case<memref::AssumeAlignmentOp>(
+              [&](auto op) { return printOperation(*this, op); })
           // Vector ops
           .Case<vector::TransferWriteOp>(
               [&](auto op) { return printOperation(*this, op); })
@@ -1946,6 +2104,10 @@ LogicalResult CppEmitter::emitType(Location loc, Type type, bool stdintType) {
   }
   if (auto fType = type.dyn_cast<FloatType>()) {
     switch (fType.getWidth()) {
+    case 16:
+      if (fType.isBF16())
+        return (os << "bfloat16"), success();
+      return emitError(loc, "cannot emit float type ") << type;
     case 32:
       return (os << "float"), success();
     case 64:
@@ -1983,7 +2145,9 @@ LogicalResult CppEmitter::emitType(Location loc, Type type, bool stdintType) {
   if (auto tType = type.dyn_cast<MemRefType>()) {
     if (failed(emitType(loc, tType.getElementType())))
       return failure();
-    os << " * restrict";
+    os << " *";
+    if (restrictPointers == RestrictKind::All)
+      os << " restrict";
     return success();
   }
   // VectorType: printed as v'lane''eltType'
@@ -11,10 +11,21 @@
 // This file contains common libraries used for testing.
 
 #include "test_library.h"
+#include <algorithm>
+#include <atomic>
+#include <chrono>
 #include <cmath>
+#include <map>
+#include <mutex>
+#include <set>
 #include <stdio.h>
 #include <fcntl.h>
+#include <string>
 #include <sys/mman.h>
+#include <sys/stat.h>
+#include <thread>
+#include <unistd.h>
+#include <vector>
 
 extern "C" {
 extern aie_libxaie_ctx_t *ctx /* = nullptr*/;
@@ -403,16 +414,21 @@ void mlir_aie_init_mems(aie_libxaie_ctx_t *ctx, int numBufs) {} // Placeholder
 int *mlir_aie_mem_alloc(aie_libxaie_ctx_t *ctx, int bufIdx, u64 addr,
                         int size) {
   int fd = open("/dev/mem", O_RDWR | O_SYNC);
-  int *mem_ptr;
+  int *mem_ptr = nullptr;
   if (fd != -1) {
     mem_ptr =
         (int *)mmap(NULL, 0x8000, PROT_READ | PROT_WRITE, MAP_SHARED, fd, addr);
+    close(fd);
+    if (mem_ptr == MAP_FAILED)
+      mem_ptr = nullptr;
   }
   return mem_ptr;
 }
 
-void mlir_aie_sync_mem_cpu(aie_libxaie_ctx_t *ctx, int bufIdx) {} // Placeholder
-void mlir_aie_sync_mem_dev(aie_libxaie_ctx_t *ctx, int bufIdx) {} // Placeholder
+// Buffers are mapped from /dev/mem with O_SYNC, which makes them uncached, so
+// there is nothing to synchronize.
+void mlir_aie_sync_mem_cpu(aie_libxaie_ctx_t *ctx, int bufIdx) {}
+void mlir_aie_sync_mem_dev(aie_libxaie_ctx_t *ctx, int bufIdx) {}
 
 /*
  ******************************************************************************
@@ -445,6 +461,10 @@ aie_libxaie_ctx_t *mlir_aie_init_libxaie() {
   ctx->AieConfigPtr.AieTileNumRows = XAIE_AIE_TILE_NUM_ROWS;
   ctx->AieConfigPtr.PartProp = {0};
   ctx->DevInst = {0};
+  ctx->buffers = nullptr;
+  ctx->numBuffers = 0;
+  ctx->hostPool = nullptr;
+  ctx->hostPoolSize = 0;
 
   /*
     XAIEGBL_HWCFG_SET_CONFIG((&xaie->AieConfig),
@@ -462,6 +482,11 @@ aie_libxaie_ctx_t *mlir_aie_init_libxaie() {
 void mlir_aie_deinit_libxaie(aie_libxaie_ctx_t *ctx) {
   //  if (xaie == _air_host_active_libxaie1)
   //    _air_host_active_libxaie1 = nullptr;
+  for (int i = 0; i < ctx->hostPoolSize; i++)
+    ctx->hostPool[i]->in_use = 0;
+  mlir_aie_host_pool_trim(ctx);
+  free(ctx->hostPool);
+  free(ctx->buffers);
   AieRC RC = XAie_Finish(&(ctx->DevInst));
   if (RC != XAIE_OK) {
     printf("Failed to finish tiles.\n");
@@ -942,27 +967,430 @@ void mlir_aie_clear_shim_config(aie_libxaie_ctx_t *ctx, int col, int row) {
   clear_range(&(ctx->DevInst), tileAddr, 0x3F200, 0x3F37C);
 }
 
+// Host buffers are allocated in whole pages, which also keeps them aligned
+// for the shim DMA.
+#define HOST_BUFFER_PAGE_SIZE 0x1000
+
+mlir_aie_host_buffer_t *mlir_aie_host_buffer_alloc(aie_libxaie_ctx_t *ctx,
+                                                   size_t bytes) {
+  size_t size = (bytes + HOST_BUFFER_PAGE_SIZE - 1) &
+                ~(size_t)(HOST_BUFFER_PAGE_SIZE - 1);
+  if (size == 0)
+    size = HOST_BUFFER_PAGE_SIZE;
+
+  // Reuse the smallest free buffer that is large enough.
+  mlir_aie_host_buffer_t *best = nullptr;
+  for (int i = 0; i < ctx->hostPoolSize; i++) {
+    mlir_aie_host_buffer_t *buf = ctx->hostPool[i];
+    if (!buf->in_use && buf->size >= size && (!best || buf->size < best->size))
+      best = buf;
+  }
+  if (best) {
+    best->in_use = 1;
+    return best;
+  }
+
+  XAie_MemInst *mem =
+      XAie_MemAllocate(&(ctx->DevInst), size, XAIE_MEM_CACHEABLE);
+  if (!mem) {
+    printf("Failed to allocate %zu bytes of host memory.\n", size);
+    return nullptr;
+  }
+  mlir_aie_host_buffer_t **pool = (mlir_aie_host_buffer_t **)realloc(
+      ctx->hostPool,
+      (ctx->hostPoolSize + 1) * sizeof(mlir_aie_host_buffer_t *));
+  mlir_aie_host_buffer_t *buf =
+      (mlir_aie_host_buffer_t *)malloc(sizeof(mlir_aie_host_buffer_t));
+  if (!pool || !buf) {
+    if (pool)
+      ctx->hostPool = pool;
+    free(buf);
+    XAie_MemFree(mem);
+    return nullptr;
+  }
+  ctx->hostPool = pool;
+  ctx->hostPool[ctx->hostPoolSize++] = buf;
+
+  buf->vaddr = XAie_MemGetVAddr(mem);
+  buf->devaddr = XAie_MemGetDevAddr(mem);
+  buf->size = size;
+  buf->in_use = 1;
+  buf->mem = mem;
+  XAie_MemSyncForCPU(mem);
+  return buf;
+}
+
+void mlir_aie_host_buffer_release(aie_libxaie_ctx_t *ctx,
+                                  mlir_aie_host_buffer_t *buf) {
+  if (buf)
+    buf->in_use = 0;
+}
+
+// Synchronize part of a host buffer.  On aarch64 the data cache can be
+// maintained by virtual address from user space, so only the cache lines
+// covering the range are cleaned and invalidated.  Elsewhere, and for the
+// whole buffer, the driver synchronizes the entire allocation.
+static void sync_host_range(mlir_aie_host_buffer_t *buf, size_t offset,
+                            size_t bytes, bool forDev) {
+  if (offset >= buf->size || bytes == 0)
+    return;
+  if (bytes > buf->size - offset)
+    bytes = buf->size - offset;
+#if defined(__aarch64__)
+  if (bytes < buf->size) {
+    u64 ctr;
+    asm volatile("mrs %0, ctr_el0" : "=r"(ctr));
+    uintptr_t line = 4 << ((ctr >> 16) & 0xf);
+    uintptr_t start = ((uintptr_t)buf->vaddr + offset) & ~(line - 1);
+    uintptr_t end = (uintptr_t)buf->vaddr + offset + bytes;
+    for (uintptr_t p = start; p < end; p += line)
+      asm volatile("dc civac, %0" : : "r"(p) : "memory");
+    asm volatile("dsb sy" : : : "memory");
+    return;
+  }
+#endif
+  if (forDev)
+    XAie_MemSyncForDev(buf->mem);
+  else
+    XAie_MemSyncForCPU(buf->mem);
+}
+
+void mlir_aie_host_buffer_sync_cpu(aie_libxaie_ctx_t *ctx,
+                                   mlir_aie_host_buffer_t *buf, size_t offset,
+                                   size_t bytes) {
+  sync_host_range(buf, offset, bytes, false);
+}
+
+void mlir_aie_host_buffer_sync_dev(aie_libxaie_ctx_t *ctx,
+                                   mlir_aie_host_buffer_t *buf, size_t offset,
+                                   size_t bytes) {
+  sync_host_range(buf, offset, bytes, true);
+}
+
+void mlir_aie_host_pool_trim(aie_libxaie_ctx_t *ctx) {
+  int kept = 0;
+  for (int i = 0; i < ctx->hostPoolSize; i++) {
+    mlir_aie_host_buffer_t *buf = ctx->hostPool[i];
+    if (buf->in_use) {
+      ctx->hostPool[kept++] = buf;
+    } else {
+      XAie_MemFree(buf->mem);
+      free(buf);
+    }
+  }
+  ctx->hostPoolSize = kept;
+}
+
+// A slot is FREE when the host may hand it out, FILLING between
+// mlir_aie_stream_next_buffer() and mlir_aie_stream_submit(), and IN_FLIGHT
+// from submission until mlir_aie_stream_poll() observes completion.
+#define MLIR_AIE_STREAM_SLOT_FREE 0
+#define MLIR_AIE_STREAM_SLOT_FILLING 1
+#define MLIR_AIE_STREAM_SLOT_IN_FLIGHT 2
+
+mlir_aie_stream_t *mlir_aie_stream_open(aie_libxaie_ctx_t *ctx, int col,
+                                        int channel, int s2mm, int firstBd,
+                                        int firstLock, int numSlots,
+                                        size_t slotBytes) {
+  if (numSlots < 1 || numSlots > MLIR_AIE_STREAM_MAX_SLOTS)
+    return nullptr;
+  mlir_aie_stream_t *stream =
+      (mlir_aie_stream_t *)calloc(1, sizeof(mlir_aie_stream_t));
+  if (!stream)
+    return nullptr;
+  stream->ctx = ctx;
+  stream->col = col;
+  stream->channel = channel;
+  stream->s2mm = s2mm;
+  stream->numSlots = numSlots;
+
+  XAie_LocType loc = XAie_TileLoc(col, 0);
+  for (int i = 0; i < numSlots; i++) {
+    mlir_aie_stream_slot_t &slot = stream->slots[i];
+    slot.buf = mlir_aie_host_buffer_alloc(ctx, slotBytes);
+    slot.bd = firstBd + i;
+    slot.lock = firstLock + i;
+    slot.state = MLIR_AIE_STREAM_SLOT_FREE;
+    // The host holds every lock with value 0 until it submits the buffer.  A
+    // lock that is already held belongs to someone else, and the slot would
+    // never be the host's.
+    if (!slot.buf || XAie_LockAcquire(&(ctx->DevInst), loc,
+                                      XAie_LockInit(slot.lock, 0),
+                                      0) != XAIE_OK) {
+      for (int j = 0; j < i; j++)
+        XAie_LockRelease(&(ctx->DevInst), loc,
+                         XAie_LockInit(stream->slots[j].lock, 0), 0);
+      mlir_aie_stream_close(stream);
+      return nullptr;
+    }
+  }
+
+  XAie_DmaChannelEnable(&(ctx->DevInst), loc, channel,
+                        s2mm ? DMA_S2MM : DMA_MM2S);
+  return stream;
+}
+
+mlir_aie_host_buffer_t *mlir_aie_stream_next_buffer(mlir_aie_stream_t *stream) {
+  mlir_aie_stream_slot_t &slot = stream->slots[stream->head];
+  if (slot.state == MLIR_AIE_STREAM_SLOT_IN_FLIGHT)
+    return nullptr;
+  slot.state = MLIR_AIE_STREAM_SLOT_FILLING;
+  return slot.buf;
+}
+
+int mlir_aie_stream_submit(mlir_aie_stream_t *stream, size_t bytes) {
+  mlir_aie_stream_slot_t &slot = stream->slots[stream->head];
+  if (slot.state != MLIR_AIE_STREAM_SLOT_FILLING || bytes > slot.buf->size)
+    return -1;
+  aie_libxaie_ctx_t *ctx = stream->ctx;
+  XAie_LocType loc = XAie_TileLoc(stream->col, 0);
+
+  if (!stream->s2mm)
+    mlir_aie_host_buffer_sync_dev(ctx, slot.buf, 0, bytes);
+
+  // The BD is not in flight, so it can be rewritten with the new length.  It
+  // waits for the host to release the lock with value 1 and signals
+  // completion by releasing it with value 0.
+  XAie_DmaDesc desc;
+  XAie_DmaDescInit(&(ctx->DevInst), &desc, loc);
+  XAie_DmaSetLock(&desc, XAie_LockInit(slot.lock, 1),
+                  XAie_LockInit(slot.lock, 0));
+  XAie_DmaSetAddrLen(&desc, slot.buf->devaddr, bytes);
+  XAie_DmaSetAxi(&desc, /* smid */ 0, /* burstlen */ 4, /* QoS */ 0,
+                 /* Cache */ 0, /* Secure */ XAIE_ENABLE);
+  XAie_DmaEnableBd(&desc);
+  if (XAie_DmaWriteBd(&(ctx->DevInst), &desc, loc, slot.bd) != XAIE_OK ||
+      XAie_DmaChannelPushBdToQueue(&(ctx->DevInst), loc, stream->channel,
+                                   stream->s2mm ? DMA_S2MM : DMA_MM2S,
+                                   slot.bd) != XAIE_OK)
+    return -1;
+  XAie_LockRelease(&(ctx->DevInst), loc, XAie_LockInit(slot.lock, 1), 0);
+
+  slot.bytes = bytes;
+  slot.state = MLIR_AIE_STREAM_SLOT_IN_FLIGHT;
+  stream->head = (stream->head + 1) % stream->numSlots;
+  return 0;
+}
+
+mlir_aie_host_buffer_t *mlir_aie_stream_poll(mlir_aie_stream_t *stream,
+                                             size_t *bytes) {
+  mlir_aie_stream_slot_t &slot = stream->slots[stream->tail];
+  if (slot.state != MLIR_AIE_STREAM_SLOT_IN_FLIGHT)
+    return nullptr;
+  aie_libxaie_ctx_t *ctx = stream->ctx;
+  // A zero timeout makes this a single attempt, which only succeeds once the
+  // BD has released the lock with value 0.
+  if (XAie_LockAcquire(&(ctx->DevInst), XAie_TileLoc(stream->col, 0),
+                       XAie_LockInit(slot.lock, 0), 0) != XAIE_OK)
+    return nullptr;
+
+  if (stream->s2mm)
+    mlir_aie_host_buffer_sync_cpu(ctx, slot.buf, 0, slot.bytes);
+  if (bytes)
+    *bytes = slot.bytes;
+  slot.state = MLIR_AIE_STREAM_SLOT_FREE;
+  stream->tail = (stream->tail + 1) % stream->numSlots;
+  return slot.buf;
+}
+
+int mlir_aie_stream_pending(mlir_aie_stream_t *stream) {
+  int pending = 0;
+  for (int i = 0; i < stream->numSlots; i++)
+    if (stream->slots[i].state == MLIR_AIE_STREAM_SLOT_IN_FLIGHT)
+      pending++;
+  return pending;
+}
+
+void mlir_aie_stream_close(mlir_aie_stream_t *stream) {
+  if (!stream)
+    return;
+  aie_libxaie_ctx_t *ctx = stream->ctx;
+  XAie_DmaChannelDisable(&(ctx->DevInst), XAie_TileLoc(stream->col, 0),
+                         stream->channel,
+                         stream->s2mm ? DMA_S2MM : DMA_MM2S);
+  for (int i = 0; i < stream->numSlots; i++)
+    mlir_aie_host_buffer_release(ctx, stream->slots[i].buf);
+  free(stream);
+}
+
+// The indexed buffer interface below is kept for existing designs and is
+// layered on top of the host buffer pool.  Calling mlir_aie_init_mems() again
+// for a new run recycles the buffers of the previous run.
 void mlir_aie_init_mems(aie_libxaie_ctx_t *ctx, int numBufs) {
-  ctx->buffers = (XAie_MemInst **)malloc(numBufs * sizeof(XAie_MemInst *));
+  for (int i = 0; i < ctx->numBuffers; i++)
+    mlir_aie_host_buffer_release(ctx, ctx->buffers[i]);
+  free(ctx->buffers);
+  ctx->buffers = (mlir_aie_host_buffer_t **)calloc(
+      numBufs, sizeof(mlir_aie_host_buffer_t *));
+  ctx->numBuffers = ctx->buffers ? numBufs : 0;
 }
 
 int *mlir_aie_mem_alloc(aie_libxaie_ctx_t *ctx, int bufIdx, u64 addr,
                         int size) {
-  //  ctx->InBuffers = (XAie_MemInst**)malloc(sizeof(XAie_MemInst*));
-  //  XAie_MemInst *IN;
-  ctx->buffers[bufIdx] =
-      XAie_MemAllocate(&(ctx->DevInst), size * sizeof(int), XAIE_MEM_CACHEABLE);
-  int *mem_ptr = (int *)XAie_MemGetVAddr(ctx->buffers[bufIdx]);
-  XAie_MemSyncForCPU(ctx->buffers[bufIdx]);
-  return mem_ptr;
+  if (bufIdx < 0 || bufIdx >= ctx->numBuffers)
+    return nullptr;
+  mlir_aie_host_buffer_release(ctx, ctx->buffers[bufIdx]);
+  ctx->buffers[bufIdx] = mlir_aie_host_buffer_alloc(ctx, size * sizeof(int));
+  if (!ctx->buffers[bufIdx])
+    return nullptr;
+  return mlir_aie_host_buffer_data<int>(ctx->buffers[bufIdx]);
 }
 
 void mlir_aie_sync_mem_cpu(aie_libxaie_ctx_t *ctx, int bufIdx) {
-  XAie_MemSyncForCPU(ctx->buffers[bufIdx]);
+  if (bufIdx < 0 || bufIdx >= ctx->numBuffers || !ctx->buffers[bufIdx])
+    return;
+  mlir_aie_host_buffer_t *buf = ctx->buffers[bufIdx];
+  mlir_aie_host_buffer_sync_cpu(ctx, buf, 0, buf->size);
 }
 
 void mlir_aie_sync_mem_dev(aie_libxaie_ctx_t *ctx, int bufIdx) {
-  XAie_MemSyncForDev(ctx->buffers[bufIdx]);
+  if (bufIdx < 0 || bufIdx >= ctx->numBuffers || !ctx->buffers[bufIdx])
+    return;
+  mlir_aie_host_buffer_t *buf = ctx->buffers[bufIdx];
+  mlir_aie_host_buffer_sync_dev(ctx, buf, 0, buf->size);
+}
+
+// ELF images loaded by mlir_aie_load_elf().  Identical images are shared,
+// whatever the name of their file, and each file name maps to the image it
+// held when it was last read, along with its size and modification time.
+// Images are never erased, so pointers to them stay valid without holding the
+// lock, even after the file they were read from is rebuilt.
+struct elf_file_entry {
+  off_t size;
+  struct timespec mtime;
+  const std::vector<unsigned char> *image;
+};
+static std::set<std::vector<unsigned char>> elf_images;
+static std::map<std::string, elf_file_entry> elf_files;
+static std::mutex elf_cache_mutex;
+
+static const std::vector<unsigned char> *lookup_elf(const char *elf_file) {
+  struct stat st;
+  if (stat(elf_file, &st) != 0 || st.st_size <= 0)
+    return nullptr;
+  {
+    std::lock_guard<std::mutex> guard(elf_cache_mutex);
+    auto it = elf_files.find(elf_file);
+    if (it != elf_files.end() && it->second.size == st.st_size &&
+        it->second.mtime.tv_sec == st.st_mtim.tv_sec &&
+        it->second.mtime.tv_nsec == st.st_mtim.tv_nsec)
+      return it->second.image;
+  }
+
+  // Read the file without holding the lock, so that different kernels can be
+  // read concurrently.
+  FILE *fd = fopen(elf_file, "rb");
+  if (!fd)
+    return nullptr;
+  std::vector<unsigned char> image(st.st_size);
+  size_t read = fread(image.data(), 1, image.size(), fd);
+  fclose(fd);
+  if (read != image.size())
+    return nullptr;
+
+  std::lock_guard<std::mutex> guard(elf_cache_mutex);
+  // If the same image was read before, under this name or another one, keep
+  // that copy.
+  const std::vector<unsigned char> *shared =
+      &*elf_images.insert(std::move(image)).first;
+  elf_files[elf_file] = {st.st_size, st.st_mtim, shared};
+  return shared;
+}
+
+int mlir_aie_num_elf_images(void) {
+  std::lock_guard<std::mutex> guard(elf_cache_mutex);
+  return elf_images.size();
+}
+
+AieRC mlir_aie_load_elf(aie_libxaie_ctx_t *ctx, int col, int row,
+                        const char *elf_file) {
+  const std::vector<unsigned char> *image = lookup_elf(elf_file);
+  if (!image) {
+    printf("Failed to read elf file %s\n", elf_file);
+    return XAIE_INVALID_ELF;
+  }
+  return XAie_LoadElfMem(&(ctx->DevInst), XAie_TileLoc(col, row),
+                         image->data());
+}
+
+void mlir_aie_configure_columns(aie_libxaie_ctx_t *ctx,
+                                const mlir_aie_column_fn_t *columns,
+                                int numColumns, int nthreads) {
+  // The threads share ctx->DevInst, which libxaie does not promise to be
+  // thread-safe, so the columns are configured concurrently only when the
+  // caller asks for it explicitly.  See test_library.h.
+  nthreads = std::max(1, std::min(nthreads, numColumns));
+  if (nthreads == 1) {
+    for (int i = 0; i < numColumns; i++)
+      columns[i](ctx);
+    return;
+  }
+
+  // Columns are handed out one at a time, since the amount of work per column
+  // varies a lot between designs.
+  std::atomic<int> next(0);
+  auto worker = [&]() {
+    for (int i = next++; i < numColumns; i = next++)
+      columns[i](ctx);
+  };
+
+  std::vector<std::thread> pool;
+  for (int t = 1; t < nthreads; t++)
+    pool.emplace_back(worker);
+  worker();
+  for (auto &thread : pool)
+    thread.join();
+}
+
+// Back-off bounds, in microseconds, between polling rounds that acquire
+// nothing.
+#define LOCK_POLL_MIN_BACKOFF 1
+#define LOCK_POLL_MAX_BACKOFF 64
+
+int mlir_aie_acquire_locks(aie_libxaie_ctx_t *ctx, mlir_aie_lock_wait_t *locks,
+                           int numLocks, int waitAll, int timeout) {
+  auto deadline = std::chrono::steady_clock::now() +
+                  std::chrono::microseconds(std::max(timeout, 0));
+  int pending = 0;
+  for (int i = 0; i < numLocks; i++)
+    if (!locks[i].acquired)
+      pending++;
+
+  int count = 0;
+  int backoff = LOCK_POLL_MIN_BACKOFF;
+  while (pending > 0) {
+    // Each poll is a single attempt, so one slow lock does not delay
+    // observing the others.  XAie_LockAcquire() with a zero timeout tries
+    // once and returns, which the libxaie v1 driver does not promise.
+    int progress = 0;
+    for (int i = 0; i < numLocks; i++) {
+      mlir_aie_lock_wait_t &lock = locks[i];
+      if (lock.acquired)
+        continue;
+      if (mlir_aie_acquire_lock(ctx, lock.col, lock.row, lock.lockid,
+                                lock.lockval, 0)) {
+        lock.acquired = 1;
+        progress++;
+      }
+    }
+    count += progress;
+    pending -= progress;
+    if (pending == 0 || (count > 0 && !waitAll))
+      break;
+
+    auto now = std::chrono::steady_clock::now();
+    if (now >= deadline)
+      break;
+    if (progress) {
+      backoff = LOCK_POLL_MIN_BACKOFF;
+      continue;
+    }
+    auto remaining =
+        std::chrono::duration_cast<std::chrono::microseconds>(deadline - now);
+    usleep(std::min<long>(backoff, remaining.count()));
+    backoff = std::min(backoff * 2, LOCK_POLL_MAX_BACKOFF);
+  }
+  return count;
 }
 
 #endif
@@ -146,6 +146,17 @@ XAie_Config ConfigPtr = {XAIE_DEV_GEN_AIE, XAIE_BASE_ADDR,
 XAie_DevInst DevInst = { 0 };
 */
 
+/// A host buffer that the shim DMAs can access directly.  Buffers are handed
+/// out by mlir_aie_host_buffer_alloc() from a pool owned by the context and
+/// are recycled, rather than freed, by mlir_aie_host_buffer_release().
+struct mlir_aie_host_buffer_t {
+  void *vaddr;       // Host virtual address.
+  u64 devaddr;       // Address to program into shim DMA buffer descriptors.
+  size_t size;       // Allocated size in bytes, a multiple of the page size.
+  int in_use;        // Non-zero while handed out to the application.
+  XAie_MemInst *mem; // Driver memory instance backing the buffer.
+};
+
 struct aie_libxaie_ctx_t {
   XAie_Config AieConfigPtr;
   XAie_DevInst DevInst;
@@ -156,7 +167,12 @@ struct aie_libxaie_ctx_t {
     XAieGbl_Tile TileInst[XAIE_NUM_COLS][XAIE_NUM_ROWS+1];
     XAieDma_Tile TileDMAInst[XAIE_NUM_COLS][XAIE_NUM_ROWS+1];
   */
-  XAie_MemInst **buffers;
+  // Buffers allocated through mlir_aie_mem_alloc(), indexed by bufIdx.
+  mlir_aie_host_buffer_t **buffers;
+  int numBuffers;
+  // Every buffer allocated from the driver, in use or not.
+  mlir_aie_host_buffer_t **hostPool;
+  int hostPoolSize;
 };
 
 
@@ -279,9 +295,153 @@ int *mlir_aie_mem_alloc(aie_libxaie_ctx_t *ctx, int bufIdx, u64 addr, int size);
 void mlir_aie_sync_mem_cpu(aie_libxaie_ctx_t *ctx, int bufIdx);
 void mlir_aie_sync_mem_dev(aie_libxaie_ctx_t *ctx, int bufIdx);
 
+#ifndef LIBXAIENGINEV1
+/// Get a host buffer of at least the given number of bytes.  A previously
+/// released buffer is reused when one is large enough, otherwise a new
+/// page-aligned buffer is allocated from the driver.  Returns null on failure.
+mlir_aie_host_buffer_t *mlir_aie_host_buffer_alloc(aie_libxaie_ctx_t *ctx,
+                                                   size_t bytes);
+
+/// Return a host buffer to the pool so that later allocations can reuse it.
+void mlir_aie_host_buffer_release(aie_libxaie_ctx_t *ctx,
+                                  mlir_aie_host_buffer_t *buf);
+
+/// Make the given byte range of the buffer visible to the CPU after the
+/// array has written it.
+void mlir_aie_host_buffer_sync_cpu(aie_libxaie_ctx_t *ctx,
+                                   mlir_aie_host_buffer_t *buf, size_t offset,
+                                   size_t bytes);
+
+/// Make the given byte range of the buffer visible to the shim DMAs after the
+/// CPU has written it.
+void mlir_aie_host_buffer_sync_dev(aie_libxaie_ctx_t *ctx,
+                                   mlir_aie_host_buffer_t *buf, size_t offset,
+                                   size_t bytes);
+
+/// Give every host buffer that is not currently in use back to the driver.
+void mlir_aie_host_pool_trim(aie_libxaie_ctx_t *ctx);
+
+/// The maximum number of buffers a stream keeps in flight.  This matches the
+/// depth of the shim DMA channel start queue.
+#define MLIR_AIE_STREAM_MAX_SLOTS 4
+
+/// A host buffer rotating through a stream, together with the shim BD and
+/// lock that carry it.
+struct mlir_aie_stream_slot_t {
+  mlir_aie_host_buffer_t *buf;
+  int bd;
+  int lock;
+  size_t bytes; // Bytes submitted with the buffer.
+  int state;    // One of the MLIR_AIE_STREAM_SLOT_* values.
+};
+
+/// A ring of host buffers streamed through one shim DMA channel.  Each
+/// submitted buffer is written into its own BD and pushed onto the channel
+/// queue.  The BD releases its lock with value 0 when the transfer finishes,
+/// which is how the host observes completion without blocking.
+struct mlir_aie_stream_t {
+  aie_libxaie_ctx_t *ctx;
+  int col;
+  int channel;
+  int s2mm; // Non-zero for array-to-host streams.
+  int numSlots;
+  int head; // Next slot handed out to the host.
+  int tail; // Oldest slot submitted to the array.
+  mlir_aie_stream_slot_t slots[MLIR_AIE_STREAM_MAX_SLOTS];
+};
+
+/// Open a stream on the given shim DMA channel of the shim tile in column col.
+/// The stream owns BDs [firstBd, firstBd + numSlots) and locks
+/// [firstLock, firstLock + numSlots) of the tile, which must not be used by the
+/// shimDMA configuration of the design.  Each slot has a host buffer of
+/// slotBytes bytes.  Returns null on failure, including when one of the locks
+/// is already held.
+mlir_aie_stream_t *mlir_aie_stream_open(aie_libxaie_ctx_t *ctx, int col,
+                                        int channel, int s2mm, int firstBd,
+                                        int firstLock, int numSlots,
+                                        size_t slotBytes);
+
+/// Get the next buffer for the host to fill (host-to-array) or to receive
+/// into (array-to-host), or null if every buffer is still in flight.
+/// A buffer returned by mlir_aie_stream_poll() stays valid until it is
+/// returned again from here.
+mlir_aie_host_buffer_t *mlir_aie_stream_next_buffer(mlir_aie_stream_t *stream);
+
+/// Hand the buffer returned by the last mlir_aie_stream_next_buffer() to the
+/// array, transferring the given number of bytes.  Returns 0 on success.
+int mlir_aie_stream_submit(mlir_aie_stream_t *stream, size_t bytes);
+
+/// Return the oldest submitted buffer if its transfer has finished, storing
+/// the number of bytes transferred in *bytes when bytes is not null.  Returns
+/// null without blocking if the transfer is still in progress or nothing is
+/// in flight.
+mlir_aie_host_buffer_t *mlir_aie_stream_poll(mlir_aie_stream_t *stream,
+                                             size_t *bytes);
+
+/// The number of buffers submitted to the array and not yet completed.
+int mlir_aie_stream_pending(mlir_aie_stream_t *stream);
+
+/// Disable the channel and return the stream's buffers to the host buffer
+/// pool.
+void mlir_aie_stream_close(mlir_aie_stream_t *stream);
+
+/// A generated function that configures a single column of the array.
+typedef void (*mlir_aie_column_fn_t)(aie_libxaie_ctx_t *ctx);
+
+/// Load the given ELF file into the program memory of the core at the given
+/// tile.  ELF images are cached, and identical images are kept once whatever
+/// the name of their file, so a kernel shared by many cores is held in memory
+/// once.  A file is read again when its size or modification time changes.
+AieRC mlir_aie_load_elf(aie_libxaie_ctx_t *ctx, int col, int row,
+                        const char *elf_file);
+
+/// Return the number of distinct ELF images cached by mlir_aie_load_elf().
+int mlir_aie_num_elf_images(void);
+
+/// Run the given per-column configuration functions on up to nthreads host
+/// threads, or in column order if nthreads is 1 or less.  Returns once every
+/// column has been configured.
+///
+/// The threads share ctx->DevInst, and libxaie v2 does not promise that an
+/// XAie_DevInst can be used from several threads: IO backends and the
+/// transaction mode keep mutable state in it.  Only ask for more than one
+/// thread with an IO backend whose register accesses are independent, e.g.
+/// plain memory-mapped IO, and never in transaction mode.
+void mlir_aie_configure_columns(aie_libxaie_ctx_t *ctx,
+                                const mlir_aie_column_fn_t *columns,
+                                int numColumns, int nthreads);
+
+/// A lock to acquire with mlir_aie_acquire_locks().
+struct mlir_aie_lock_wait_t {
+  int col;
+  int row;
+  int lockid;
+  int lockval;
+  int acquired; // Set once the lock has been acquired.
+};
+
+/// Acquire a set of locks, each with its own value, under a single deadline
+/// of timeout microseconds.  The locks are polled round-robin, backing off
+/// between rounds that make no progress.  If waitAll is zero, return as soon
+/// as at least one lock has been acquired.  Locks already marked acquired are
+/// skipped, so a call that timed out can be repeated with the same array.
+/// Returns the number of locks acquired by this call.  Only available with
+/// libxaie v2, whose lock acquire can be polled without blocking.
+int mlir_aie_acquire_locks(aie_libxaie_ctx_t *ctx, mlir_aie_lock_wait_t *locks,
+                           int numLocks, int waitAll, int timeout);
+#endif
+
 void computeStats(u32 performance_counter[], int n);
 
 } // extern "C"
 
+#ifndef LIBXAIENGINEV1
+/// Typed view of the contents of a host buffer.
+template <typename T>
+inline T *mlir_aie_host_buffer_data(mlir_aie_host_buffer_t *buf) {
+  return static_cast<T *>(buf->vaddr);
+}
+#endif
+
 #endif
 
@@ -0,0 +1,23 @@
+// RUN: aie-translate --aievec-to-cpp --aievec-to-cpp-aieml %s | FileCheck %s
+// RUN: not aie-translate --aievec-to-cpp %s 2>&1 | FileCheck %s --check-prefix=AIE1
+
+// The elementwise bf16 intrinsics only exist on AIE-ML.
+// AIE1: error: 'aievec.mul' op bf16 operands need the AIE-ML target (--aievec-to-cpp-aieml)
+
+// CHECK-LABEL: void mac_bf16(bfloat16 * restrict v{{[0-9]+}}, bfloat16 * restrict v{{[0-9]+}}, float * restrict v{{[0-9]+}}) {
+module {
+  func.func @mac_bf16(%arg0: memref<16xbf16>, %arg1: memref<16xbf16>, %arg2: memref<16xf32>) {
+    %c0 = arith.constant 0 : index
+    %0 = aievec.upd %arg0[%c0] {index = 0 : i8, offset = 0 : si32} : memref<16xbf16>, vector<16xbf16>
+    %1 = aievec.upd %arg1[%c0] {index = 0 : i8, offset = 0 : si32} : memref<16xbf16>, vector<16xbf16>
+    %2 = aievec.mul %0, %1 : vector<16xbf16>, vector<16xbf16>, vector<16xf32>
+    %3 = aievec.mac %0, %1, %2 : vector<16xbf16>, vector<16xbf16>, vector<16xf32>
+    vector.transfer_write %3, %arg2[%c0] : vector<16xf32>, memref<16xf32>
+    return
+  }
+}
+
+// CHECK: v16bfloat16 [[A:v[0-9]+]] = *(v16bfloat16 *)(v{{[0-9]+}} + v{{[0-9]+}});
+// CHECK: v16bfloat16 [[B:v[0-9]+]] = *(v16bfloat16 *)(v{{[0-9]+}} + v{{[0-9]+}});
+// CHECK: v16float [[ACC:v[0-9]+]] = mul_elem_16([[A]], [[B]]);
+// CHECK: [[ACC]] = mac_elem_16([[A]], [[B]], [[ACC]]);
@@ -0,0 +1,19 @@
+// RUN: aie-translate --aievec-to-cpp %s | FileCheck %s
+
+// The float mul/mac are fpmul/fpmac in the simple scheme too, as fpadd.
+// CHECK-LABEL: void mul_mac_f32(float * restrict v{{[0-9]+}}, float * restrict v{{[0-9]+}}, float * restrict v{{[0-9]+}}) {
+// CHECK: v8float [[A:v[0-9]+]] = *(v8float *)(v{{[0-9]+}} + v{{[0-9]+}});
+// CHECK: v8float [[B:v[0-9]+]] = *(v8float *)(v{{[0-9]+}} + v{{[0-9]+}});
+// CHECK: v8float [[ACC:v[0-9]+]] = fpmul([[A]], [[B]]);
+// CHECK: [[ACC]] = fpmac([[ACC]], [[A]], [[B]]);
+module {
+  func.func @mul_mac_f32(%arg0: memref<8xf32>, %arg1: memref<8xf32>, %arg2: memref<8xf32>) {
+    %c0 = arith.constant 0 : index
+    %0 = aievec.upd %arg0[%c0] {index = 0 : i8, offset = 0 : si32} : memref<8xf32>, vector<8xf32>
+    %1 = aievec.upd %arg1[%c0] {index = 0 : i8, offset = 0 : si32} : memref<8xf32>, vector<8xf32>
+    %2 = aievec.mul %0, %1 : vector<8xf32>, vector<8xf32>, vector<8xf32>
+    %3 = aievec.mac %0, %1, %2 : vector<8xf32>, vector<8xf32>, vector<8xf32>
+    vector.transfer_write %3, %arg2[%c0] : vector<8xf32>, memref<8xf32>
+    return
+  }
+}
@@ -0,0 +1,54 @@
+// RUN: aie-translate --aievec-to-cpp --aievec-to-cpp-restrict=noalias --aievec-to-cpp-assume-aligned --aievec-to-cpp-loop-hints %s | FileCheck %s
+// RUN: aie-translate --aievec-to-cpp %s | FileCheck %s --check-prefix=DEFAULT
+
+// CHECK-LABEL: void copy(int16_t * restrict [[A:v[0-9]+]], int16_t * [[B:v[0-9]+]], size_t [[LB:v[0-9]+]], size_t [[N:v[0-9]+]]) {
+// CHECK: [[A]] = (int16_t *)__builtin_assume_aligned([[A]], 32);
+
+// The trip count is 16: the loop is unrolled by 4.
+// CHECK: for (size_t [[I:v[0-9]+]] = {{.*}}; [[I]] < {{.*}}; [[I]] += {{.*}})
+// CHECK-NEXT: chess_prepare_for_pipelining
+// CHECK-NEXT: chess_loop_range(16, 16)
+// CHECK-NEXT: chess_unroll_loop(4)
+// CHECK-NEXT: {
+
+// The trip count is 4: the loop is flattened.
+// CHECK: for (size_t [[J:v[0-9]+]] = {{.*}}; [[J]] < {{.*}}; [[J]] += {{.*}})
+// CHECK-NEXT: chess_flatten_loop
+// CHECK-NEXT: chess_loop_range(4, 4)
+// CHECK-NEXT: {
+
+// The trip count is only known at run time, but it is a multiple of 2.
+// CHECK: size_t [[LEN:v[0-9]+]] = [[N]] * {{.*}};
+// CHECK: size_t [[UB:v[0-9]+]] = [[LB]] + [[LEN]];
+// CHECK: for (size_t [[K:v[0-9]+]] = [[LB]]; [[K]] < [[UB]]; [[K]] += {{.*}})
+// CHECK-NEXT: chess_prepare_for_pipelining
+// CHECK-NEXT: chess_unroll_loop(2)
+// CHECK-NEXT: {
+
+// DEFAULT-LABEL: void copy(int16_t * restrict v{{[0-9]+}}, int16_t * restrict v{{[0-9]+}}, size_t v{{[0-9]+}}, size_t v{{[0-9]+}}) {
+// DEFAULT-NOT: __builtin_assume_aligned
+// DEFAULT-NOT: chess_flatten_loop
+// DEFAULT-NOT: chess_unroll_loop
+func.func @copy(%A: memref<256xi16> {llvm.noalias}, %B: memref<256xi16>, %lb: index, %n: index) {
+  memref.assume_alignment %A, 32 : memref<256xi16>
+  %c0 = arith.constant 0 : index
+  %c16 = arith.constant 16 : index
+  %c32 = arith.constant 32 : index
+  %c64 = arith.constant 64 : index
+  %c256 = arith.constant 256 : index
+  scf.for %i = %c0 to %c256 step %c16 {
+    %0 = aievec.upd %A[%i] {index = 0 : i8, offset = 0 : si32} : memref<256xi16>, vector<16xi16>
+    vector.transfer_write %0, %B[%i] {in_bounds = [true]} : vector<16xi16>, memref<256xi16>
+  }
+  scf.for %j = %c0 to %c64 step %c16 {
+    %1 = aievec.upd %A[%j] {index = 0 : i8, offset = 0 : si32} : memref<256xi16>, vector<16xi16>
+    vector.transfer_write %1, %B[%j] {in_bounds = [true]} : vector<16xi16>, memref<256xi16>
+  }
+  %len = arith.muli %n, %c32 : index
+  %ub = arith.addi %lb, %len : index
+  scf.for %k = %lb to %ub step %c16 {
+    %2 = aievec.upd %A[%k] {index = 0 : i8, offset = 0 : si32} : memref<256xi16>, vector<16xi16>
+    vector.transfer_write %2, %B[%k] {in_bounds = [true]} : vector<16xi16>, memref<256xi16>
+  }
+  return
+}
@@ -0,0 +1,69 @@
+// RUN: aie-translate --aievec-to-cpp %s -split-input-file | FileCheck %s
+
+// CHECK-LABEL: void conv_i16xi8(int16_t * restrict v{{[0-9]+}}, int8_t * restrict v{{[0-9]+}}, int16_t * restrict v{{[0-9]+}}) {
+module {
+  func.func @conv_i16xi8(%arg0: memref<64xi16>, %arg1: memref<32xi8>, %arg2: memref<16xi16>) {
+    %c0 = arith.constant 0 : index
+    %0 = aievec.upd %arg1[%c0] {index = 0 : i8, offset = 0 : si32} : memref<32xi8>, vector<32xi8>
+    %1 = aievec.upd %arg2[%c0] {index = 0 : i8, offset = 0 : si32} : memref<16xi16>, vector<16xi16>
+    %2 = aievec.upd %arg0[%c0] {index = 0 : i8, offset = 0 : si32} : memref<64xi16>, vector<32xi16>
+    %3 = aievec.ups %1 {shift = 0 : i8} : vector<16xi16>, vector<16xi48>
+    %4 = aievec.mac %2, %0, %3 {xoffsets = "0x03020100", xoffsets_hi = "0x07060504", xsquare = "0x2110", xstart = "0", zoffsets = "0", zoffsets_hi = "0", zstart = "0", zstep = "1"} : vector<32xi16>, vector<32xi8>, vector<16xi48>
+    %5 = aievec.srs %4 {shift = 0 : i8} : vector<16xi48>, vector<16xi16>
+    vector.transfer_write %5, %arg2[%c0] : vector<16xi16>, memref<16xi16>
+    return
+  }
+}
+
+// CHECK: v32int8 [[FILT:v[0-9]+]] = *(v32int8 *)(v{{[0-9]+}} + v{{[0-9]+}});
+// CHECK: v16acc48 [[ACC:v[0-9]+]] = ups(v{{[0-9]+}}, 0);
+// CHECK: [[ACC]] = mac16([[ACC]], v{{[0-9]+}}, 0, 0x03020100, 0x07060504, 0x2110, [[FILT]], 0, 0, 0, 1);
+// CHECK: v16int16 v{{[0-9]+}} = srs([[ACC]], 0);
+
+// -----
+
+// CHECK-LABEL: void conv_i32xi16(int32_t * restrict v{{[0-9]+}}, int16_t * restrict v{{[0-9]+}}, int32_t * restrict v{{[0-9]+}}) {
+module {
+  func.func @conv_i32xi16(%arg0: memref<32xi32>, %arg1: memref<16xi16>, %arg2: memref<8xi32>) {
+    %c0 = arith.constant 0 : index
+    %0 = aievec.upd %arg1[%c0] {index = 0 : i8, offset = 0 : si32} : memref<16xi16>, vector<16xi16>
+    %1 = aievec.upd %arg2[%c0] {index = 0 : i8, offset = 0 : si32} : memref<8xi32>, vector<8xi32>
+    %2 = aievec.upd %arg0[%c0] {index = 0 : i8, offset = 0 : si32} : memref<32xi32>, vector<16xi32>
+    %3 = aievec.ups %1 {shift = 0 : i8} : vector<8xi32>, vector<8xi80>
+    %4 = aievec.mac %2, %0, %3 {xoffsets = "0x76543210", xstart = "0", zoffsets = "0", zstart = "0", zstep = "1"} : vector<16xi32>, vector<16xi16>, vector<8xi80>
+    %5 = aievec.srs %4 {shift = 0 : i8} : vector<8xi80>, vector<8xi32>
+    vector.transfer_write %5, %arg2[%c0] : vector<8xi32>, memref<8xi32>
+    return
+  }
+}
+
+// CHECK: v16int16 [[FILT:v[0-9]+]] = *(v16int16 *)(v{{[0-9]+}} + v{{[0-9]+}});
+// CHECK: v8acc80 [[ACC:v[0-9]+]] = lups(v{{[0-9]+}}, 0);
+// CHECK: [[ACC]] = lmac8([[ACC]], v{{[0-9]+}}, 0, 0x76543210, [[FILT]], 0, 0, 1);
+// CHECK: v8int32 v{{[0-9]+}} = srs([[ACC]], 0);
+
+// -----
+
+// i8 activations with i16 weights. AIE1 only multiplies 16-bit by 8-bit with
+// the 16-bit operand in the xbuff, so the i16 weights are the xbuff, read as a
+// splat, and the i8 activations are the zbuff, read with the sliding window.
+// CHECK-LABEL: void conv_i8xi16(int8_t * restrict v{{[0-9]+}}, int16_t * restrict v{{[0-9]+}}, int16_t * restrict v{{[0-9]+}}) {
+module {
+  func.func @conv_i8xi16(%arg0: memref<64xi8>, %arg1: memref<32xi16>, %arg2: memref<16xi16>) {
+    %c0 = arith.constant 0 : index
+    %0 = aievec.upd %arg0[%c0] {index = 0 : i8, offset = 0 : si32} : memref<64xi8>, vector<32xi8>
+    %1 = aievec.upd %arg1[%c0] {index = 0 : i8, offset = 0 : si32} : memref<32xi16>, vector<32xi16>
+    %2 = aievec.upd %arg2[%c0] {index = 0 : i8, offset = 0 : si32} : memref<16xi16>, vector<16xi16>
+    %3 = aievec.ups %2 {shift = 0 : i8} : vector<16xi16>, vector<16xi48>
+    %4 = aievec.mac %1, %0, %3 {xoffsets = "0x00000000", xoffsets_hi = "0x00000000", xsquare = "0x1010", xstart = "0", zoffsets = "0x03020100", zoffsets_hi = "0x07060504", zstart = "0", zstep = "1"} : vector<32xi16>, vector<32xi8>, vector<16xi48>
+    %5 = aievec.srs %4 {shift = 0 : i8} : vector<16xi48>, vector<16xi16>
+    vector.transfer_write %5, %arg2[%c0] : vector<16xi16>, memref<16xi16>
+    return
+  }
+}
+
+// CHECK: v32int8 [[ACT:v[0-9]+]] = *(v32int8 *)(v{{[0-9]+}} + v{{[0-9]+}});
+// CHECK: v32int16 [[WGT:v[0-9]+]]
+// CHECK: v16acc48 [[ACC:v[0-9]+]] = ups(v{{[0-9]+}}, 0);
+// CHECK: [[ACC]] = mac16([[ACC]], [[WGT]], 0, 0x00000000, 0x00000000, 0x1010, [[ACT]], 0, 0x03020100, 0x07060504, 1);
+// CHECK: v16int16 v{{[0-9]+}} = srs([[ACC]], 0);
@@ -0,0 +1,56 @@
+//===- simple.mlir ---------------------------------------------*- MLIR -*-===//
+//
+// This file is licensed under the Apache License v2.0 with LLVM Exceptions.
+// See https://llvm.org/LICENSE.txt for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+//
+// (c) Copyright 2022 Xilinx Inc.
+//
+//===----------------------------------------------------------------------===//
+
+// RUN: rm -rf %t && aie-compile --tmpdir=%t -j 2 %s | FileCheck %s
+// RUN: aie-translate --aie-generate-corelist %t/input_with_addresses.mlir | FileCheck %s
+// RUN: aie-translate --tilecol=1 --tilerow=3 --aie-generate-ldscript %t/input_with_addresses.mlir | diff - %t/core_1_3.ld.script
+// RUN: aie-translate --tilecol=2 --tilerow=3 --aie-generate-bcf %t/input_with_addresses.mlir | diff - %t/core_2_3.bcf
+// RUN: FileCheck --check-prefix=MLIR13 %s < %t/core_1_3.mlir
+// RUN: FileCheck --check-prefix=LL13 %s < %t/core_1_3.ll
+// RUN: FileCheck --check-prefix=LL23 %s < %t/core_2_3.ll
+// RUN: FileCheck --check-prefix=HOST %s < %t/aie_inc.cpp
+
+// CHECK: [(1,3,None),(2,3,"core_2_3.elf"),]
+
+// MLIR13: AIE.code_size = {{[0-9]+}} : i64
+// MLIR13: llvm.func @core13()
+
+// LL13: @a = {{.*}}global [4 x i32]
+// LL13: define void @core13()
+// LL13-NOT: define void @core23()
+
+// LL23: define void @core23()
+// LL23: call void @llvm.aie.lock.acquire.reg(i32 {{[0-9]+}}, i32 1)
+
+// HOST: void mlir_aie_configure_cores_column_1
+// HOST: void mlir_aie_initialize_locks
+
+module @simple {
+  %t13 = AIE.tile(1, 3)
+  %t23 = AIE.tile(2, 3)
+  %a = AIE.buffer(%t13) { sym_name = "a" } : memref<4xi32>
+  %l = AIE.lock(%t13, 0)
+  AIE.flow(%t13, Core : 0, %t23, Core : 0)
+  %c13 = AIE.core(%t13) {
+    %c0 = arith.constant 0 : index
+    %v = arith.constant 7 : i32
+    AIE.useLock(%l, Acquire, 0)
+    memref.store %v, %a[%c0] : memref<4xi32>
+    AIE.useLock(%l, Release, 1)
+    AIE.end
+  }
+  %c23 = AIE.core(%t23) {
+    %c0 = arith.constant 0 : index
+    AIE.useLock(%l, Acquire, 1)
+    %v = memref.load %a[%c0] : memref<4xi32>
+    AIE.useLock(%l, Release, 0)
+    AIE.end
+  } { elf_file = "core_2_3.elf" }
+}
@@ -0,0 +1,66 @@
+#
+# This file is licensed under the Apache License v2.0 with LLVM Exceptions.
+# See https://llvm.org/LICENSE.txt for license information.
+# SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+#
+# (c) Copyright 2022 Xilinx Inc.
+
+# Print the stage of some aiecc commands, and the profile of a made up aiecc
+# run.
+
+from aiecc import profile
+
+COMMANDS = [
+    ['aie-opt', '--aie-create-locks', '--aie-objectFifo-stateful-transform',
+     '--aie-lower-broadcast-packet', '--aie-create-packet-flows',
+     '--aie-assign-buffer-addresses', 'input.mlir'],
+    ['aie-opt', '--aie-create-pathfinder-flows', '--aie-lower-broadcast-packet',
+     '--aie-create-packet-flows', 'input_with_addresses.mlir'],
+    ['aie-opt', '--aie-create-flows', '--aie-lower-broadcast-packet',
+     '--aie-create-packet-flows', 'input_with_addresses.mlir'],
+    ['aie-translate', '--aie-generate-xaie', 'input_physical.mlir'],
+    ['aie-translate', '--mlir-to-llvmir', 'core_1_3.mlir'],
+    ['opt', '--passes=default<O2>,strip', 'core_1_3.ll'],
+    ['xchesscc_wrapper', 'aie', '-c', 'core_1_3.ll'],
+    ['xchesscc_wrapper', 'aie', '+l', 'core_1_3.bcf'],
+    ['clang', '--target=aie', 'core_1_3.o'],
+    ['clang', '--target=aarch64-linux-gnu', 'test.cpp'],
+]
+
+TIMING = """\
+===-------------------------------------------------------------------------===
+                         ... Execution time report ...
+===-------------------------------------------------------------------------===
+  Total Execution Time: 0.0300 seconds
+
+  ----Wall Time----  ----Name----
+    0.0200 ( 66.7%)  AIEPathfinderPass
+    0.0100 ( 33.3%)  AIEPacketFlowsPass
+    0.0300 (100.0%)  Total
+"""
+
+
+def main():
+    for command in COMMANDS:
+        print('%s: %s' % (profile.stage(command), ' '.join(command)))
+
+    timings, rest = profile.split_mlir_timing('warning\n' + TIMING)
+    print('timings: %s' % timings)
+    print('rest: %r' % rest)
+
+    # Each command runs from its given begin time until the current time.
+    profiler = profile.Profiler()
+    now = 0.0
+    profiler._now = lambda: now
+    for core, command, begin, now, passes in [
+            (None, COMMANDS[1], 0.0, 2.0, timings),
+            ((1, 3, None), COMMANDS[5], 2.0, 2.5, []),
+            ((2, 3, None), COMMANDS[5], 2.0, 3.0, []),
+            (None, COMMANDS[3], 3.0, 4.0, [])]:
+        profiler.set_core(core)
+        profiler.end(command, begin, passes)
+    print(profiler.summary())
+
+
+if __name__ == '__main__':
+    main()
@@ -0,0 +1,42 @@
+//===- profile.mlir --------------------------------------------*- MLIR -*-===//
+//
+// This file is licensed under the Apache License v2.0 with LLVM Exceptions.
+// See https://llvm.org/LICENSE.txt for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+//
+// (c) Copyright 2022 Xilinx Inc.
+//
+//===----------------------------------------------------------------------===//
+
+// The stages of the aiecc commands in the compile time profile, and its
+// summary.
+
+// RUN: %aiecc_python %S/Inputs/profile_report.py | FileCheck %s
+
+// Creating the packet flows is part of the lowering, only the routers are
+// counted as routing.
+// CHECK: lowering: aie-opt --aie-create-locks {{.*}} --aie-create-packet-flows
+// CHECK: routing: aie-opt --aie-create-pathfinder-flows
+// CHECK: routing: aie-opt --aie-create-flows
+// CHECK: host interface: aie-translate --aie-generate-xaie
+// CHECK: translation: aie-translate --mlir-to-llvmir
+// CHECK: backend compile: opt
+// CHECK: backend compile: xchesscc_wrapper aie -c
+// CHECK: link: xchesscc_wrapper aie +l
+// CHECK: link: clang --target=aie
+// CHECK: host compile: clang --target=aarch64-linux-gnu
+
+// CHECK: timings: [('AIEPathfinderPass', 0.02), ('AIEPacketFlowsPass', 0.01)]
+// CHECK: rest: 'warning\n'
+
+// CHECK: aiecc compile time: 4.000 s
+// CHECK: stage            commands    total (s)      max (s)
+// CHECK-NEXT: routing                 1        2.000        2.000
+// CHECK-NEXT: backend compile         2        1.500        1.000
+// CHECK-NEXT: host interface          1        1.000        1.000
+// CHECK: slowest cores:
+// CHECK-NEXT: core (2, 3)             1.000
+// CHECK-NEXT: core (1, 3)             0.500
+// CHECK: slowest MLIR passes:
+// CHECK-NEXT: AIEPathfinderPass                               0.020
+// CHECK-NEXT: AIEPacketFlowsPass                              0.010
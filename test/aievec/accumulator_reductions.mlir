@@ -0,0 +1,61 @@
+// RUN: aie-opt %s -affine-super-vectorize="virtual-vector-size=16 vectorize-reductions=true" --aie-vectorize="accumulator-reductions" -split-input-file | FileCheck %s
+
+// The two sums of products are joined into one mul/mac chain, and only the
+// end of the chain is moved out of the accumulator.
+// CHECK-LABEL: func.func @sum_of_products
+func.func @sum_of_products(%A: memref<2048xi16>, %B: memref<2048xi16>, %C: memref<2048xi16>, %D: memref<2048xi16>, %O: memref<2048xi16>) {
+  affine.for %i = 0 to 2048 {
+    %a = affine.load %A[%i] : memref<2048xi16>
+    %b = affine.load %B[%i] : memref<2048xi16>
+    %c = affine.load %C[%i] : memref<2048xi16>
+    %d = affine.load %D[%i] : memref<2048xi16>
+    %ab = arith.muli %a, %b : i16
+    %cd = arith.muli %c, %d : i16
+    %s1 = arith.addi %ab, %cd : i16
+    %ad = arith.muli %a, %d : i16
+    %bc = arith.muli %b, %c : i16
+    %s2 = arith.addi %ad, %bc : i16
+    %r = arith.subi %s1, %s2 : i16
+    affine.store %r, %O[%i] : memref<2048xi16>
+  }
+  return
+}
+
+// CHECK: %[[A:.*]] = aievec.upd %arg0
+// CHECK: %[[B:.*]] = aievec.upd %arg1
+// CHECK: %[[C:.*]] = aievec.upd %arg2
+// CHECK: %[[D:.*]] = aievec.upd %arg3
+// CHECK-NOT: aievec.srs
+// CHECK: %[[M0:.*]] = aievec.mul %[[A]], %[[B]] : vector<16xi16>, vector<16xi16>, vector<16xi48>
+// CHECK-NEXT: %[[M1:.*]] = aievec.mac %[[A]], %[[D]], %[[M0]] {fmsub = true} : vector<16xi16>, vector<16xi16>, vector<16xi48>
+// CHECK-NEXT: %[[M2:.*]] = aievec.mac %[[C]], %[[D]], %[[M1]] : vector<16xi16>, vector<16xi16>, vector<16xi48>
+// CHECK-NEXT: %[[M3:.*]] = aievec.mac %[[B]], %[[C]], %[[M2]] {fmsub = true} : vector<16xi16>, vector<16xi16>, vector<16xi48>
+// CHECK-NEXT: %[[R:.*]] = aievec.srs %[[M3]] {shift = 0 : i8} : vector<16xi48>, vector<16xi16>
+// CHECK-NEXT: vector.transfer_write %[[R]], %arg4
+
+// -----
+
+// The partial sums of the dot product stay in the accumulator across the
+// iterations of the loop.
+// CHECK-LABEL: func.func @dot
+func.func @dot(%A: memref<2048xi16>, %B: memref<2048xi16>) -> i16 {
+  %c0 = arith.constant 0 : i16
+  %sum = affine.for %i = 0 to 2048 iter_args(%acc = %c0) -> i16 {
+    %a = affine.load %A[%i] : memref<2048xi16>
+    %b = affine.load %B[%i] : memref<2048xi16>
+    %p = arith.muli %a, %b : i16
+    %s = arith.addi %acc, %p : i16
+    affine.yield %s : i16
+  }
+  return %sum : i16
+}
+
+// CHECK: %[[INIT:.*]] = aievec.ups %{{.*}} {shift = 0 : i8} : vector<16xi16>, vector<16xi48>
+// CHECK: %[[SUM:.*]] = scf.for %{{.*}} = %{{.*}} to %{{.*}} step %{{.*}} iter_args(%[[ACC:.*]] = %[[INIT]]) -> (vector<16xi48>) {
+// CHECK-NOT: aievec.ups
+// CHECK-NOT: aievec.srs
+// CHECK: %[[MAC:.*]] = aievec.mac %{{.*}}, %{{.*}}, %[[ACC]] : vector<16xi16>, vector<16xi16>, vector<16xi48>
+// CHECK-NEXT: scf.yield %[[MAC]] : vector<16xi48>
+// CHECK-NEXT: }
+// CHECK-NEXT: %[[R:.*]] = aievec.srs %[[SUM]] {shift = 0 : i8} : vector<16xi48>, vector<16xi16>
+// CHECK: vector.reduction <add>, %[[R]]
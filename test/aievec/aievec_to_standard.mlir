@@ -0,0 +1,94 @@
+// RUN: aie-opt %s --aievec-standard-lowering | FileCheck %s
+// RUN: aie-opt %s --aievec-standard-lowering --convert-vector-to-llvm --convert-memref-to-llvm --convert-func-to-llvm=use-bare-ptr-memref-call-conv --canonicalize | aie-translate --mlir-to-llvmir | FileCheck %s --check-prefix=LLVM
+
+// CHECK-DAG: func.func private @llvm.aie.upd.w.v32i16.v32i16.i32.v16i16(vector<32xi16>, i32, vector<16xi16>) -> vector<32xi16>
+// CHECK-DAG: func.func private @llvm.aie.mac16.v16i48.v16i48.v32i16.i32.i32.i32.i32.v16i16.i32.i32.i32.i32(vector<16xi48>, vector<32xi16>, i32, i32, i32, i32, vector<16xi16>, i32, i32, i32, i32) -> vector<16xi48>
+// CHECK-DAG: func.func private @llvm.aie.mac16.v16i48.v16i48.v32i16.i32.i32.i32.v16i16.i32.i32.i32(vector<16xi48>, vector<32xi16>, i32, i32, i32, vector<16xi16>, i32, i32, i32) -> vector<16xi48>
+// CHECK-DAG: func.func private @llvm.aie.srs.v16i16.v16i48.i32(vector<16xi48>, i32) -> vector<16xi16>
+// CHECK-DAG: func.func private @llvm.aie.select16.v16i32.i32.v16i32.i32.i32.i32.i32.i32(i32, vector<16xi32>, i32, i32, i32, i32, i32) -> vector<16xi32>
+
+// LLVM-DAG: declare <32 x i16> @llvm.aie.upd.w.v32i16.v32i16.i32.v16i16(<32 x i16>, i32, <16 x i16>)
+// LLVM-DAG: declare <16 x i48> @llvm.aie.mac16.v16i48.v16i48.v32i16.i32.i32.i32.i32.v16i16.i32.i32.i32.i32(<16 x i48>, <32 x i16>, i32, i32, i32, i32, <16 x i16>, i32, i32, i32, i32)
+// LLVM-DAG: declare <16 x i16> @llvm.aie.srs.v16i16.v16i48.i32(<16 x i48>, i32)
+
+// CHECK-LABEL: func.func @upd_mac_srs(%arg0: memref<64xi16>, %arg1: index, %arg2: vector<16xi16>, %arg3: vector<16xi48>) -> vector<16xi16> {
+// CHECK: %[[L0:.*]] = vector.load %arg0[%arg1] : memref<64xi16>, vector<16xi16>
+// CHECK: %[[Z:.*]] = arith.constant dense<0> : vector<32xi16>
+// CHECK: %[[I0:.*]] = arith.constant 0 : i32
+// CHECK: %[[X0:.*]] = call @llvm.aie.upd.w.v32i16.v32i16.i32.v16i16(%[[Z]], %[[I0]], %[[L0]]) : (vector<32xi16>, i32, vector<16xi16>) -> vector<32xi16>
+// CHECK: %[[OFF:.*]] = arith.constant 16 : index
+// CHECK: %[[IDX:.*]] = arith.addi %arg1, %[[OFF]] : index
+// CHECK: %[[L1:.*]] = vector.load %arg0[%[[IDX]]] : memref<64xi16>, vector<16xi16>
+// CHECK: %[[I1:.*]] = arith.constant 1 : i32
+// CHECK: %[[X1:.*]] = call @llvm.aie.upd.w.v32i16.v32i16.i32.v16i16(%[[X0]], %[[I1]], %[[L1]]) : (vector<32xi16>, i32, vector<16xi16>) -> vector<32xi16>
+// CHECK: %[[XSTART:.*]] = arith.constant 2 : i32
+// CHECK: %[[XOFF:.*]] = arith.constant 50462976 : i32
+// CHECK: %[[XOFFHI:.*]] = arith.constant 117835012 : i32
+// CHECK: %[[XSQ:.*]] = arith.constant 8464 : i32
+// CHECK: %[[ZSTART:.*]] = arith.constant 4 : i32
+// CHECK: %[[ZOFF:.*]] = arith.constant 0 : i32
+// CHECK: %[[ZOFFHI:.*]] = arith.constant 0 : i32
+// CHECK: %[[ZSTEP:.*]] = arith.constant 1 : i32
+// CHECK: %[[ACC:.*]] = call @llvm.aie.mac16.v16i48.v16i48.v32i16.i32.i32.i32.i32.v16i16.i32.i32.i32.i32(%arg3, %[[X1]], %[[XSTART]], %[[XOFF]], %[[XOFFHI]], %[[XSQ]], %arg2, %[[ZSTART]], %[[ZOFF]], %[[ZOFFHI]], %[[ZSTEP]])
+// CHECK: %[[SHIFT:.*]] = arith.constant 0 : i32
+// CHECK: %[[R:.*]] = call @llvm.aie.srs.v16i16.v16i48.i32(%[[ACC]], %[[SHIFT]]) : (vector<16xi48>, i32) -> vector<16xi16>
+// CHECK: return %[[R]] : vector<16xi16>
+
+// LLVM-LABEL: define <16 x i16> @upd_mac_srs(
+// LLVM: call <32 x i16> @llvm.aie.upd.w.v32i16.v32i16.i32.v16i16(<32 x i16> zeroinitializer, i32 0, <16 x i16> %{{.*}})
+// LLVM: call <32 x i16> @llvm.aie.upd.w.v32i16.v32i16.i32.v16i16(<32 x i16> %{{.*}}, i32 1, <16 x i16> %{{.*}})
+// LLVM: call <16 x i48> @llvm.aie.mac16.v16i48.v16i48.v32i16.i32.i32.i32.i32.v16i16.i32.i32.i32.i32(<16 x i48> %{{.*}}, <32 x i16> %{{.*}}, i32 2, i32 50462976, i32 117835012, i32 8464, <16 x i16> %{{.*}}, i32 4, i32 0, i32 0, i32 1)
+// LLVM: call <16 x i16> @llvm.aie.srs.v16i16.v16i48.i32(<16 x i48> %{{.*}}, i32 0)
+func.func @upd_mac_srs(%m: memref<64xi16>, %i: index, %z: vector<16xi16>, %acc: vector<16xi48>) -> vector<16xi16> {
+  %0 = aievec.upd %m[%i] {index = 0 : i8, offset = 0 : si32} : memref<64xi16>, vector<32xi16>
+  %1 = aievec.upd %m[%i], %0 {index = 1 : i8, offset = 256 : si32} : memref<64xi16>, vector<32xi16>
+  %2 = aievec.mac %1, %z, %acc {xoffsets = "0x03020100", xoffsets_hi = "0x07060504", xsquare = "0x2110", xstart = "2", zoffsets = "0", zoffsets_hi = "0", zstart = "4", zstep = "1"} : vector<32xi16>, vector<16xi16>, vector<16xi48>
+  %3 = aievec.srs %2 {shift = 0 : i8} : vector<16xi48>, vector<16xi16>
+  return %3 : vector<16xi16>
+}
+
+// The simple integer add scheme is a lane-wise add, and the lane selection
+// attributes of select are passed as i32 arguments.
+// CHECK-LABEL: func.func @add_select(%arg0: vector<16xi32>, %arg1: vector<16xi32>) -> vector<16xi32> {
+// CHECK: %[[S:.*]] = arith.addi %arg0, %arg1 : vector<16xi32>
+// CHECK: %[[SEL:.*]] = arith.constant -858993460 : i32
+// CHECK: %[[XSTART:.*]] = arith.constant 0 : i32
+// CHECK: %[[XOFF:.*]] = arith.constant 1985229328 : i32
+// CHECK: %[[XOFFHI:.*]] = arith.constant -19088744 : i32
+// CHECK: %[[YSTART:.*]] = arith.constant 0 : i32
+// CHECK: %[[YOFF:.*]] = arith.constant 1985229328 : i32
+// CHECK: %[[R:.*]] = call @llvm.aie.select16.v16i32.i32.v16i32.i32.i32.i32.i32.i32(%[[SEL]], %[[S]], %[[XSTART]], %[[XOFF]], %[[XOFFHI]], %[[YSTART]], %[[YOFF]])
+// CHECK: return %[[R]] : vector<16xi32>
+
+// LLVM-LABEL: define <16 x i32> @add_select(
+// LLVM: %[[S:.*]] = add <16 x i32> %{{.*}}, %{{.*}}
+// LLVM: call <16 x i32> @llvm.aie.select16.v16i32.i32.v16i32.i32.i32.i32.i32.i32(i32 -858993460, <16 x i32> %[[S]], i32 0, i32 1985229328, i32 -19088744, i32 0, i32 1985229328)
+func.func @add_select(%a: vector<16xi32>, %b: vector<16xi32>) -> vector<16xi32> {
+  %0 = aievec.add %a, %b : vector<16xi32>, vector<16xi32>, vector<16xi32>
+  %1 = aievec.select %0 {select = "0xcccccccc", xoffsets = "0x76543210", xoffsets_hi = "0xfedcba98", xstart = "0", yoffsets = "0x76543210", ystart = "0"} : vector<16xi32>, vector<16xi32>
+  return %1 : vector<16xi32>
+}
+
+// ups and srs are no-ops for floats, and the simple float mul is fpmul.
+// CHECK-LABEL: func.func @fp_mul(%arg0: vector<8xf32>, %arg1: vector<8xf32>) -> vector<8xf32> {
+// CHECK-NEXT: %[[M:.*]] = call @llvm.aie.fpmul.v8f32.v8f32.v8f32(%arg0, %arg1) : (vector<8xf32>, vector<8xf32>) -> vector<8xf32>
+// CHECK-NEXT: return %[[M]] : vector<8xf32>
+func.func @fp_mul(%a: vector<8xf32>, %b: vector<8xf32>) -> vector<8xf32> {
+  %0 = aievec.ups %a {shift = 0 : i8} : vector<8xf32>, vector<8xf32>
+  %1 = aievec.mul %0, %b : vector<8xf32>, vector<8xf32>, vector<8xf32>
+  %2 = aievec.srs %1 {shift = 0 : i8} : vector<8xf32>, vector<8xf32>
+  return %2 : vector<8xf32>
+}
+
+// The lane selection arguments are only passed for the attributes set on the
+// op, so two macs of the same types with different attributes call intrinsics
+// with different signatures, and names.
+// CHECK-LABEL: func.func @mac_lane_selection(%arg0: vector<32xi16>, %arg1: vector<16xi16>, %arg2: vector<16xi48>) -> vector<16xi48> {
+// CHECK: %[[ACC:.*]] = call @llvm.aie.mac16.v16i48.v16i48.v32i16.i32.i32.i32.i32.v16i16.i32.i32.i32.i32(%arg2, %arg0,
+// CHECK: %[[R:.*]] = call @llvm.aie.mac16.v16i48.v16i48.v32i16.i32.i32.i32.v16i16.i32.i32.i32(%[[ACC]], %arg0,
+// CHECK: return %[[R]] : vector<16xi48>
+func.func @mac_lane_selection(%x: vector<32xi16>, %z: vector<16xi16>, %acc: vector<16xi48>) -> vector<16xi48> {
+  %0 = aievec.mac %x, %z, %acc {xoffsets = "0x03020100", xoffsets_hi = "0x07060504", xsquare = "0x2110", xstart = "0", zoffsets = "0", zoffsets_hi = "0", zstart = "0", zstep = "1"} : vector<32xi16>, vector<16xi16>, vector<16xi48>
+  %1 = aievec.mac %x, %z, %0 {xoffsets = "0x03020100", xoffsets_hi = "0x07060504", xstart = "2", zoffsets = "0", zoffsets_hi = "0", zstart = "2"} : vector<32xi16>, vector<16xi16>, vector<16xi48>
+  return %1 : vector<16xi48>
+}
@@ -0,0 +1,10 @@
+// RUN: aie-opt %s --aievec-standard-lowering -verify-diagnostics
+
+// The module already declares the intrinsic with another signature.
+func.func private @llvm.aie.srs.v16i16.v16i48.i32(vector<16xi48>, i32) -> vector<16xi32>
+
+func.func @srs_mismatch(%acc: vector<16xi48>) -> vector<16xi16> {
+  // expected-error@+1 {{failed to legalize operation 'aievec.srs'}}
+  %0 = aievec.srs %acc {shift = 0 : i8} : vector<16xi48>, vector<16xi16>
+  return %0 : vector<16xi16>
+}
@@ -0,0 +1,97 @@
+// RUN: aie-opt %s -canonicalize | FileCheck %s
+
+// CHECK-LABEL: func.func @srs_ups(%arg0: vector<8xi32>) -> vector<8xi32> {
+// CHECK-NEXT: return %arg0 : vector<8xi32>
+func.func @srs_ups(%v: vector<8xi32>) -> vector<8xi32> {
+  %0 = aievec.ups %v {shift = 4 : i8} : vector<8xi32>, vector<8xi80>
+  %1 = aievec.srs %0 {shift = 4 : i8} : vector<8xi80>, vector<8xi32>
+  return %1 : vector<8xi32>
+}
+
+// CHECK-LABEL: func.func @srs_ups_shift_mismatch
+// CHECK: aievec.ups
+// CHECK: aievec.srs
+func.func @srs_ups_shift_mismatch(%v: vector<8xi32>) -> vector<8xi32> {
+  %0 = aievec.ups %v {shift = 0 : i8} : vector<8xi32>, vector<8xi80>
+  %1 = aievec.srs %0 {shift = 4 : i8} : vector<8xi80>, vector<8xi32>
+  return %1 : vector<8xi32>
+}
+
+// CHECK-LABEL: func.func @ext_concat(%arg0: vector<16xi16>, %arg1: vector<16xi16>) -> vector<16xi16> {
+// CHECK-NEXT: return %arg1 : vector<16xi16>
+func.func @ext_concat(%a: vector<16xi16>, %b: vector<16xi16>) -> vector<16xi16> {
+  %0 = aievec.concat %a, %b : vector<16xi16>, vector<32xi16>
+  %1 = aievec.ext %0 {index = 1 : i8} : vector<32xi16>, vector<16xi16>
+  return %1 : vector<16xi16>
+}
+
+// CHECK-LABEL: func.func @concat_ext(%arg0: vector<32xi16>) -> vector<32xi16> {
+// CHECK-NEXT: return %arg0 : vector<32xi16>
+func.func @concat_ext(%v: vector<32xi16>) -> vector<32xi16> {
+  %0 = aievec.ext %v {index = 0 : i8} : vector<32xi16>, vector<16xi16>
+  %1 = aievec.ext %v {index = 1 : i8} : vector<32xi16>, vector<16xi16>
+  %2 = aievec.concat %0, %1 : vector<16xi16>, vector<32xi16>
+  return %2 : vector<32xi16>
+}
+
+// CHECK-LABEL: func.func @concat_ext_swapped
+// CHECK: aievec.concat
+func.func @concat_ext_swapped(%v: vector<32xi16>) -> vector<32xi16> {
+  %0 = aievec.ext %v {index = 1 : i8} : vector<32xi16>, vector<16xi16>
+  %1 = aievec.ext %v {index = 0 : i8} : vector<32xi16>, vector<16xi16>
+  %2 = aievec.concat %0, %1 : vector<16xi16>, vector<32xi16>
+  return %2 : vector<32xi16>
+}
+
+// CHECK-LABEL: func.func @upd_same_interval(%arg0: memref<64xi16>, %arg1: index) -> vector<32xi16> {
+// CHECK-NEXT: %[[V:.*]] = aievec.upd %arg0[%arg1] {index = 0 : i8, offset = 0 : si32} : memref<64xi16>, vector<32xi16>
+// CHECK-NEXT: return %[[V]] : vector<32xi16>
+func.func @upd_same_interval(%m: memref<64xi16>, %i: index) -> vector<32xi16> {
+  %0 = aievec.upd %m[%i] {index = 0 : i8, offset = 0 : si32} : memref<64xi16>, vector<32xi16>
+  %1 = aievec.upd %m[%i], %0 {index = 0 : i8, offset = 0 : si32} : memref<64xi16>, vector<32xi16>
+  return %1 : vector<32xi16>
+}
+
+// CHECK-LABEL: func.func @upd_other_half
+// CHECK: aievec.upd
+// CHECK: aievec.upd
+func.func @upd_other_half(%m: memref<64xi16>, %i: index) -> vector<32xi16> {
+  %0 = aievec.upd %m[%i] {index = 0 : i8, offset = 0 : si32} : memref<64xi16>, vector<32xi16>
+  %1 = aievec.upd %m[%i], %0 {index = 1 : i8, offset = 256 : si32} : memref<64xi16>, vector<32xi16>
+  return %1 : vector<32xi16>
+}
+
+// A store between the two reads may change the lanes, so the second read is
+// kept.
+// CHECK-LABEL: func.func @upd_after_store
+// CHECK: aievec.upd
+// CHECK: memref.store
+// CHECK: aievec.upd
+func.func @upd_after_store(%m: memref<64xi16>, %i: index, %x: i16) -> vector<32xi16> {
+  %0 = aievec.upd %m[%i] {index = 0 : i8, offset = 0 : si32} : memref<64xi16>, vector<32xi16>
+  memref.store %x, %m[%i] : memref<64xi16>
+  %1 = aievec.upd %m[%i], %0 {index = 0 : i8, offset = 0 : si32} : memref<64xi16>, vector<32xi16>
+  return %1 : vector<32xi16>
+}
+
+// CHECK-LABEL: func.func @select_identity(%arg0: vector<16xi32>) -> vector<16xi32> {
+// CHECK-NEXT: return %arg0 : vector<16xi32>
+func.func @select_identity(%v: vector<16xi32>) -> vector<16xi32> {
+  %0 = aievec.select %v {select = "0x00000000", xoffsets = "0x76543210", xoffsets_hi = "0xfedcba98", xstart = "0", yoffsets = "0x76543210", ystart = "0"} : vector<16xi32>, vector<16xi32>
+  return %0 : vector<16xi32>
+}
+
+// CHECK-LABEL: func.func @select_shuffle
+// CHECK: aievec.select
+func.func @select_shuffle(%v: vector<16xi32>) -> vector<16xi32> {
+  %0 = aievec.select %v {select = "0xcccccccc", xoffsets = "0x76543210", xoffsets_hi = "0xfedcba98", xstart = "0", yoffsets = "0x76543210", ystart = "0"} : vector<16xi32>, vector<16xi32>
+  return %0 : vector<16xi32>
+}
+
+// CHECK-LABEL: func.func @pack_unpack(%arg0: vector<16xi8>) -> vector<16xi8> {
+// CHECK-NEXT: return %arg0 : vector<16xi8>
+func.func @pack_unpack(%v: vector<16xi8>) -> vector<16xi8> {
+  %0 = aievec.unpack %v : vector<16xi8>, vector<16xi16>
+  %1 = aievec.pack %0 : vector<16xi16>, vector<16xi8>
+  return %1 : vector<16xi8>
+}
@@ -0,0 +1,51 @@
+// RUN: aie-opt %s -affine-super-vectorize="virtual-vector-size=8" --aie-vectorize -unaligned-loads-check=false -split-input-file | FileCheck %s
+
+//CHECK-LABEL: func.func @conv1d(%arg0: memref<2048xi32>, %arg1: memref<4xi16>, %arg2: memref<2044xi32>) {
+func.func @conv1d (%A: memref<2048xi32>, %B: memref<4xi16>, %C: memref<2044xi32>) {
+    affine.for %arg3 = 0 to 2044 {
+        //Load the output point
+        %ci = affine.load %C[%arg3] : memref<2044xi32>
+
+        //first point
+        %a0 = affine.load %A[%arg3+0] : memref<2048xi32>
+        %b0i = affine.load %B[0] : memref<4xi16>
+        %b0 = arith.extsi %b0i : i16 to i32
+        %p0 = arith.muli %a0, %b0 : i32
+        %c0 = arith.addi %ci, %p0 : i32
+
+        //second point
+        %a1 = affine.load %A[%arg3+1] : memref<2048xi32>
+        %b1i = affine.load %B[1] : memref<4xi16>
+        %b1 = arith.extsi %b1i : i16 to i32
+        %p1 = arith.muli %a1, %b1 : i32
+        %c1 = arith.addi %c0, %p1 : i32
+
+        //third point
+        %a2 = affine.load %A[%arg3+2] : memref<2048xi32>
+        %b2i = affine.load %B[2] : memref<4xi16>
+        %b2 = arith.extsi %b2i : i16 to i32
+        %p2 = arith.muli %a2, %b2 : i32
+        %c2 = arith.addi %c1, %p2 : i32
+
+        //fourth point
+        %a3 = affine.load %A[%arg3+3] : memref<2048xi32>
+        %b3i = affine.load %B[3] : memref<4xi16>
+        %b3 = arith.extsi %b3i : i16 to i32
+        %p3 = arith.muli %a3, %b3 : i32
+        %c3 = arith.addi %c2, %p3 : i32
+
+        //Store accumulated sum
+        affine.store %c3, %C[%arg3] : memref<2044xi32>
+    }
+    return
+}
+
+// The i16 filter is the zbuff of the 32x16 scheme, and pairs of taps are
+// fused into the 2-column lmac8 intrinsic.
+//CHECK: %[[FILT:[0-9]+]] = aievec.upd %arg1[%c0] {index = 0 : i8, offset = 0 : si32} : memref<4xi16>, vector<16xi16>
+//CHECK-NOT: arith.extsi
+//CHECK: %[[ACC:[0-9]+]] = aievec.ups %{{.*}} {shift = 0 : i8} : vector<8xi32>, vector<8xi80>
+//CHECK: %[[MAC0:[0-9]+]] = aievec.mac %{{.*}}, %[[FILT]], %[[ACC]] {xoffsets = "0x76543210", xstart = "0", zoffsets = "0", zstart = "0", zstep = "1"} : vector<16xi32>, vector<16xi16>, vector<8xi80>
+//CHECK: %[[MAC1:[0-9]+]] = aievec.mac %{{.*}}, %[[FILT]], %[[MAC0]] {xoffsets = "0x76543210", xstart = "2", zoffsets = "0", zstart = "2", zstep = "1"} : vector<16xi32>, vector<16xi16>, vector<8xi80>
+//CHECK: %[[RES:[0-9]+]] = aievec.srs %[[MAC1]] {shift = 0 : i8} : vector<8xi80>, vector<8xi32>
+//CHECK: vector.transfer_write %[[RES]], %arg2[%arg3] {in_bounds = [true]} : vector<8xi32>, memref<2044xi32>
@@ -0,0 +1,34 @@
+// RUN: aie-opt %s -affine-super-vectorize="virtual-vector-size=8" --aie-vectorize="annotate-cost" -unaligned-loads-check=false | FileCheck %s
+
+//CHECK-LABEL: func.func @conv1d_stride2(%arg0: memref<2048xi32>, %arg1: memref<4xi16>, %arg2: memref<2044xi32>) {
+func.func @conv1d_stride2 (%A: memref<2048xi32>, %B: memref<4xi16>, %C: memref<2044xi32>) {
+    affine.for %arg3 = 0 to 2044 {
+        //Load the output point
+        %ci = affine.load %C[%arg3] : memref<2044xi32>
+
+        //first point
+        %a0 = affine.load %A[%arg3+0] : memref<2048xi32>
+        %b0i = affine.load %B[0] : memref<4xi16>
+        %b0 = arith.extsi %b0i : i16 to i32
+        %p0 = arith.muli %a0, %b0 : i32
+        %c0 = arith.addi %ci, %p0 : i32
+
+        //third point
+        %a2 = affine.load %A[%arg3+2] : memref<2048xi32>
+        %b2i = affine.load %B[2] : memref<4xi16>
+        %b2 = arith.extsi %b2i : i16 to i32
+        %p2 = arith.muli %a2, %b2 : i32
+        %c2 = arith.addi %c0, %p2 : i32
+
+        //Store accumulated sum
+        affine.store %c2, %C[%arg3] : memref<2044xi32>
+    }
+    return
+}
+
+// The two taps are two lanes apart, but the columns of the 32x16 scheme read
+// consecutive xbuff lanes. The cost model rejects fusing them, and each tap
+// occupies a single column of its own lmac8 intrinsic.
+//CHECK: %[[MAC0:[0-9]+]] = aievec.mac %{{.*}}, %{{.*}}, %{{.*}} {aievec.cycles = 1 : i32, aievec.scheme = "8x1", xoffsets = "0x76543210", xstart = "0", zoffsets = "0", zstart = "0", zstep = "7"} : vector<16xi32>, vector<16xi16>, vector<8xi80>
+//CHECK: %[[MAC1:[0-9]+]] = aievec.mac %{{.*}}, %{{.*}}, %[[MAC0]] {aievec.cycles = 1 : i32, aievec.scheme = "8x1", xoffsets = "0x76543210", xstart = "2", zoffsets = "0", zstart = "2", zstep = "5"} : vector<16xi32>, vector<16xi16>, vector<8xi80>
+//CHECK: aievec.srs %[[MAC1]]
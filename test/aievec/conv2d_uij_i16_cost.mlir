@@ -0,0 +1,79 @@
+// RUN: aie-opt %s -affine-super-vectorize="virtual-vector-size=16" --aie-vectorize="shift=10 zero-offset=4 annotate-cost" | FileCheck %s
+
+// CHECK-LABEL: func.func @conv2d(%arg0: memref<18x288xi16>, %arg1: memref<12xi16>, %arg2: memref<16x256xi16>) {
+func.func @conv2d (%A: memref<18x288xi16>, %B: memref<12xi16>, %C: memref<16x256xi16>) {
+    affine.for %arg3 = 0 to 16 {
+        affine.for %arg4 = 0 to 256 {
+            //First row
+            //first point 
+            %a11 = affine.load %A[%arg3, %arg4+0] : memref<18x288xi16>
+            %b11 = affine.load %B[0] : memref<12xi16>
+            %p11 = arith.muli %a11, %b11 : i16
+
+            //second point 
+            %a12 = affine.load %A[%arg3, %arg4+1] : memref<18x288xi16>
+            %b12 = affine.load %B[1] : memref<12xi16>
+            %p12 = arith.muli %a12, %b12 : i16
+            %c12 = arith.addi %p11, %p12 : i16
+
+            //third point 
+            %a13 = affine.load %A[%arg3, %arg4+2] : memref<18x288xi16>
+            %b13 = affine.load %B[2] : memref<12xi16>
+            %p13 = arith.muli %a13, %b13 : i16
+            %c13 = arith.addi %c12, %p13 : i16
+
+            //Second row
+            //first point 
+            %a21 = affine.load %A[%arg3+1, %arg4+0] : memref<18x288xi16>
+            %b21 = affine.load %B[4] : memref<12xi16>
+            %p21 = arith.muli %a21, %b21 : i16
+            %c21 = arith.addi %c13, %p21 : i16
+
+            //second point 
+            %a22 = affine.load %A[%arg3+1, %arg4+1] : memref<18x288xi16>
+            %b22 = affine.load %B[5] : memref<12xi16>
+            %p22 = arith.muli %a22, %b22 : i16
+            %c22 = arith.addi %c21, %p22 : i16
+
+            //third point 
+            %a23 = affine.load %A[%arg3+1, %arg4+2] : memref<18x288xi16>
+            %b23 = affine.load %B[6] : memref<12xi16>
+            %p23 = arith.muli %a23, %b23 : i16
+            %c23 = arith.addi %c22, %p23 : i16
+
+            //Third row
+            //first point 
+            %a31 = affine.load %A[%arg3+2, %arg4+0] : memref<18x288xi16>
+            %b31 = affine.load %B[8] : memref<12xi16>
+            %p31 = arith.muli %a31, %b31 : i16
+            %c31 = arith.addi %c23, %p31 : i16
+
+            //second point 
+            %a32 = affine.load %A[%arg3+2, %arg4+1] : memref<18x288xi16>
+            %b32 = affine.load %B[9] : memref<12xi16>
+            %p32 = arith.muli %a32, %b32 : i16
+            %c32 = arith.addi %c31, %p32 : i16
+
+            //third point 
+            %a33 = affine.load %A[%arg3+2, %arg4+2] : memref<18x288xi16>
+            %b33 = affine.load %B[10] : memref<12xi16>
+            %p33 = arith.muli %a33, %b33 : i16
+            %c33 = arith.addi %c32, %p33 : i16
+
+            //Store accumulated sum
+            affine.store %c33, %C[%arg3, %arg4] : memref<16x256xi16>
+        }
+    }
+    return
+}
+
+// The first two taps of each filter row are fused into the two columns of the
+// 16x16 intrinsic. The third tap is alone in its chain, and occupies a single
+// column. The filter is a splat operand, so each chain only loads its row.
+//CHECK: %[[UPD:.*]] = aievec.upd %arg0[%arg3, %arg4], %{{.*}} {index = 1 : i8, offset = 256 : si32}
+//CHECK-NEXT: %[[MUL:.*]] = aievec.mul %[[UPD]], %{{.*}} {aievec.cycles = 1 : i32, aievec.scheme = "16x2", xoffsets = "0x03020100", xoffsets_hi = "0x07060504", xsquare = "0x2110", xstart = "0", zoffsets = "0", zoffsets_hi = "0", zstart = "0", zstep = "1"} : vector<32xi16>, vector<16xi16>, vector<16xi48>
+//CHECK-NEXT: %[[MAC:.*]] = aievec.mac %[[UPD]], %{{.*}}, %[[MUL]] {aievec.cycles = 1 : i32, aievec.scheme = "16x1", xoffsets = "0x03020100", xoffsets_hi = "0x07060504", xsquare = "0x2110", xstart = "2", zoffsets = "0", zoffsets_hi = "0", zstart = "2", zstep = "1"} : vector<32xi16>, vector<16xi16>, vector<16xi48>
+//CHECK: aievec.mac %{{.*}} {aievec.cycles = 1 : i32, aievec.scheme = "16x2", {{.*}}zstart = "4"
+//CHECK: aievec.mac %{{.*}} {aievec.cycles = 1 : i32, aievec.scheme = "16x1", {{.*}}zstart = "6"
+//CHECK: aievec.mac %{{.*}} {aievec.cycles = 1 : i32, aievec.scheme = "16x2", {{.*}}zstart = "8"
+//CHECK: aievec.mac %{{.*}} {aievec.cycles = 1 : i32, aievec.scheme = "16x1", {{.*}}zstart = "10"
@@ -0,0 +1,109 @@
+// RUN: aie-opt %s -affine-super-vectorize="virtual-vector-size=16" --aie-vectorize="shift=10 zero-offset=4 pipeline-loads" 2>&1 | FileCheck %s
+
+// Estimated cycles per iteration of the vectorized loop, before and after
+// pipelining the loads.
+//CHECK: remark: pipelined loads of 3 vector(s); estimated cycles per iteration: 16 -> 7
+
+// CHECK-LABEL: func.func @conv2d(%arg0: memref<18x288xi16>, %arg1: memref<12xi16>, %arg2: memref<16x256xi16>) {
+func.func @conv2d (%A: memref<18x288xi16>, %B: memref<12xi16>, %C: memref<16x256xi16>) {
+    affine.for %arg3 = 0 to 16 {
+        affine.for %arg4 = 0 to 256 {
+            //First row
+            //first point 
+            %a11 = affine.load %A[%arg3, %arg4+0] : memref<18x288xi16>
+            %b11 = affine.load %B[0] : memref<12xi16>
+            %p11 = arith.muli %a11, %b11 : i16
+
+            //second point 
+            %a12 = affine.load %A[%arg3, %arg4+1] : memref<18x288xi16>
+            %b12 = affine.load %B[1] : memref<12xi16>
+            %p12 = arith.muli %a12, %b12 : i16
+            %c12 = arith.addi %p11, %p12 : i16
+
+            //third point 
+            %a13 = affine.load %A[%arg3, %arg4+2] : memref<18x288xi16>
+            %b13 = affine.load %B[2] : memref<12xi16>
+            %p13 = arith.muli %a13, %b13 : i16
+            %c13 = arith.addi %c12, %p13 : i16
+
+            //Second row
+            //first point 
+            %a21 = affine.load %A[%arg3+1, %arg4+0] : memref<18x288xi16>
+            %b21 = affine.load %B[4] : memref<12xi16>
+            %p21 = arith.muli %a21, %b21 : i16
+            %c21 = arith.addi %c13, %p21 : i16
+
+            //second point 
+            %a22 = affine.load %A[%arg3+1, %arg4+1] : memref<18x288xi16>
+            %b22 = affine.load %B[5] : memref<12xi16>
+            %p22 = arith.muli %a22, %b22 : i16
+            %c22 = arith.addi %c21, %p22 : i16
+
+            //third point 
+            %a23 = affine.load %A[%arg3+1, %arg4+2] : memref<18x288xi16>
+            %b23 = affine.load %B[6] : memref<12xi16>
+            %p23 = arith.muli %a23, %b23 : i16
+            %c23 = arith.addi %c22, %p23 : i16
+
+            //Third row
+            //first point 
+            %a31 = affine.load %A[%arg3+2, %arg4+0] : memref<18x288xi16>
+            %b31 = affine.load %B[8] : memref<12xi16>
+            %p31 = arith.muli %a31, %b31 : i16
+            %c31 = arith.addi %c23, %p31 : i16
+
+            //second point 
+            %a32 = affine.load %A[%arg3+2, %arg4+1] : memref<18x288xi16>
+            %b32 = affine.load %B[9] : memref<12xi16>
+            %p32 = arith.muli %a32, %b32 : i16
+            %c32 = arith.addi %c31, %p32 : i16
+
+            //third point 
+            %a33 = affine.load %A[%arg3+2, %arg4+2] : memref<18x288xi16>
+            %b33 = affine.load %B[10] : memref<12xi16>
+            %p33 = arith.muli %a33, %b33 : i16
+            %c33 = arith.addi %c32, %p33 : i16
+
+            //Store accumulated sum
+            affine.store %c33, %C[%arg3, %arg4] : memref<16x256xi16>
+        }
+    }
+    return
+}
+
+// The rows for iteration i+1 of the vectorized loop are loaded at the start of
+// iteration i, and carried to the next iteration. The rows for the first
+// iteration are loaded before the loop, and the last iteration is peeled.
+//CHECK: scf.for %[[I:.*]] = %{{.*}} to %{{.*}} step %{{.*}} {
+//CHECK: %[[P0:.*]] = aievec.upd %arg0[%[[I]], %[[LB:.*]]] {index = 0 : i8, offset = 0 : si32} : memref<18x288xi16>, vector<32xi16>
+//CHECK-NEXT: %[[L0:.*]] = aievec.upd %arg0[%[[I]], %[[LB]]], %[[P0]] {index = 1 : i8, offset = 256 : si32} : memref<18x288xi16>, vector<32xi16>
+//CHECK: %[[P1:.*]] = aievec.upd %arg0[%[[I1:.*]], %[[LB]]] {index = 0 : i8, offset = 0 : si32} : memref<18x288xi16>, vector<32xi16>
+//CHECK-NEXT: %[[L1:.*]] = aievec.upd %arg0[%[[I1]], %[[LB]]], %[[P1]] {index = 1 : i8, offset = 256 : si32} : memref<18x288xi16>, vector<32xi16>
+//CHECK: %[[P2:.*]] = aievec.upd %arg0[%[[I2:.*]], %[[LB]]] {index = 0 : i8, offset = 0 : si32} : memref<18x288xi16>, vector<32xi16>
+//CHECK-NEXT: %[[L2:.*]] = aievec.upd %arg0[%[[I2]], %[[LB]]], %[[P2]] {index = 1 : i8, offset = 256 : si32} : memref<18x288xi16>, vector<32xi16>
+//CHECK: %[[R:.*]]:3 = scf.for %[[J:.*]] = %{{.*}} to %{{.*}} step %{{.*}} iter_args(%[[W0:.*]] = %[[L0]], %[[W1:.*]] = %[[L1]], %[[W2:.*]] = %[[L2]]) -> (vector<32xi16>, vector<32xi16>, vector<32xi16>) {
+//CHECK: %[[N:.*]] = arith.addi %[[J]], %{{.*}} : index
+//CHECK-NEXT: %[[N0:.*]] = aievec.upd %arg0[%[[I]], %[[N]]] {index = 0 : i8, offset = 0 : si32} : memref<18x288xi16>, vector<32xi16>
+//CHECK-NEXT: %[[M0:.*]] = aievec.upd %arg0[%[[I]], %[[N]]], %[[N0]] {index = 1 : i8, offset = 256 : si32} : memref<18x288xi16>, vector<32xi16>
+//CHECK-NEXT: %[[N1:.*]] = aievec.upd %arg0[%[[I1]], %[[N]]] {index = 0 : i8, offset = 0 : si32} : memref<18x288xi16>, vector<32xi16>
+//CHECK-NEXT: %[[M1:.*]] = aievec.upd %arg0[%[[I1]], %[[N]]], %[[N1]] {index = 1 : i8, offset = 256 : si32} : memref<18x288xi16>, vector<32xi16>
+//CHECK-NEXT: %[[N2:.*]] = aievec.upd %arg0[%[[I2]], %[[N]]] {index = 0 : i8, offset = 0 : si32} : memref<18x288xi16>, vector<32xi16>
+//CHECK-NEXT: %[[M2:.*]] = aievec.upd %arg0[%[[I2]], %[[N]]], %[[N2]] {index = 1 : i8, offset = 256 : si32} : memref<18x288xi16>, vector<32xi16>
+//CHECK-NEXT: %[[MUL:.*]] = aievec.mul %[[W0]], %{{.*}} {{.*}} zstart = "0"
+//CHECK-NEXT: %[[MAC0:.*]] = aievec.mac %[[W0]], %{{.*}}, %[[MUL]] {{.*}} zstart = "2"
+//CHECK-NEXT: %[[MAC1:.*]] = aievec.mac %[[W1]], %{{.*}}, %[[MAC0]] {{.*}} zstart = "4"
+//CHECK-NEXT: %[[MAC2:.*]] = aievec.mac %[[W1]], %{{.*}}, %[[MAC1]] {{.*}} zstart = "6"
+//CHECK-NEXT: %[[MAC3:.*]] = aievec.mac %[[W2]], %{{.*}}, %[[MAC2]] {{.*}} zstart = "8"
+//CHECK-NEXT: %[[MAC4:.*]] = aievec.mac %[[W2]], %{{.*}}, %[[MAC3]] {{.*}} zstart = "10"
+//CHECK-NEXT: %[[SRS:.*]] = aievec.srs %[[MAC4]] {shift = 10 : i8} : vector<16xi48>, vector<16xi16>
+//CHECK-NEXT: vector.transfer_write %[[SRS]], %arg2[%[[I]], %[[J]]] {in_bounds = [true]} : vector<16xi16>, memref<16x256xi16>
+//CHECK-NEXT: scf.yield %[[M0]], %[[M1]], %[[M2]] : vector<32xi16>, vector<32xi16>, vector<32xi16>
+//CHECK-NEXT: }
+//CHECK: %[[EMUL:.*]] = aievec.mul %[[R]]#0, %{{.*}} {{.*}} zstart = "0"
+//CHECK-NEXT: %[[EMAC0:.*]] = aievec.mac %[[R]]#0, %{{.*}}, %[[EMUL]] {{.*}} zstart = "2"
+//CHECK-NEXT: %[[EMAC1:.*]] = aievec.mac %[[R]]#1, %{{.*}}, %[[EMAC0]] {{.*}} zstart = "4"
+//CHECK-NEXT: %[[EMAC2:.*]] = aievec.mac %[[R]]#1, %{{.*}}, %[[EMAC1]] {{.*}} zstart = "6"
+//CHECK-NEXT: %[[EMAC3:.*]] = aievec.mac %[[R]]#2, %{{.*}}, %[[EMAC2]] {{.*}} zstart = "8"
+//CHECK-NEXT: %[[EMAC4:.*]] = aievec.mac %[[R]]#2, %{{.*}}, %[[EMAC3]] {{.*}} zstart = "10"
+//CHECK-NEXT: %[[ESRS:.*]] = aievec.srs %[[EMAC4]] {shift = 10 : i8} : vector<16xi48>, vector<16xi16>
+//CHECK-NEXT: vector.transfer_write %[[ESRS]], %arg2[%[[I]], %{{.*}}] {in_bounds = [true]} : vector<16xi16>, memref<16x256xi16>
@@ -0,0 +1,92 @@
+// RUN: aie-opt %s -affine-super-vectorize="virtual-vector-size=16" --aie-vectorize="shift=10 zero-offset=4 sliding-window-reuse" | FileCheck %s
+
+// CHECK-LABEL: func.func @conv2d(%arg0: memref<18x288xi16>, %arg1: memref<12xi16>, %arg2: memref<16x256xi16>) {
+func.func @conv2d (%A: memref<18x288xi16>, %B: memref<12xi16>, %C: memref<16x256xi16>) {
+    affine.for %arg3 = 0 to 16 {
+        affine.for %arg4 = 0 to 256 {
+            //First row
+            //first point 
+            %a11 = affine.load %A[%arg3, %arg4+0] : memref<18x288xi16>
+            %b11 = affine.load %B[0] : memref<12xi16>
+            %p11 = arith.muli %a11, %b11 : i16
+
+            //second point 
+            %a12 = affine.load %A[%arg3, %arg4+1] : memref<18x288xi16>
+            %b12 = affine.load %B[1] : memref<12xi16>
+            %p12 = arith.muli %a12, %b12 : i16
+            %c12 = arith.addi %p11, %p12 : i16
+
+            //third point 
+            %a13 = affine.load %A[%arg3, %arg4+2] : memref<18x288xi16>
+            %b13 = affine.load %B[2] : memref<12xi16>
+            %p13 = arith.muli %a13, %b13 : i16
+            %c13 = arith.addi %c12, %p13 : i16
+
+            //Second row
+            //first point 
+            %a21 = affine.load %A[%arg3+1, %arg4+0] : memref<18x288xi16>
+            %b21 = affine.load %B[4] : memref<12xi16>
+            %p21 = arith.muli %a21, %b21 : i16
+            %c21 = arith.addi %c13, %p21 : i16
+
+            //second point 
+            %a22 = affine.load %A[%arg3+1, %arg4+1] : memref<18x288xi16>
+            %b22 = affine.load %B[5] : memref<12xi16>
+            %p22 = arith.muli %a22, %b22 : i16
+            %c22 = arith.addi %c21, %p22 : i16
+
+            //third point 
+            %a23 = affine.load %A[%arg3+1, %arg4+2] : memref<18x288xi16>
+            %b23 = affine.load %B[6] : memref<12xi16>
+            %p23 = arith.muli %a23, %b23 : i16
+            %c23 = arith.addi %c22, %p23 : i16
+
+            //Third row
+            //first point 
+            %a31 = affine.load %A[%arg3+2, %arg4+0] : memref<18x288xi16>
+            %b31 = affine.load %B[8] : memref<12xi16>
+            %p31 = arith.muli %a31, %b31 : i16
+            %c31 = arith.addi %c23, %p31 : i16
+
+            //second point 
+            %a32 = affine.load %A[%arg3+2, %arg4+1] : memref<18x288xi16>
+            %b32 = affine.load %B[9] : memref<12xi16>
+            %p32 = arith.muli %a32, %b32 : i16
+            %c32 = arith.addi %c31, %p32 : i16
+
+            //third point 
+            %a33 = affine.load %A[%arg3+2, %arg4+2] : memref<18x288xi16>
+            %b33 = affine.load %B[10] : memref<12xi16>
+            %p33 = arith.muli %a33, %b33 : i16
+            %c33 = arith.addi %c32, %p33 : i16
+
+            //Store accumulated sum
+            affine.store %c33, %C[%arg3, %arg4] : memref<16x256xi16>
+        }
+    }
+    return
+}
+
+// Each row of the input is a 512-bit sliding window that advances by 256 bits
+// in each iteration of the vectorized loop. Its lower half is carried from the
+// previous iteration, so only its upper half is loaded in the loop.
+//CHECK: scf.for %[[I:.*]] = %{{.*}} to %{{.*}} step %{{.*}} {
+//CHECK: %[[LO0:.*]] = aievec.upd %arg0[%[[I]], %[[LB:.*]]] {index = 0 : i8, offset = 0 : si32} : memref<18x288xi16>, vector<16xi16>
+//CHECK-NEXT: %[[LO1:.*]] = aievec.upd %arg0[%[[I1:.*]], %[[LB]]] {index = 0 : i8, offset = 0 : si32} : memref<18x288xi16>, vector<16xi16>
+//CHECK-NEXT: %[[LO2:.*]] = aievec.upd %arg0[%[[I2:.*]], %[[LB]]] {index = 0 : i8, offset = 0 : si32} : memref<18x288xi16>, vector<16xi16>
+//CHECK: %{{.*}}:3 = scf.for %[[J:.*]] = %{{.*}} to %{{.*}} step %{{.*}} iter_args(%[[W0:.*]] = %[[LO0]], %[[W1:.*]] = %[[LO1]], %[[W2:.*]] = %[[LO2]]) -> (vector<16xi16>, vector<16xi16>, vector<16xi16>) {
+//CHECK-NEXT: %[[HI0:.*]] = aievec.upd %arg0[%[[I]], %[[J]]] {index = 0 : i8, offset = 256 : si32} : memref<18x288xi16>, vector<16xi16>
+//CHECK-NEXT: %[[V0:.*]] = aievec.concat %[[W0]], %[[HI0]] : vector<16xi16>, vector<32xi16>
+//CHECK-NEXT: %[[MUL:.*]] = aievec.mul %[[V0]], %{{.*}} {xoffsets = "0x03020100", xoffsets_hi = "0x07060504", xsquare = "0x2110", xstart = "0", zoffsets = "0", zoffsets_hi = "0", zstart = "0", zstep = "1"} : vector<32xi16>, vector<16xi16>, vector<16xi48>
+//CHECK-NEXT: %[[MAC0:.*]] = aievec.mac %[[V0]], %{{.*}}, %[[MUL]] {xoffsets = "0x03020100", xoffsets_hi = "0x07060504", xsquare = "0x2110", xstart = "2", zoffsets = "0", zoffsets_hi = "0", zstart = "2", zstep = "1"} : vector<32xi16>, vector<16xi16>, vector<16xi48>
+//CHECK-NEXT: %[[HI1:.*]] = aievec.upd %arg0[%[[I1]], %[[J]]] {index = 0 : i8, offset = 256 : si32} : memref<18x288xi16>, vector<16xi16>
+//CHECK-NEXT: %[[V1:.*]] = aievec.concat %[[W1]], %[[HI1]] : vector<16xi16>, vector<32xi16>
+//CHECK-NEXT: %[[MAC1:.*]] = aievec.mac %[[V1]], %{{.*}}, %[[MAC0]] {{.*}} zstart = "4"
+//CHECK-NEXT: %[[MAC2:.*]] = aievec.mac %[[V1]], %{{.*}}, %[[MAC1]] {{.*}} zstart = "6"
+//CHECK-NEXT: %[[HI2:.*]] = aievec.upd %arg0[%[[I2]], %[[J]]] {index = 0 : i8, offset = 256 : si32} : memref<18x288xi16>, vector<16xi16>
+//CHECK-NEXT: %[[V2:.*]] = aievec.concat %[[W2]], %[[HI2]] : vector<16xi16>, vector<32xi16>
+//CHECK-NEXT: %[[MAC3:.*]] = aievec.mac %[[V2]], %{{.*}}, %[[MAC2]] {{.*}} zstart = "8"
+//CHECK-NEXT: %[[MAC4:.*]] = aievec.mac %[[V2]], %{{.*}}, %[[MAC3]] {{.*}} zstart = "10"
+//CHECK-NEXT: %[[SRS:.*]] = aievec.srs %[[MAC4]] {shift = 10 : i8} : vector<16xi48>, vector<16xi16>
+//CHECK-NEXT: vector.transfer_write %[[SRS]], %arg2[%[[I]], %[[J]]] {in_bounds = [true]} : vector<16xi16>, memref<16x256xi16>
+//CHECK-NEXT: scf.yield %[[HI0]], %[[HI1]], %[[HI2]] : vector<16xi16>, vector<16xi16>, vector<16xi16>
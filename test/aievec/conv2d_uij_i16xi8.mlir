@@ -0,0 +1,92 @@
+// RUN: aie-opt %s -affine-super-vectorize="virtual-vector-size=16" --aie-vectorize="shift=0 zero-offset=4" -unaligned-loads-check=false -split-input-file | FileCheck %s
+
+//CHECK-LABEL: func.func @conv2d(%arg0: memref<2048x2048xi16>, %arg1: memref<12xi8>, %arg2: memref<2046x2046xi16>) {
+func.func @conv2d (%A: memref<2048x2048xi16>, %B: memref<12xi8>, %C: memref<2046x2046xi16>) {
+    affine.for %arg3 = 0 to 2046 {
+        affine.for %arg4 = 0 to 2046 {
+            //Load the output point
+            %ci = affine.load %C[%arg3, %arg4] : memref<2046x2046xi16>
+
+            //First row
+            //first point 
+            %a11 = affine.load %A[%arg3, %arg4+0] : memref<2048x2048xi16>
+            %b11i = affine.load %B[0] : memref<12xi8>
+            %b11 = arith.extsi %b11i : i8 to i16
+            %p11 = arith.muli %a11, %b11 : i16
+            %c11 = arith.addi %ci, %p11 : i16
+
+            //second point 
+            %a12 = affine.load %A[%arg3, %arg4+1] : memref<2048x2048xi16>
+            %b12i = affine.load %B[1] : memref<12xi8>
+            %b12 = arith.extsi %b12i : i8 to i16
+            %p12 = arith.muli %a12, %b12 : i16
+            %c12 = arith.addi %c11, %p12 : i16
+
+            //third point 
+            %a13 = affine.load %A[%arg3, %arg4+2] : memref<2048x2048xi16>
+            %b13i = affine.load %B[2] : memref<12xi8>
+            %b13 = arith.extsi %b13i : i8 to i16
+            %p13 = arith.muli %a13, %b13 : i16
+            %c13 = arith.addi %c12, %p13 : i16
+
+            //Second row
+            //first point 
+            %a21 = affine.load %A[%arg3+1, %arg4+0] : memref<2048x2048xi16>
+            %b21i = affine.load %B[4] : memref<12xi8>
+            %b21 = arith.extsi %b21i : i8 to i16
+            %p21 = arith.muli %a21, %b21 : i16
+            %c21 = arith.addi %c13, %p21 : i16
+
+            //second point 
+            %a22 = affine.load %A[%arg3+1, %arg4+1] : memref<2048x2048xi16>
+            %b22i = affine.load %B[5] : memref<12xi8>
+            %b22 = arith.extsi %b22i : i8 to i16
+            %p22 = arith.muli %a22, %b22 : i16
+            %c22 = arith.addi %c21, %p22 : i16
+
+            //third point 
+            %a23 = affine.load %A[%arg3+1, %arg4+2] : memref<2048x2048xi16>
+            %b23i = affine.load %B[6] : memref<12xi8>
+            %b23 = arith.extsi %b23i : i8 to i16
+            %p23 = arith.muli %a23, %b23 : i16
+            %c23 = arith.addi %c22, %p23 : i16
+
+            //Third row
+            //first point 
+            %a31 = affine.load %A[%arg3+2, %arg4+0] : memref<2048x2048xi16>
+            %b31i = affine.load %B[8] : memref<12xi8>
+            %b31 = arith.extsi %b31i : i8 to i16
+            %p31 = arith.muli %a31, %b31 : i16
+            %c31 = arith.addi %c23, %p31 : i16
+
+            //second point 
+            %a32 = affine.load %A[%arg3+2, %arg4+1] : memref<2048x2048xi16>
+            %b32i = affine.load %B[9] : memref<12xi8>
+            %b32 = arith.extsi %b32i : i8 to i16
+            %p32 = arith.muli %a32, %b32 : i16
+            %c32 = arith.addi %c31, %p32 : i16
+
+            //third point 
+            %a33 = affine.load %A[%arg3+2, %arg4+2] : memref<2048x2048xi16>
+            %b33i = affine.load %B[10] : memref<12xi8>
+            %b33 = arith.extsi %b33i : i8 to i16
+            %p33 = arith.muli %a33, %b33 : i16
+            %c33 = arith.addi %c32, %p33 : i16
+
+            //Store accumulated sum
+            affine.store %c33, %C[%arg3, %arg4] : memref<2046x2046xi16>
+        }
+    }
+    return
+}
+
+// The i8 filter is the zbuff of the 16x8 scheme, and the three taps of a row
+// are fused into the 4-column mac16 intrinsic.
+//CHECK: %[[FILT:[0-9]+]] = aievec.upd %arg1[%c0] {index = 0 : i8, offset = 0 : si32} : memref<12xi8>, vector<32xi8>
+//CHECK-NOT: arith.extsi
+//CHECK: %[[ACC:[0-9]+]] = aievec.ups %{{.*}} {shift = 0 : i8} : vector<16xi16>, vector<16xi48>
+//CHECK: %[[MAC0:[0-9]+]] = aievec.mac %{{.*}}, %[[FILT]], %[[ACC]] {xoffsets = "0x03020100", xoffsets_hi = "0x07060504", xsquare = "0x2110", xstart = "0", zoffsets = "0", zoffsets_hi = "0", zstart = "0", zstep = "1"} : vector<32xi16>, vector<32xi8>, vector<16xi48>
+//CHECK: %[[MAC1:[0-9]+]] = aievec.mac %{{.*}}, %[[FILT]], %[[MAC0]] {xoffsets = "0x03020100", xoffsets_hi = "0x07060504", xsquare = "0x2110", xstart = "0", zoffsets = "0", zoffsets_hi = "0", zstart = "4", zstep = "1"} : vector<32xi16>, vector<32xi8>, vector<16xi48>
+//CHECK: %[[MAC2:[0-9]+]] = aievec.mac %{{.*}}, %[[FILT]], %[[MAC1]] {xoffsets = "0x03020100", xoffsets_hi = "0x07060504", xsquare = "0x2110", xstart = "0", zoffsets = "0", zoffsets_hi = "0", zstart = "8", zstep = "1"} : vector<32xi16>, vector<32xi8>, vector<16xi48>
+//CHECK: %[[RES:[0-9]+]] = aievec.srs %[[MAC2]] {shift = 0 : i8} : vector<16xi48>, vector<16xi16>
+//CHECK: vector.transfer_write %[[RES]], %arg2[%arg3, %arg4] {in_bounds = [true]} : vector<16xi16>, memref<2046x2046xi16>
@@ -1,4 +1,7 @@
 // RUN: aie-opt %s -affine-super-vectorize="virtual-vector-size=16" --aie-vectorize="shift=10" -split-input-file | FileCheck %s
+// RUN: aie-opt %s -affine-super-vectorize="virtual-vector-size=16" --aie-vectorize="shift=10 pipeline-loads" -split-input-file 2>&1 | FileCheck %s --check-prefix=PIPELINE
+
+// PIPELINE: remark: pipelined loads of 3 vector(s); estimated cycles per iteration: 15 -> 7
 
 //CHECK-LABEL: func.func @conv2d(%arg0: memref<18x288xi8>, %arg1: memref<48xi8>, %arg2: memref<16x256xi8>) {
 func.func @conv2d (%A: memref<18x288xi8>, %B: memref<48xi8>, %C: memref<16x256xi8>) {
@@ -0,0 +1,19 @@
+// RUN: aie-opt %s -affine-super-vectorize="virtual-vector-size=16" --aie-vectorize -split-input-file | FileCheck %s
+
+// CHECK-LABEL: func.func @pointwise_mac(%arg0: memref<2048xbf16>, %arg1: memref<2048xbf16>, %arg2: memref<2048xf32>) {
+func.func @pointwise_mac (%A: memref<2048xbf16>, %B: memref<2048xbf16>, %C: memref<2048xf32>) {
+    affine.for %arg0 = 0 to 2048 {
+       %a = affine.load %A[%arg0] : memref<2048xbf16>
+       %b = affine.load %B[%arg0] : memref<2048xbf16>
+       %c = affine.load %C[%arg0] : memref<2048xf32>
+       %ae = arith.extf %a : bf16 to f32
+       %be = arith.extf %b : bf16 to f32
+       //CHECK-NOT: arith.extf
+       //CHECK: %[[MAC:[0-9]+]] = aievec.mac %{{[0-9]+}}, %{{[0-9]+}}, %{{[0-9]+}} : vector<16xbf16>, vector<16xbf16>, vector<16xf32>
+       //CHECK: vector.transfer_write %[[MAC]], %arg2[%arg3] {in_bounds = [true]} : vector<16xf32>, memref<2048xf32>
+       %p = arith.mulf %ae, %be : f32
+       %s = arith.addf %c, %p : f32
+       affine.store %s, %C[%arg0] : memref<2048xf32>
+    }
+    return
+}
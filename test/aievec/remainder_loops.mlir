@@ -0,0 +1,57 @@
+// RUN: aie-opt %s -affine-super-vectorize="virtual-vector-size=16" --aie-vectorize="remainder-loops" -split-input-file | FileCheck %s
+
+// The trip count is not a multiple of the vector lanes. The last iterations
+// run in a scalar remainder loop.
+// CHECK-LABEL: func.func @pointwise_mult(%arg0: memref<2048xi16>, %arg1: memref<2048xi16>, %arg2: memref<2048xi16>) {
+func.func @pointwise_mult(%A: memref<2048xi16>, %B: memref<2048xi16>, %C: memref<2048xi16>) {
+  affine.for %i = 0 to 2046 {
+    %a = affine.load %A[%i] : memref<2048xi16>
+    %b = affine.load %B[%i] : memref<2048xi16>
+    %c = arith.muli %a, %b : i16
+    affine.store %c, %C[%i] : memref<2048xi16>
+  }
+  return
+}
+
+// CHECK: scf.for %[[I:.*]] = %c0 to %c2032 step %c16 {
+// CHECK-NEXT: %[[A:.*]] = aievec.upd %arg0[%[[I]]] {index = 0 : i8, offset = 0 : si32} : memref<2048xi16>, vector<16xi16>
+// CHECK-NEXT: %[[B:.*]] = aievec.upd %arg1[%[[I]]] {index = 0 : i8, offset = 0 : si32} : memref<2048xi16>, vector<16xi16>
+// CHECK-NEXT: %[[M:.*]] = aievec.mul %[[A]], %[[B]] : vector<16xi16>, vector<16xi16>, vector<16xi48>
+// CHECK-NEXT: %[[S:.*]] = aievec.srs %[[M]] {shift = 0 : i8} : vector<16xi48>, vector<16xi16>
+// CHECK-NEXT: vector.transfer_write %[[S]], %arg2[%[[I]]] {in_bounds = [true]} : vector<16xi16>, memref<2048xi16>
+// CHECK-NEXT: }
+// CHECK-NEXT: scf.for %[[J:.*]] = %c2032 to %c2046 step %c1 {
+// CHECK-NEXT: %[[SA:.*]] = memref.load %arg0[%[[J]]] : memref<2048xi16>
+// CHECK-NEXT: %[[SB:.*]] = memref.load %arg1[%[[J]]] : memref<2048xi16>
+// CHECK-NEXT: %[[SC:.*]] = arith.muli %[[SA]], %[[SB]] : i16
+// CHECK-NEXT: memref.store %[[SC]], %arg2[%[[J]]] : memref<2048xi16>
+// CHECK-NEXT: }
+
+// -----
+
+// The lower bound is not aligned, and the trip count is only known at run
+// time. The iterations before the first aligned one run in a scalar
+// prologue loop, and the last iterations in a scalar remainder loop.
+// CHECK-LABEL: func.func @pointwise_add(%arg0: memref<?xi16>, %arg1: memref<?xi16>, %arg2: memref<?xi16>, %arg3: index) {
+func.func @pointwise_add(%A: memref<?xi16>, %B: memref<?xi16>, %C: memref<?xi16>, %N: index) {
+  affine.for %i = 3 to %N {
+    %a = affine.load %A[%i] : memref<?xi16>
+    %b = affine.load %B[%i] : memref<?xi16>
+    %c = arith.addi %a, %b : i16
+    affine.store %c, %C[%i] : memref<?xi16>
+  }
+  return
+}
+
+// CHECK: scf.for %[[P:.*]] = %c3 to %{{.*}} step %c1 {
+// CHECK: memref.load %arg0[%[[P]]] : memref<?xi16>
+// CHECK: arith.addi %{{.*}}, %{{.*}} : i16
+// CHECK: memref.store %{{.*}}, %arg2[%[[P]]] : memref<?xi16>
+// CHECK: scf.for %[[I:.*]] = %c16 to %{{.*}} step %c16 {
+// CHECK: aievec.upd %arg0[%[[I]]]
+// CHECK: aievec.add
+// CHECK: vector.transfer_write %{{.*}}, %arg2[%[[I]]]
+// CHECK: scf.for %[[J:.*]] = %{{.*}} to %arg3 step %c1 {
+// CHECK: memref.load %arg0[%[[J]]] : memref<?xi16>
+// CHECK: arith.addi %{{.*}}, %{{.*}} : i16
+// CHECK: memref.store %{{.*}}, %arg2[%[[J]]] : memref<?xi16>
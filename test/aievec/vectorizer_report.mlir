@@ -0,0 +1,50 @@
+// RUN: aie-opt %s -affine-super-vectorize="virtual-vector-size=16" --aie-vectorize="report" -o /dev/null 2>&1 | FileCheck %s
+// RUN: aie-opt %s -affine-super-vectorize="virtual-vector-size=16" --aie-vectorize="report-file=%t" -o /dev/null && FileCheck %s --input-file=%t --check-prefix=JSON
+
+// A lane-wise mul only uses one of the two columns of the i16xi16 scheme.
+// CHECK: remark: vectorized loop with scheme i16xi16 16x1; per iteration: 16 MACs in 1 mul/mac op(s), 2 UPD load(s), 1 store(s), 1 SRS, 0 UPS, 2 live vector register(s), 2 live accumulator(s); estimated cycles: 1 vs. 0.50 at peak (50% MAC utilization)
+func.func @pointwise_mult(%A: memref<2048xi16>, %B: memref<2048xi16>, %C: memref<2048xi16>) {
+  affine.for %i = 0 to 2048 {
+    %a = affine.load %A[%i] : memref<2048xi16>
+    %b = affine.load %B[%i] : memref<2048xi16>
+    %c = arith.muli %a, %b : i16
+    affine.store %c, %C[%i] : memref<2048xi16>
+  }
+  return
+}
+
+// CHECK: remark: vectorized loop with scheme i16xi16 16x1; per iteration: 32 MACs in 2 mul/mac op(s), 4 UPD load(s), 1 store(s), 1 SRS, 0 UPS, {{[0-9]+}} live vector register(s), {{[0-9]+}} live accumulator(s); estimated cycles: 2 vs. 1.00 at peak (50% MAC utilization)
+func.func @sum_of_products(%A: memref<2048xi16>, %B: memref<2048xi16>, %C: memref<2048xi16>, %D: memref<2048xi16>, %O: memref<2048xi16>) {
+  affine.for %i = 0 to 2048 {
+    %a = affine.load %A[%i] : memref<2048xi16>
+    %b = affine.load %B[%i] : memref<2048xi16>
+    %c = affine.load %C[%i] : memref<2048xi16>
+    %d = affine.load %D[%i] : memref<2048xi16>
+    %ab = arith.muli %a, %b : i16
+    %cd = arith.muli %c, %d : i16
+    %s = arith.addi %ab, %cd : i16
+    affine.store %s, %O[%i] : memref<2048xi16>
+  }
+  return
+}
+
+// JSON: "loops": [
+// JSON-NEXT: {
+// JSON-NEXT: "function": "pointwise_mult",
+// JSON-NEXT: "location": "{{.*}}vectorizer_report.mlir:{{[0-9]+}}:{{[0-9]+}}",
+// JSON-NEXT: "scheme": "i16xi16 16x1",
+// JSON-NEXT: "macs": 16,
+// JSON-NEXT: "mac_ops": 1,
+// JSON-NEXT: "upd_loads": 2,
+// JSON-NEXT: "stores": 1,
+// JSON-NEXT: "srs": 1,
+// JSON-NEXT: "ups": 0,
+// JSON-NEXT: "live_vector_registers": 2,
+// JSON-NEXT: "live_accumulators": 2,
+// JSON-NEXT: "estimated_cycles": 1,
+// JSON-NEXT: "peak_cycles": 0.5,
+// JSON-NEXT: "mac_utilization": 0.5
+// JSON-NEXT: },
+// JSON-NEXT: {
+// JSON-NEXT: "function": "sum_of_products",
+// JSON: "macs": 32,
@@ -0,0 +1,20 @@
+//===- routing_and_lowering.mlir -------------------------------*- MLIR -*-===//
+//
+// This file is licensed under the Apache License v2.0 with LLVM Exceptions.
+// See https://llvm.org/LICENSE.txt for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+//
+// (c) Copyright 2022 Xilinx Inc.
+//
+//===----------------------------------------------------------------------===//
+
+// Each pass is run twice, in separate processes, on designs of the other tests,
+// and must produce the same output both times.
+
+// RUN: %check_deterministic aie-opt --aie-create-pathfinder-flows %S/../create-flows/mmult.mlir
+// RUN: %check_deterministic aie-opt --aie-create-pathfinder-flows %S/../create-flows/many_flows.mlir
+// RUN: %check_deterministic aie-opt --aie-create-packet-flows %S/../create-packet-flows/test_create_packet_flows5.mlir
+// RUN: %check_deterministic aie-opt --aie-create-packet-flows %S/../create-packet-flows/test_create_packet_flows_shim0.mlir
+// RUN: %check_deterministic aie-opt --aie-create-locks %S/../create-locks/test_lock7.mlir
+// RUN: %check_deterministic aie-opt --aie-objectFifo-stateful-transform %S/../objectFifo-stateful-transform/base_test_1.aie.mlir
+// RUN: %check_deterministic aie-opt --aie-objectFifo-stateful-transform %S/../objectFifo-stateful-transform/base_test_4.aie.mlir
@@ -0,0 +1,35 @@
+//===- llvm_functions.mlir -------------------------------------*- MLIR -*-===//
+//
+// This file is licensed under the Apache License v2.0 with LLVM Exceptions.
+// See https://llvm.org/LICENSE.txt for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+//
+// (c) Copyright 2022 Xilinx Inc.
+//
+//===----------------------------------------------------------------------===//
+
+// RUN: aie-opt --aie-estimate-code-size %s | FileCheck %s
+// RUN: aie-opt --aie-estimate-code-size="budget=64" %s 2>&1 >/dev/null | FileCheck %s --check-prefix=OVER
+
+// @core13: 16 + 0 (constant) + 4 (scalar add) + 16 (vector add) + 16 (return
+// of a vector).  @main: 16 + 4 (call) + 4 (branch) + 4 (return).
+// @external: 0.
+// CHECK: module attributes {AIE.code_size = 80 : i64}
+
+// OVER: warning: estimated code size of 80 bytes exceeds the program memory budget of 64 bytes, largest function: @core13 (52 bytes)
+
+module {
+  llvm.func @external(i32)
+  llvm.func @core13(%arg0: i32, %arg1: vector<8xi32>) -> vector<8xi32> {
+    %0 = llvm.mlir.constant(1 : i32) : i32
+    %1 = llvm.add %arg0, %0 : i32
+    %2 = llvm.add %arg1, %arg1 : vector<8xi32>
+    llvm.return %2 : vector<8xi32>
+  }
+  llvm.func @main(%arg0: i32) {
+    llvm.call @external(%arg0) : (i32) -> ()
+    llvm.br ^bb1
+  ^bb1:
+    llvm.return
+  }
+}
@@ -0,0 +1,60 @@
+//===- core_body_edit.mlir -------------------------------------*- MLIR -*-===//
+//
+// This file is licensed under the Apache License v2.0 with LLVM Exceptions.
+// See https://llvm.org/LICENSE.txt for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+//
+// (c) Copyright 2022 Xilinx Inc.
+//
+//===----------------------------------------------------------------------===//
+
+// RUN: aie-translate --aie-generate-dependencies %s > %t.json
+// RUN: sed 's/constant 7 : i32/constant 8 : i32/' %s | aie-translate --aie-generate-dependencies >> %t.json
+// RUN: sed 's/sym_name = "c"/sym_name = "d"/' %s | aie-translate --aie-generate-dependencies >> %t.json
+// RUN: FileCheck %s < %t.json
+
+// CHECK:      "aie_inc.cpp": "[[HOST:[0-9a-f]+]]",
+// CHECK:      "core_1_3": {
+// CHECK-NEXT:   "hash": "[[C13:[0-9a-f]+]]",
+// CHECK-NEXT:   "files": [
+// CHECK-NEXT:     "kernel.o"
+// CHECK-NEXT:   ]
+// CHECK:      "core_3_3": {
+// CHECK-NEXT:   "hash": "[[C33:[0-9a-f]+]]",
+
+// Editing the body of core (3, 3) only changes its own hash.
+// CHECK:      "aie_inc.cpp": "[[HOST]]",
+// CHECK:      "core_1_3": {
+// CHECK-NEXT:   "hash": "[[C13]]",
+// CHECK:      "core_3_3": {
+// CHECK-NOT:    "hash": "[[C33]]",
+// CHECK:        "hash": "{{[0-9a-f]+}}",
+
+// Renaming a buffer of tile (3, 3) changes the host interface and core
+// (3, 3), but not core (1, 3) which cannot access it.
+// CHECK-NOT:  "aie_inc.cpp": "[[HOST]]",
+// CHECK:      "aie_inc.cpp": "{{[0-9a-f]+}}",
+// CHECK:      "core_1_3": {
+// CHECK-NEXT:   "hash": "[[C13]]",
+// CHECK:      "core_3_3": {
+// CHECK-NOT:    "hash": "[[C33]]",
+// CHECK:        "hash": "{{[0-9a-f]+}}",
+
+module @core_body_edit {
+  %t13 = AIE.tile(1, 3)
+  %t33 = AIE.tile(3, 3)
+  %a = AIE.buffer(%t13) { sym_name = "a", address = 0x1000 } : memref<4xi32>
+  %c = AIE.buffer(%t33) { sym_name = "c", address = 0x1000 } : memref<4xi32>
+  AIE.flow(%t13, Core : 0, %t33, Core : 0)
+  %c13 = AIE.core(%t13) {
+    %c0 = arith.constant 0 : index
+    %v = memref.load %a[%c0] : memref<4xi32>
+    AIE.end
+  } { link_with = "kernel.o" }
+  %c33 = AIE.core(%t33) {
+    %c0 = arith.constant 0 : index
+    %v = arith.constant 7 : i32
+    memref.store %v, %c[%c0] : memref<4xi32>
+    AIE.end
+  }
+}
@@ -0,0 +1,24 @@
+//===- synthetic_design.mlir -----------------------------------*- MLIR -*-===//
+//
+// This file is licensed under the Apache License v2.0 with LLVM Exceptions.
+// See https://llvm.org/LICENSE.txt for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+//
+// (c) Copyright 2022 Xilinx Inc.
+//
+//===----------------------------------------------------------------------===//
+
+// The designs of the compiler benchmark must get through the passes it times.
+
+// RUN: %generate_design --cols 4 --rows 2 --flows random --object-fifos random --packet-flows 4 --packet-fanout 2 --seed 1 > %t.mlir
+// RUN: aie-opt --aie-objectFifo-stateful-transform --aie-create-packet-flows --aie-create-pathfinder-flows --aie-assign-buffer-addresses %t.mlir | FileCheck %s
+// RUN: %generate_design --cols 4 --rows 4 --flows all-to-all --object-fifos neighbour | aie-opt --aie-objectFifo-stateful-transform --aie-create-pathfinder-flows --aie-assign-buffer-addresses | aie-translate --aie-generate-xaie --xaie-target=v2 | FileCheck --check-prefix=XAIE %s
+
+// CHECK: module @synthetic_4x2
+// CHECK-COUNT-8: AIE.core
+// CHECK-NOT: AIE.flow
+// CHECK-NOT: AIE.packet_flow
+// CHECK-NOT: AIE.objectFifo
+
+// XAIE: mlir_aie_load_elf(ctx, 0, 1, (const char*)"core_0_1.elf");
+// XAIE: mlir_aie_load_elf(ctx, 3, 4, (const char*)"core_3_4.elf");
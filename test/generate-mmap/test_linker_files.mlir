@@ -0,0 +1,45 @@
+//===- test_linker_files.mlir ----------------------------------*- MLIR -*-===//
+//
+// This file is licensed under the Apache License v2.0 with LLVM Exceptions.
+// See https://llvm.org/LICENSE.txt for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+//
+// (c) Copyright 2022 Xilinx Inc.
+//
+//===----------------------------------------------------------------------===//
+
+// RUN: rm -rf %t && aie-translate --aie-generate-linker-files --output-dir=%t %s | FileCheck %s
+// RUN: aie-translate --tilecol=4 --tilerow=4 --aie-generate-bcf %s | diff - %t/core_4_4.bcf
+// RUN: aie-translate --tilecol=4 --tilerow=4 --aie-generate-ldscript %s | diff - %t/core_4_4.ld.script
+// RUN: aie-translate --tilecol=4 --tilerow=5 --aie-generate-bcf %s | diff - %t/core_4_5.bcf
+// RUN: aie-translate --tilecol=4 --tilerow=5 --aie-generate-ldscript %s | diff - %t/core_4_5.ld.script
+// RUN: FileCheck --check-prefix=BCF45 %s < %t/core_4_5.bcf
+// RUN: not ls %t/core_4_3.bcf
+
+// Files are only written for the tiles with a core.
+// CHECK: core_4_4.ld.script
+// CHECK-NEXT: core_4_4.bcf
+// CHECK-NEXT: core_4_5.ld.script
+// CHECK-NEXT: core_4_5.bcf
+// CHECK-NOT: core_4_3
+
+// BCF45: _symbol a 0x20000 0x10
+// BCF45: _symbol t 0x38000 0x20
+// BCF45: _include _file kernel.o
+
+module @test_linker_files {
+  %t44 = AIE.tile(4, 4)
+  %t43 = AIE.tile(4, 3)
+  %t45 = AIE.tile(4, 5)
+
+  %buf44_0 = AIE.buffer(%t44) { sym_name = "a", address = 0x0 } : memref<4xi32>
+  %buf43_0 = AIE.buffer(%t43) { sym_name = "z", address = 0x0 } : memref<8xi32>
+  %buf45_0 = AIE.buffer(%t45) { sym_name = "t", address = 0x0 } : memref<8xi32>
+
+  %core44 = AIE.core(%t44) {
+    AIE.end
+  }
+  %core45 = AIE.core(%t45) {
+    AIE.end
+  } { link_with = "kernel.o" }
+}
@@ -37,6 +37,8 @@ config.substitutions.append(('%PATH%', config.environment['PATH']))
 config.substitutions.append(('%shlibext', config.llvm_shlib_ext))
 config.substitutions.append(('%VITIS_SYSROOT%', config.vitis_sysroot))
 config.substitutions.append(('%aie_runtime_lib%', os.path.join(config.aie_obj_root, "runtime_lib")))
+config.substitutions.append(('%check_deterministic', os.path.join(config.test_source_root, '..', 'utils', 'check-deterministic.sh')))
+config.substitutions.append(('%generate_design', config.python_executable + ' ' + os.path.join(config.test_source_root, '..', 'utils', 'generate-design.py')))
 
 if(config.enable_board_tests):
     config.substitutions.append(('%run_on_board', "echo %T >> /home/xilinx/testlog | sync | sudo"))
@@ -55,6 +57,9 @@ config.excludes = ['benchmarks', 'Inputs', 'Examples', 'CMakeLists.txt', 'README
 
 config.aie_tools_dir = os.path.join(config.aie_obj_root, 'bin')
 
+# The aiecc package is in the tools directory, next to aiecc.py.
+config.substitutions.append(('%aiecc_python', 'env PYTHONPATH=%s %s' % (config.aie_tools_dir, config.python_executable)))
+
 def prepend_path(path):
     global llvm_config
     paths = [path]
@@ -124,7 +129,9 @@ if(config.enable_chess_tests):
 
 tool_dirs = [config.aie_tools_dir, config.peano_tools_dir, config.llvm_tools_dir]
 tools = [
+    'aie-compile',
     'aie-opt',
+    'aie-trace-decode',
     'aie-translate',
     'aiecc.py',
     'ld.lld',
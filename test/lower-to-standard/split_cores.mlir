@@ -0,0 +1,48 @@
+//===- split_cores.mlir ----------------------------------------*- MLIR -*-===//
+//
+// This file is licensed under the Apache License v2.0 with LLVM Exceptions.
+// See https://llvm.org/LICENSE.txt for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+//
+// (c) Copyright 2022 Xilinx Inc.
+//
+//===----------------------------------------------------------------------===//
+
+// RUN: rm -rf %t && aie-opt --aie-standard-lowering="output-dir=%t" %s | FileCheck --check-prefix=INPUT %s
+// RUN: FileCheck --check-prefix=CHECK33 %s < %t/core_3_3.mlir
+// RUN: FileCheck --check-prefix=CHECK43 %s < %t/core_4_3.mlir
+// RUN: rm -rf %t && aie-opt --aie-standard-lowering="output-dir=%t core-pipeline={convert-memref-to-llvm,convert-func-to-llvm,reconcile-unrealized-casts}" %s
+// RUN: FileCheck --check-prefix=LLVM %s < %t/core_4_3.mlir
+
+// INPUT: AIE.core(%{{.*}})
+// INPUT: AIE.core(%{{.*}})
+
+// CHECK33:    memref.global "public" @a : memref<4xi32>
+// CHECK33-LABEL:  func.func @core33() {
+// CHECK33:    memref.store %{{.*}}, %{{.*}}[%{{.*}}] : memref<4xi32>
+// CHECK33-NOT:  func.func @core43
+
+// CHECK43:    memref.global "public" @a : memref<4xi32>
+// CHECK43-NOT:  func.func @core33
+// CHECK43-LABEL:  func.func @core43() {
+// CHECK43:    memref.load %{{.*}}[%{{.*}}] : memref<4xi32>
+
+// LLVM: llvm.mlir.global external @a()
+// LLVM: llvm.func @core43()
+
+module @codegen1 {
+  %t33 = AIE.tile(3, 3)
+  %a = AIE.buffer(%t33) { sym_name = "a" } : memref<4xi32>
+  %core33 = AIE.core(%t33) {
+    %0 = arith.constant 0 : index
+    %377 = arith.constant 377 : i32
+    memref.store %377, %a[%0] : memref<4xi32>
+    AIE.end
+  }
+  %t34 = AIE.tile(4, 3)
+  %core34 = AIE.core(%t34) {
+    %0 = arith.constant 0 : index
+    %1 = memref.load %a[%0] : memref<4xi32>
+    AIE.end
+  }
+}
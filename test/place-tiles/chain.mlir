@@ -0,0 +1,30 @@
+//===- chain.mlir ----------------------------------------------*- MLIR -*-===//
+//
+// This file is licensed under the Apache License v2.0 with LLVM Exceptions.
+// See https://llvm.org/LICENSE.txt for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+//
+// (c) Copyright 2022 Xilinx Inc.
+//
+//===----------------------------------------------------------------------===//
+
+// RUN: aie-opt --aie-place-tiles="cols=1 rows=3" %s | FileCheck %s
+// RUN: aie-opt --aie-place-tiles="cols=1 rows=3 report=1" %s 2>&1 >/dev/null | FileCheck %s --check-prefix=REPORT
+
+// The heavier flow pulls %a next to the fixed tile.
+// CHECK: %[[T01:.*]] = AIE.tile(0, 1)
+// CHECK-NOT: logical
+// CHECK: %[[A:.*]] = AIE.tile(0, 2)
+// CHECK: %[[B:.*]] = AIE.tile(0, 3)
+// CHECK: AIE.flow(%[[T01]], DMA : 0, %[[A]], DMA : 0)
+// CHECK: AIE.flow(%[[A]], DMA : 0, %[[B]], DMA : 0)
+
+// REPORT: remark: placed 2 tiles: cost 11 (initially 21), stream wirelength 2 (initially 3), 0 of 0 objectFifos through shared memory (initially 0)
+
+module @chain {
+  %t01 = AIE.tile(0, 1)
+  %a = AIE.tile(0, 3) {logical}
+  %b = AIE.tile(0, 3) {logical}
+  AIE.flow(%t01, DMA : 0, %a, DMA : 0) {volume = 10 : i32}
+  AIE.flow(%a, DMA : 0, %b, DMA : 0)
+}
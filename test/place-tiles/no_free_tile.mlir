@@ -0,0 +1,18 @@
+//===- no_free_tile.mlir ---------------------------------------*- MLIR -*-===//
+//
+// This file is licensed under the Apache License v2.0 with LLVM Exceptions.
+// See https://llvm.org/LICENSE.txt for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+//
+// (c) Copyright 2022 Xilinx Inc.
+//
+//===----------------------------------------------------------------------===//
+
+// RUN: not aie-opt --aie-place-tiles="cols=1 rows=1" %s 2>&1 | FileCheck %s
+// CHECK: error: no free tile left to place this tile on
+
+module {
+  %t01 = AIE.tile(0, 1)
+  %a = AIE.tile(0, 1) {logical}
+  AIE.flow(%t01, DMA : 0, %a, DMA : 0)
+}
@@ -0,0 +1,27 @@
+//===- object_fifo.mlir ----------------------------------------*- MLIR -*-===//
+//
+// This file is licensed under the Apache License v2.0 with LLVM Exceptions.
+// See https://llvm.org/LICENSE.txt for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+//
+// (c) Copyright 2022 Xilinx Inc.
+//
+//===----------------------------------------------------------------------===//
+
+// RUN: aie-opt --aie-place-tiles="cols=2 rows=1" %s | FileCheck %s
+// RUN: aie-opt --aie-place-tiles="cols=2 rows=1 report=1" %s 2>&1 >/dev/null | FileCheck %s --check-prefix=REPORT
+
+// In row 1, the producer cannot access the memory of its east neighbor, but
+// the consumer can access the memory of the producer, where the objectFifo
+// can be placed.
+// CHECK: %[[PROD:.*]] = AIE.tile(0, 1)
+// CHECK: %[[CONS:.*]] = AIE.tile(1, 1)
+// CHECK: AIE.objectFifo.createObjectFifo(%[[PROD]], %[[CONS]], 2)
+
+// REPORT: remark: placed 1 tiles: cost 0 (initially 0), stream wirelength 0 (initially 0), 1 of 1 objectFifos through shared memory (initially 1)
+
+module @object_fifo {
+  %prod = AIE.tile(0, 1)
+  %cons = AIE.tile(0, 1) {logical}
+  %fifo = AIE.objectFifo.createObjectFifo(%prod, %cons, 2) : !AIE.objectFifo<memref<16xi32>>
+}
@@ -0,0 +1,30 @@
+//===- shared_memory.mlir --------------------------------------*- MLIR -*-===//
+//
+// This file is licensed under the Apache License v2.0 with LLVM Exceptions.
+// See https://llvm.org/LICENSE.txt for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+//
+// (c) Copyright 2022 Xilinx Inc.
+//
+//===----------------------------------------------------------------------===//
+
+// RUN: aie-opt --aie-place-tiles="cols=2 rows=1" %s | FileCheck %s
+
+// In row 1, a core can access the memory of its west neighbor but not of its
+// east one, so the core using the buffer of %mem must be placed east of it.
+// CHECK: %[[MEM:.*]] = AIE.tile(0, 1)
+// CHECK: %[[CORE:.*]] = AIE.tile(1, 1)
+// CHECK: %[[BUF:.*]] = AIE.buffer(%[[MEM]])
+// CHECK: AIE.core(%[[CORE]])
+
+module @shared_memory {
+  %mem = AIE.tile(1, 1) {logical}
+  %core = AIE.tile(0, 1) {logical}
+  %buf = AIE.buffer(%mem) : memref<16xi32>
+  AIE.core(%core) {
+    %c0 = arith.constant 0 : index
+    %v = arith.constant 7 : i32
+    memref.store %v, %buf[%c0] : memref<16xi32>
+    AIE.end
+  }
+}
@@ -0,0 +1,64 @@
+//===- decode_event_time.mlir ----------------------------------*- MLIR -*-===//
+//
+// This file is licensed under the Apache License v2.0 with LLVM Exceptions.
+// See https://llvm.org/LICENSE.txt for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+//
+// (c) Copyright 2022 Xilinx Inc.
+//
+//===----------------------------------------------------------------------===//
+
+// RUN: aie-translate --aie-trace-metadata %s -o %t.json
+// RUN: FileCheck %s --check-prefix=METADATA < %t.json
+// RUN: aie-trace-decode --metadata=%t.json --clock-mhz=1 %S/Inputs/trace_core.txt 2>%t.err | FileCheck %s
+// RUN: FileCheck %s --check-prefix=WARN < %t.err
+
+// METADATA:      "traces": [
+// METADATA:          "packet_id": 7,
+// METADATA-NEXT:     "col": 1,
+// METADATA-NEXT:     "row": 2,
+// METADATA-NEXT:     "module": "Core",
+// METADATA-NEXT:     "mode": "EventTime",
+// METADATA-NEXT:     "events": [
+// METADATA-NEXT:       "ACTIVE",
+// METADATA-NEXT:       "LOCK_STALL",
+// METADATA-NEXT:       "MEMORY_STALL",
+// METADATA-NEXT:       "STREAM_STALL"
+// METADATA-NEXT:     ]
+
+// WARN: warning: no trace with packet ID 3 in the metadata
+
+// CHECK:      "name": "process_name",
+// CHECK:        "name": "tile(1,2) Core"
+// CHECK:      "name": "thread_name",
+// CHECK:        "name": "ACTIVE"
+
+// The start frame sets the timer to 100.  ACTIVE is asserted alone for 6
+// cycles, then with LOCK_STALL for 3 cycles and twice more by a repeat frame.
+// CHECK:      "name": "ACTIVE",
+// CHECK-NEXT: "cat": "core",
+// CHECK-NEXT: "ph": "X",
+// CHECK-NEXT: "pid": 7,
+// CHECK-NEXT: "tid": 0,
+// CHECK-NEXT: "ts": 100,
+// CHECK-NEXT: "dur": 15
+// CHECK:      "name": "LOCK_STALL",
+// CHECK-NEXT: "cat": "lock",
+// CHECK:      "tid": 1,
+// CHECK-NEXT: "ts": 106,
+// CHECK-NEXT: "dur": 9
+// CHECK:      "name": "MEMORY_STALL",
+// CHECK-NEXT: "cat": "stall",
+// CHECK:      "ts": 115,
+// CHECK-NEXT: "dur": 1001
+// CHECK:      "name": "STREAM_STALL",
+// CHECK:      "ts": 1116,
+// CHECK-NEXT: "dur": 1
+// CHECK:      "displayTimeUnit": "ns"
+
+module @decode_event_time {
+  %t12 = AIE.tile(1, 2)
+  AIE.trace(%t12, "Core", "EventTime", 7) {
+    events = ["ACTIVE", "LOCK_STALL", "MEMORY_STALL", "STREAM_STALL"]
+  }
+}
@@ -0,0 +1,45 @@
+//===- decode_truncated_packet.mlir ----------------------------*- MLIR -*-===//
+//
+// This file is licensed under the Apache License v2.0 with LLVM Exceptions.
+// See https://llvm.org/LICENSE.txt for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+//
+// (c) Copyright 2022 Xilinx Inc.
+//
+//===----------------------------------------------------------------------===//
+
+// RUN: aie-translate --aie-trace-metadata %s -o %t.json
+// RUN: aie-trace-decode --metadata=%t.json --clock-mhz=1 --packet-words=4 %S/Inputs/trace_truncated.txt 2>%t.err | FileCheck %s
+// RUN: FileCheck %s --check-prefix=WARN < %t.err
+// RUN: not aie-trace-decode --metadata=%t.json --packet-words=1 %S/Inputs/trace_truncated.txt 2>&1 | FileCheck %s --check-prefix=ERROR
+
+// WARN: warning: truncated packet of 2 words at word 8
+
+// ERROR: error: --packet-words must be at least 2
+
+// The frames of the full packets decode as with 8-word packets.
+// CHECK:      "name": "ACTIVE",
+// CHECK:      "ts": 100,
+// CHECK-NEXT: "dur": 15
+// CHECK:      "name": "LOCK_STALL",
+// CHECK:      "ts": 106,
+// CHECK-NEXT: "dur": 9
+// CHECK:      "name": "MEMORY_STALL",
+// CHECK:      "ts": 115,
+// CHECK-NEXT: "dur": 1001
+// CHECK:      "name": "STREAM_STALL",
+// CHECK:      "ts": 1116,
+// CHECK-NEXT: "dur": 1
+
+// The payload of the truncated packet is still decoded.
+// CHECK:      "name": "LOCK_STALL",
+// CHECK:      "ts": 1117,
+// CHECK-NEXT: "dur": 1
+// CHECK:      "displayTimeUnit": "ns"
+
+module @decode_truncated_packet {
+  %t12 = AIE.tile(1, 2)
+  AIE.trace(%t12, "Core", "EventTime", 7) {
+    events = ["ACTIVE", "LOCK_STALL", "MEMORY_STALL", "STREAM_STALL"]
+  }
+}
@@ -0,0 +1,38 @@
+//===- route_traces.mlir ---------------------------------------*- MLIR -*-===//
+//
+// This file is licensed under the Apache License v2.0 with LLVM Exceptions.
+// See https://llvm.org/LICENSE.txt for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+//
+// (c) Copyright 2022 Xilinx Inc.
+//
+//===----------------------------------------------------------------------===//
+
+// RUN: aie-opt --aie-route-traces %s | FileCheck %s
+
+// CHECK-LABEL: module @route_traces {
+// CHECK:         %[[T12:.*]] = AIE.tile(1, 2)
+// CHECK:         %[[T20:.*]] = AIE.tile(2, 0)
+// CHECK:         AIE.trace(%[[T12]], "Core", "EventTime", 7) {events = ["ACTIVE", "LOCK_STALL"]}
+// CHECK:         AIE.packet_flow(7) {
+// CHECK:           AIE.packet_source<%[[T12]], Trace : 0>
+// CHECK:           AIE.packet_dest<%[[T20]], DMA : 1>
+// CHECK:         }
+// CHECK:         AIE.trace(%[[T12]], "Memory", "EventTime", 8) {events = ["DMA_S2MM_0_START_BD"]}
+// CHECK:         AIE.packet_flow(8) {
+// CHECK:           AIE.packet_source<%[[T12]], Trace : 1>
+// CHECK:           AIE.packet_dest<%[[T20]], DMA : 0>
+// CHECK:         }
+// CHECK:         AIE.trace(%[[T12]], "Core", "EventPC", 9) {events = ["ACTIVE"]}
+// CHECK-NOT:     AIE.packet_flow
+module @route_traces {
+  %t12 = AIE.tile(1, 2)
+  %t20 = AIE.tile(2, 0)
+  AIE.trace(%t12, "Core", "EventTime", 7) -> (%t20 : 1) {
+    events = ["ACTIVE", "LOCK_STALL"]
+  }
+  AIE.trace(%t12, "Memory", "EventTime", 8) -> (%t20 : 0) {
+    events = ["DMA_S2MM_0_START_BD"]
+  }
+  AIE.trace(%t12, "Core", "EventPC", 9) { events = ["ACTIVE"] }
+}
@@ -0,0 +1,37 @@
+//===- trace_packet_id_invalid.mlir ----------------------------*- MLIR -*-===//
+//
+// This file is licensed under the Apache License v2.0 with LLVM Exceptions.
+// See https://llvm.org/LICENSE.txt for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+//
+// (c) Copyright 2022 Xilinx Inc.
+//
+//===----------------------------------------------------------------------===//
+
+// RUN: aie-opt %s -split-input-file -verify-diagnostics
+
+// The packet flow does not carry the trace stream.
+module @packet_flow_collision {
+  %t12 = AIE.tile(1, 2)
+  %t20 = AIE.tile(2, 0)
+  // expected-error@+1 {{packet ID 7 is used by a packet flow}}
+  AIE.trace(%t12, "Core", "EventTime", 7) { events = ["ACTIVE"] }
+  AIE.packet_flow(7) {
+    AIE.packet_source<%t12, DMA : 0>
+    AIE.packet_dest<%t20, DMA : 1>
+  }
+}
+
+// -----
+
+// The flow carries the trace stream of the memory module, not the core.
+module @trace_channel_collision {
+  %t12 = AIE.tile(1, 2)
+  %t20 = AIE.tile(2, 0)
+  // expected-error@+1 {{packet ID 7 is used by a packet flow}}
+  AIE.trace(%t12, "Core", "EventTime", 7) { events = ["ACTIVE"] }
+  AIE.packet_flow(7) {
+    AIE.packet_source<%t12, Trace : 1>
+    AIE.packet_dest<%t20, DMA : 1>
+  }
+}
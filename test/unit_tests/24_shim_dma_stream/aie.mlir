@@ -0,0 +1,52 @@
+//===- aie.mlir ------------------------------------------------*- MLIR -*-===//
+//
+// This file is licensed under the Apache License v2.0 with LLVM Exceptions.
+// See https://llvm.org/LICENSE.txt for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+//
+// (c) Copyright 2022 Xilinx Inc.
+//
+//===----------------------------------------------------------------------===//
+
+// RUN: aiecc.py --sysroot=%VITIS_SYSROOT% %s -I%aie_runtime_lib% %aie_runtime_lib%/test_library.cpp %S/test.cpp -o test.elf
+// RUN: %run_on_board ./test.elf
+
+// The shim DMA of column 7 is driven by the stream API of the runtime, which
+// owns its BDs 0 and 1 and its locks 0 and 1, so it has no shimDMA here.
+module @test24_shim_dma_stream {
+  %t70 = AIE.tile(7, 0)
+  %t71 = AIE.tile(7, 1)
+  %t72 = AIE.tile(7, 2)
+
+  // Fixup
+  %sw = AIE.switchbox(%t70) {
+    AIE.connect<"South" : 3, "North" : 3>
+  }
+  %mux = AIE.shimmux(%t70) {
+    AIE.connect<"DMA" : 0, "North": 3>
+  }
+
+  AIE.flow(%t71, "South" : 3, %t72, "DMA" : 0)
+
+  %buf72_0 = AIE.buffer(%t72) {sym_name = "buf72_0" } : memref<256xi32>
+  %buf72_1 = AIE.buffer(%t72) {sym_name = "buf72_1" } : memref<256xi32>
+
+  %l72_0 = AIE.lock(%t72, 0)
+  %l72_1 = AIE.lock(%t72, 1)
+
+  %m72 = AIE.mem(%t72) {
+      %srcDma = AIE.dmaStart("S2MM0", ^bd0, ^end)
+    ^bd0:
+      AIE.useLock(%l72_0, "Acquire", 0)
+      AIE.dmaBd(<%buf72_0 : memref<256xi32>, 0, 256>, 0)
+      AIE.useLock(%l72_0, "Release", 1)
+      cf.br ^bd1
+    ^bd1:
+      AIE.useLock(%l72_1, "Acquire", 0)
+      AIE.dmaBd(<%buf72_1 : memref<256xi32>, 0, 256>, 0)
+      AIE.useLock(%l72_1, "Release", 1)
+      cf.br ^bd0
+    ^end:
+      AIE.end
+  }
+}
@@ -0,0 +1,118 @@
+//===- test.cpp -------------------------------------------------*- C++ -*-===//
+//
+// This file is licensed under the Apache License v2.0 with LLVM Exceptions.
+// See https://llvm.org/LICENSE.txt for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+//
+// (c) Copyright 2022 Xilinx Inc.
+//
+//===----------------------------------------------------------------------===//
+
+#include <cassert>
+#include <cstdio>
+#include <cstring>
+#include <stdlib.h>
+#include <unistd.h>
+#include <xaiengine.h>
+#include "test_library.h"
+
+#include "aie_inc.cpp"
+
+#define SLOT_COUNT 256
+
+int errors = 0;
+
+#define EXPECT(cond)                                                           \
+  do {                                                                         \
+    if (!(cond)) {                                                             \
+      printf("%s:%d: expected %s\n", __FILE__, __LINE__, #cond);               \
+      errors++;                                                                \
+    }                                                                          \
+  } while (0)
+
+int
+main(int argc, char *argv[])
+{
+  aie_libxaie_ctx_t *_xaie = mlir_aie_init_libxaie();
+  mlir_aie_init_device(_xaie);
+
+  mlir_aie_configure_cores(_xaie);
+  mlir_aie_configure_switchboxes(_xaie);
+  mlir_aie_initialize_locks(_xaie);
+  mlir_aie_configure_dmas(_xaie);
+
+  for (int i = 0; i < SLOT_COUNT; i++) {
+    mlir_aie_write_buffer_buf72_0(_xaie, i, 0xdeadbeef);
+    mlir_aie_write_buffer_buf72_1(_xaie, i, 0xdeadbeef);
+  }
+
+#ifndef LIBXAIENGINEV1
+  mlir_aie_stream_t *stream = mlir_aie_stream_open(
+      _xaie, 7, /* channel */ 0, /* s2mm */ 0, /* firstBd */ 0,
+      /* firstLock */ 0, /* numSlots */ 2, SLOT_COUNT * sizeof(int));
+  EXPECT(stream);
+  if (!stream) {
+    mlir_aie_deinit_libxaie(_xaie);
+    return -1;
+  }
+
+  // The stream holds locks 0 and 1, so a second stream on them fails.
+  EXPECT(!mlir_aie_stream_open(_xaie, 7, 0, 0, 2, 0, 2,
+                               SLOT_COUNT * sizeof(int)));
+
+  // A buffer has to be handed out before it is submitted, and nothing is in
+  // flight yet.
+  EXPECT(mlir_aie_stream_submit(stream, sizeof(int)) != 0);
+  EXPECT(mlir_aie_stream_poll(stream, nullptr) == nullptr);
+
+  for (int b = 0; b < 2; b++) {
+    mlir_aie_host_buffer_t *buf = mlir_aie_stream_next_buffer(stream);
+    EXPECT(buf);
+    if (!buf)
+      break;
+    int *data = (int *)buf->vaddr;
+    for (int i = 0; i < SLOT_COUNT; i++)
+      data[i] = b * SLOT_COUNT + i + 1;
+    // No more than the size of the buffer can be submitted.
+    EXPECT(mlir_aie_stream_submit(stream, buf->size + 1) != 0);
+    EXPECT(mlir_aie_stream_submit(stream, SLOT_COUNT * sizeof(int)) == 0);
+  }
+  EXPECT(mlir_aie_stream_pending(stream) == 2);
+  // Both slots are in flight.
+  EXPECT(mlir_aie_stream_next_buffer(stream) == nullptr);
+
+  // Buffers complete in submission order.
+  for (int b = 0; b < 2; b++) {
+    mlir_aie_host_buffer_t *buf = nullptr;
+    size_t bytes = 0;
+    for (int tries = 0; !buf && tries < 1000; tries++) {
+      buf = mlir_aie_stream_poll(stream, &bytes);
+      if (!buf)
+        usleep(100);
+    }
+    EXPECT(buf);
+    EXPECT(bytes == SLOT_COUNT * sizeof(int));
+  }
+  EXPECT(mlir_aie_stream_pending(stream) == 0);
+  EXPECT(mlir_aie_stream_poll(stream, nullptr) == nullptr);
+
+  for (int i = 0; i < SLOT_COUNT; i++) {
+    EXPECT(mlir_aie_read_buffer_buf72_0(_xaie, i) == i + 1);
+    EXPECT(mlir_aie_read_buffer_buf72_1(_xaie, i) == SLOT_COUNT + i + 1);
+  }
+
+  mlir_aie_stream_close(stream);
+#endif
+
+  int res = 0;
+  if (!errors) {
+    printf("PASS!\n");
+  } else {
+    printf("fail %d.\n", errors);
+    res = -1;
+  }
+  mlir_aie_deinit_libxaie(_xaie);
+
+  printf("test done.\n");
+  return res;
+}
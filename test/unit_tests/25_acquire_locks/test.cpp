@@ -0,0 +1,79 @@
+//===- test.cpp -------------------------------------------------*- C++ -*-===//
+//
+// This file is licensed under the Apache License v2.0 with LLVM Exceptions.
+// See https://llvm.org/LICENSE.txt for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+//
+// (c) Copyright 2022 Xilinx Inc.
+//
+//===----------------------------------------------------------------------===//
+
+#include <cassert>
+#include <cstdio>
+#include <cstring>
+#include <stdlib.h>
+#include <unistd.h>
+#include <xaiengine.h>
+#include "test_library.h"
+
+#include "aie_inc.cpp"
+
+int errors = 0;
+
+#define EXPECT(cond)                                                           \
+  do {                                                                         \
+    if (!(cond)) {                                                             \
+      printf("%s:%d: expected %s\n", __FILE__, __LINE__, #cond);               \
+      errors++;                                                                \
+    }                                                                          \
+  } while (0)
+
+int
+main(int argc, char *argv[])
+{
+  aie_libxaie_ctx_t *_xaie = mlir_aie_init_libxaie();
+  mlir_aie_init_device(_xaie);
+
+  mlir_aie_configure_cores(_xaie);
+  mlir_aie_configure_switchboxes(_xaie);
+  mlir_aie_initialize_locks(_xaie);
+  mlir_aie_configure_dmas(_xaie);
+
+#ifndef LIBXAIENGINEV1
+  // Hold lock 3, so that only lock 5 can be acquired.
+  EXPECT(mlir_aie_acquire_lock(_xaie, 1, 3, 3, 0, 0));
+
+  mlir_aie_lock_wait_t locks[] = {{1, 3, 3, 0, 0}, {1, 3, 5, 0, 0}};
+
+  // Without waitAll, the call returns once lock 5 is acquired.
+  EXPECT(mlir_aie_acquire_locks(_xaie, locks, 2, /* waitAll */ 0,
+                                /* timeout */ 1000) == 1);
+  EXPECT(!locks[0].acquired);
+  EXPECT(locks[1].acquired);
+
+  // With waitAll, it times out on lock 3, and lock 5 is not acquired again.
+  EXPECT(mlir_aie_acquire_locks(_xaie, locks, 2, 1, 1000) == 0);
+  EXPECT(!locks[0].acquired);
+
+  // Once lock 3 is released, repeating the call completes the set.
+  mlir_aie_release_lock(_xaie, 1, 3, 3, 0, 0);
+  EXPECT(mlir_aie_acquire_locks(_xaie, locks, 2, 1, 1000) == 1);
+  EXPECT(locks[0].acquired);
+  EXPECT(locks[1].acquired);
+
+  mlir_aie_release_lock(_xaie, 1, 3, 3, 0, 0);
+  mlir_aie_release_lock(_xaie, 1, 3, 5, 0, 0);
+#endif
+
+  int res = 0;
+  if (!errors) {
+    printf("PASS!\n");
+  } else {
+    printf("fail %d.\n", errors);
+    res = -1;
+  }
+  mlir_aie_deinit_libxaie(_xaie);
+
+  printf("test done.\n");
+  return res;
+}
@@ -0,0 +1,27 @@
+//===- aie.mlir ------------------------------------------------*- MLIR -*-===//
+//
+// This file is licensed under the Apache License v2.0 with LLVM Exceptions.
+// See https://llvm.org/LICENSE.txt for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+//
+// (c) Copyright 2022 Xilinx Inc.
+//
+//===----------------------------------------------------------------------===//
+
+// RUN: aiecc.py --sysroot=%VITIS_SYSROOT% %s -I%aie_runtime_lib% %aie_runtime_lib%/test_library.cpp %S/test.cpp -o test.elf
+// RUN: %run_on_board ./test.elf
+
+module @test26_elf_cache {
+  %tile13 = AIE.tile(1, 3)
+  %tile23 = AIE.tile(2, 3)
+
+  %core13 = AIE.core(%tile13) {
+    AIE.end
+  }
+
+  %core23 = AIE.core(%tile23) {
+    %val = arith.constant 7 : i32
+    %0 = arith.addi %val, %val : i32
+    AIE.end
+  }
+}
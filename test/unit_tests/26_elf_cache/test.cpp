@@ -0,0 +1,75 @@
+//===- test.cpp -------------------------------------------------*- C++ -*-===//
+//
+// This file is licensed under the Apache License v2.0 with LLVM Exceptions.
+// See https://llvm.org/LICENSE.txt for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+//
+// (c) Copyright 2022 Xilinx Inc.
+//
+//===----------------------------------------------------------------------===//
+
+#include <cassert>
+#include <cstdio>
+#include <cstring>
+#include <fstream>
+#include <stdlib.h>
+#include <unistd.h>
+#include <xaiengine.h>
+#include "test_library.h"
+
+#include "aie_inc.cpp"
+
+int errors = 0;
+
+#define EXPECT(cond)                                                           \
+  do {                                                                         \
+    if (!(cond)) {                                                             \
+      printf("%s:%d: expected %s\n", __FILE__, __LINE__, #cond);               \
+      errors++;                                                                \
+    }                                                                          \
+  } while (0)
+
+static void copy_file(const char *from, const char *to) {
+  std::ifstream in(from, std::ios::binary);
+  std::ofstream out(to, std::ios::binary | std::ios::trunc);
+  out << in.rdbuf();
+}
+
+int
+main(int argc, char *argv[])
+{
+  aie_libxaie_ctx_t *_xaie = mlir_aie_init_libxaie();
+  mlir_aie_init_device(_xaie);
+
+#ifndef LIBXAIENGINEV1
+  // The same kernel under two names is held once.
+  copy_file("core_1_3.elf", "kernel.elf");
+  EXPECT(mlir_aie_load_elf(_xaie, 1, 3, "core_1_3.elf") == XAIE_OK);
+  EXPECT(mlir_aie_load_elf(_xaie, 2, 3, "kernel.elf") == XAIE_OK);
+  EXPECT(mlir_aie_num_elf_images() == 1);
+
+  // Loading it again does not read it again.
+  EXPECT(mlir_aie_load_elf(_xaie, 2, 3, "kernel.elf") == XAIE_OK);
+  EXPECT(mlir_aie_num_elf_images() == 1);
+
+  // Once the file is rebuilt with another kernel, the new one is loaded.
+  usleep(10000);
+  copy_file("core_2_3.elf", "kernel.elf");
+  EXPECT(mlir_aie_load_elf(_xaie, 2, 3, "kernel.elf") == XAIE_OK);
+  EXPECT(mlir_aie_num_elf_images() == 2);
+  EXPECT(mlir_aie_load_elf(_xaie, 2, 3, "core_2_3.elf") == XAIE_OK);
+  EXPECT(mlir_aie_num_elf_images() == 2);
+#endif
+
+  int res = 0;
+  if (!errors) {
+    printf("PASS!\n");
+  } else {
+    printf("fail %d.\n", errors);
+    res = -1;
+  }
+  mlir_aie_deinit_libxaie(_xaie);
+
+  printf("test done.\n");
+  return res;
+}
@@ -0,0 +1,36 @@
+//===- shim_v2.mlir --------------------------------------------*- MLIR -*-===//
+//
+// This file is licensed under the Apache License v2.0 with LLVM Exceptions.
+// See https://llvm.org/LICENSE.txt for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+//
+// (c) Copyright 2022 Xilinx Inc.
+//
+//===----------------------------------------------------------------------===//
+
+// RUN: aie-translate --aie-generate-xaie --xaie-target=v2 %s | FileCheck %s
+
+// CHECK: static u64 _mlir_aie_external_myBuffer_20_0 = 0x1234567890;
+// CHECK: void mlir_aie_external_set_addr_myBuffer_20_0(u64 addr) {
+// CHECK: u64 mlir_aie_external_get_addr_myBuffer_20_0(void) {
+// CHECK: void mlir_aie_external_set_buffer_myBuffer_20_0(mlir_aie_host_buffer_t *buf) {
+// CHECK-NEXT: _mlir_aie_external_myBuffer_20_0 = buf->devaddr;
+// CHECK: void mlir_aie_configure_shimdma_20(aie_libxaie_ctx_t* ctx) {
+// CHECK: XAie_DmaSetAddrLen(&(dma_tile20_bd0),  /* addr */ mlir_aie_external_get_addr_myBuffer_20_0(),  /* len */ 16 * 4);
+// CHECK: XAie_DmaChannelPushBdToQueue(&(ctx->DevInst), XAie_TileLoc(2,0), /* ChNum */0, /* dmaDir */ DMA_MM2S, /* BdNum */0);
+
+module {
+  %buffer = AIE.external_buffer 0x1234567890 : memref<16 x f32>
+  %t20 = AIE.tile(2, 0)
+  %dma = AIE.shimDMA(%t20)  {
+      %lock0 = AIE.lock(%t20, 0)
+      AIE.dmaStart(MM2S0, ^bd0, ^end)
+    ^bd0:
+      AIE.useLock(%lock0, Acquire, 1)
+      AIE.dmaBd(<%buffer : memref<16 x f32>, 0, 16>, 0)
+      AIE.useLock(%lock0, Release, 0)
+      cf.br ^bd0
+    ^end:
+      AIE.end
+  }
+}
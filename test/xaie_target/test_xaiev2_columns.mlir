@@ -0,0 +1,79 @@
+//===- test_xaiev2_columns.mlir --------------------------------*- MLIR -*-===//
+//
+// This file is licensed under the Apache License v2.0 with LLVM Exceptions.
+// See https://llvm.org/LICENSE.txt for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+//
+// (c) Copyright 2022 Xilinx Inc.
+//
+//===----------------------------------------------------------------------===//
+
+// RUN: aie-translate --aie-generate-xaie --xaie-target=v2 %s | FileCheck %s
+
+// CHECK: void mlir_aie_configure_cores_column_1(aie_libxaie_ctx_t* ctx) {
+// CHECK: mlir_aie_load_elf(ctx, 1, 3, (const char*)"kernel.elf");
+// CHECK: mlir_aie_load_elf(ctx, 1, 4, (const char*)"kernel.elf");
+// CHECK: } // mlir_aie_configure_cores_column_1
+// CHECK: void mlir_aie_configure_cores_column_2(aie_libxaie_ctx_t* ctx) {
+// CHECK: mlir_aie_load_elf(ctx, 2, 3, (const char*)"core_2_3.elf");
+// CHECK: } // mlir_aie_configure_cores_column_2
+// CHECK: void mlir_aie_configure_cores(aie_libxaie_ctx_t* ctx) {
+// CHECK-NEXT: mlir_aie_configure_cores_column_1(ctx);
+// CHECK-NEXT: mlir_aie_configure_cores_column_2(ctx);
+// CHECK-NEXT: } // mlir_aie_configure_cores
+// CHECK: void mlir_aie_configure_cores_parallel(aie_libxaie_ctx_t* ctx, int nthreads) {
+// CHECK: mlir_aie_configure_cores_column_1,
+// CHECK: mlir_aie_configure_cores_column_2,
+// CHECK: mlir_aie_configure_columns(ctx, columns, 2, nthreads);
+
+// CHECK: void mlir_aie_configure_dmas_column_2(aie_libxaie_ctx_t* ctx) {
+// CHECK: XAie_DmaWriteBd(&(ctx->DevInst), &(dma_tile23_bd0), XAie_TileLoc(2,3),  /* bd */ 0);
+// CHECK: } // mlir_aie_configure_dmas_column_2
+// CHECK: void mlir_aie_configure_dmas_parallel(aie_libxaie_ctx_t* ctx, int nthreads) {
+// CHECK: mlir_aie_configure_columns(ctx, columns, 1, nthreads);
+
+// CHECK: void mlir_aie_configure_switchboxes_column_1(aie_libxaie_ctx_t* ctx) {
+// CHECK: XAie_StrmConnCctEnable(&(ctx->DevInst), XAie_TileLoc(x,y), CORE, 0, EAST, 0);
+// CHECK: } // mlir_aie_configure_switchboxes_column_1
+// CHECK: void mlir_aie_configure_switchboxes_column_2(aie_libxaie_ctx_t* ctx) {
+// CHECK: XAie_StrmConnCctEnable(&(ctx->DevInst), XAie_TileLoc(x,y), WEST, 0, DMA, 0);
+// CHECK: } // mlir_aie_configure_switchboxes_column_2
+// CHECK: void mlir_aie_configure_switchboxes_parallel(aie_libxaie_ctx_t* ctx, int nthreads) {
+// CHECK: mlir_aie_configure_columns(ctx, columns, 2, nthreads);
+
+module @test_xaiev2_columns {
+  %t13 = AIE.tile(1, 3)
+  %t14 = AIE.tile(1, 4)
+  %t23 = AIE.tile(2, 3)
+
+  %buf = AIE.buffer(%t23) {address = 4096 : i32, sym_name = "buf"} : memref<256xi32>
+  %lock = AIE.lock(%t23, 0)
+
+  AIE.core(%t13) {
+    AIE.end
+  } { elf_file = "kernel.elf" }
+  AIE.core(%t14) {
+    AIE.end
+  } { elf_file = "kernel.elf" }
+  AIE.core(%t23) {
+    AIE.end
+  }
+
+  %m23 = AIE.mem(%t23) {
+      %srcDma = AIE.dmaStart(S2MM0, ^bd0, ^end)
+    ^bd0:
+      AIE.useLock(%lock, Acquire, 0)
+      AIE.dmaBd(<%buf : memref<256xi32>, 0, 256>, 0)
+      AIE.useLock(%lock, Release, 1)
+      cf.br ^end
+    ^end:
+      AIE.end
+  }
+
+  %s13 = AIE.switchbox(%t13) {
+    AIE.connect<Core : 0, East : 0>
+  }
+  %s23 = AIE.switchbox(%t23) {
+    AIE.connect<West : 0, DMA : 0>
+  }
+}
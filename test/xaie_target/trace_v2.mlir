@@ -0,0 +1,31 @@
+//===- trace_v2.mlir -------------------------------------------*- MLIR -*-===//
+//
+// This file is licensed under the Apache License v2.0 with LLVM Exceptions.
+// See https://llvm.org/LICENSE.txt for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+//
+// (c) Copyright 2022 Xilinx Inc.
+//
+//===----------------------------------------------------------------------===//
+
+// RUN: aie-translate --aie-generate-xaie --xaie-target=v2 %s | FileCheck %s
+
+// CHECK: void mlir_aie_configure_trace(aie_libxaie_ctx_t* ctx) {
+// CHECK: XAie_TraceEvent(&(ctx->DevInst), XAie_TileLoc(1,2), XAIE_CORE_MOD, XAIE_EVENT_ACTIVE_CORE, 0);
+// CHECK: XAie_TraceEvent(&(ctx->DevInst), XAie_TileLoc(1,2), XAIE_CORE_MOD, XAIE_EVENT_LOCK_STALL_CORE, 1);
+// CHECK: XAie_TracePktConfig(&(ctx->DevInst), XAie_TileLoc(1,2), XAIE_CORE_MOD, XAie_PacketInit(7,0));
+// CHECK: XAie_TraceControlConfig(&(ctx->DevInst), XAie_TileLoc(1,2), XAIE_CORE_MOD, XAIE_EVENT_TRUE_CORE, XAIE_EVENT_NONE_CORE, XAIE_TRACE_EVENT_TIME);
+// CHECK: XAie_TraceEvent(&(ctx->DevInst), XAie_TileLoc(1,2), XAIE_MEM_MOD, XAIE_EVENT_DMA_S2MM_0_START_BD_MEM, 0);
+// CHECK: XAie_TracePktConfig(&(ctx->DevInst), XAie_TileLoc(1,2), XAIE_MEM_MOD, XAie_PacketInit(8,0));
+// CHECK: XAie_TraceControlConfig(&(ctx->DevInst), XAie_TileLoc(1,2), XAIE_MEM_MOD, XAIE_EVENT_LOCK_0_ACQ_MEM, XAIE_EVENT_LOCK_0_REL_MEM, XAIE_TRACE_EVENT_TIME);
+// CHECK: } // mlir_aie_configure_trace
+
+module @trace_v2 {
+  %t12 = AIE.tile(1, 2)
+  AIE.trace(%t12, "Core", "EventTime", 7) {
+    events = ["ACTIVE", "LOCK_STALL"]
+  }
+  AIE.trace(%t12, "Memory", "EventTime", 8) {
+    events = ["DMA_S2MM_0_START_BD"], start = "LOCK_0_ACQ", stop = "LOCK_0_REL"
+  }
+}
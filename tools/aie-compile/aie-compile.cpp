@@ -0,0 +1,120 @@
+//===- aie-compile.cpp ------------------------------------------*- C++ -*-===//
+//
+// This file is licensed under the Apache License v2.0 with LLVM Exceptions.
+// See https://llvm.org/LICENSE.txt for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+//
+// (c) Copyright 2022 Xilinx Inc.
+//
+//===----------------------------------------------------------------------===//
+//
+// Run the MLIR part of aiecc in a single process, and print the list of cores
+// in the format of aie-translate --aie-generate-corelist.
+//
+//===----------------------------------------------------------------------===//
+
+#include "mlir/IR/AsmState.h"
+#include "mlir/IR/Dialect.h"
+#include "mlir/IR/MLIRContext.h"
+#include "mlir/InitAllDialects.h"
+#include "mlir/InitAllPasses.h"
+#include "mlir/Parser/Parser.h"
+#include "mlir/Pass/PassManager.h"
+#include "llvm/Support/CommandLine.h"
+#include "llvm/Support/InitLLVM.h"
+#include "llvm/Support/SourceMgr.h"
+#include "llvm/Support/ThreadPool.h"
+#include "llvm/Support/Threading.h"
+
+#include "aie/AIECompiler.h"
+#include "aie/AIEDialect.h"
+#include "aie/AIEPasses.h"
+#include "aie/Dialect/ADF/ADFDialect.h"
+#include "aie/Dialect/AIEVec/IR/AIEVecDialect.h"
+#include "aie/Dialect/AIEVec/Transforms/Passes.h"
+
+using namespace llvm;
+using namespace mlir;
+
+static cl::opt<std::string> inputFilename(cl::Positional,
+                                          cl::desc("<input file>"),
+                                          cl::init("-"));
+
+static cl::opt<std::string>
+    tmpDir("tmpdir", cl::desc("directory used for temporary file storage"),
+           cl::init("acdc_project"));
+
+static cl::opt<bool> pathfinder("pathfinder",
+                                cl::desc("Compile using pathfinder router"),
+                                cl::init(false));
+
+static cl::opt<int> xaie(
+    cl::desc("libxaie version of the generated host interface:"),
+    cl::values(
+        clEnumValN(1, "aie-generate-xaie", "Generate libxaie v1 drivers"),
+        clEnumValN(2, "aie-generate-xaiev2",
+                   "Generate libxaie v2 drivers (default)")),
+    cl::init(2));
+
+static cl::opt<unsigned> codeSizeBudget(
+    "code-size-budget",
+    cl::desc("Program memory of a core, in bytes, that the estimated size of "
+             "its code is checked against"),
+    cl::init(16384));
+
+static cl::opt<unsigned>
+    nthreads("j",
+             cl::desc("Compile with max n-threads in the machine (default is "
+                      "1).  An argument of zero corresponds to the maximum "
+                      "number of threads on the machine."),
+             cl::init(1));
+
+static cl::opt<bool> verbose("v", cl::desc("Trace pipelines as they are run"),
+                             cl::init(false));
+
+int main(int argc, char **argv) {
+  InitLLVM y(argc, argv);
+
+  registerAllPasses();
+  aie::registerAIEPasses();
+  xilinx::aievec::registerAIEVecPasses();
+  registerAsmPrinterCLOptions();
+  registerMLIRContextCLOptions();
+  registerPassManagerCLOptions();
+  cl::ParseCommandLineOptions(argc, argv, "AIE compiler driver\n");
+
+  DialectRegistry registry;
+  registerAllDialects(registry);
+  registry.insert<xilinx::AIE::AIEDialect>();
+  registry.insert<xilinx::aievec::AIEVecDialect>();
+  registry.insert<xilinx::ADF::ADFDialect>();
+
+  // All the cores share the context and its thread pool.
+  MLIRContext context(registry, MLIRContext::Threading::DISABLED);
+  ThreadPool threadPool(hardware_concurrency(nthreads));
+  if (nthreads != 1)
+    context.setThreadPool(threadPool);
+
+  OwningOpRef<ModuleOp> module =
+      parseSourceFile<ModuleOp>(inputFilename, &context);
+  if (!module)
+    return 1;
+
+  xilinx::AIE::AIECompilerOptions options;
+  options.tmpDir = tmpDir;
+  options.pathfinder = pathfinder;
+  options.xaieTarget = xaie;
+  options.codeSizeBudget = codeSizeBudget;
+  options.verbose = verbose;
+  SmallVector<xilinx::AIE::AIECoreInfo, 16> cores;
+  if (failed(xilinx::AIE::compileAIEModule(*module, options, cores)))
+    return 1;
+
+  outs() << "[";
+  for (auto &core : cores)
+    outs() << '(' << core.col << ',' << core.row << ','
+           << (core.elfFile.empty() ? "None" : '"' + core.elfFile + '"')
+           << "),";
+  outs() << "]\n";
+  return 0;
+}
@@ -0,0 +1,387 @@
+//===- aie-trace-decode.cpp -------------------------------------*- C++ -*-===//
+//
+// This file is licensed under the Apache License v2.0 with LLVM Exceptions.
+// See https://llvm.org/LICENSE.txt for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+//
+// (c) Copyright 2022 Xilinx Inc.
+//
+//===----------------------------------------------------------------------===//
+
+// This tool converts the raw words written by AIE trace units into a
+// timeline in the Chrome trace event format, which can be loaded in
+// chrome://tracing or Perfetto.  The input is a text file with one 32-bit
+// word per line, in hex, as copied out of the trace buffer by the host.
+// The events traced by each stream are taken from the metadata written by
+// `aie-translate --aie-trace-metadata`.
+//
+// The trace units send packets of one header word followed by payload
+// words.  The header carries no length, so the packet length is given by
+// --packet-words; it is 8 words on AIE1.  The low 5 bits of the header are
+// the packet ID, which selects the trace stream.  A last packet cut short
+// by the end of the trace buffer is decoded up to its last word.
+//
+// The payload of a stream is a sequence of frames, read a byte at a time
+// from the most significant byte of each word.  In event-time mode the
+// frames are:
+//
+//   0eeecccc                              Single0: slot e, c cycles
+//   100eeecc cccccccc                     Single1: slot e, c cycles
+//   101eeecc cccccccc cccccccc            Single2: slot e, c cycles
+//   1100mmmm mmmmcccc                     Multiple0: slot mask m, c cycles
+//   1101mmmm mmmmcccc cccccccc            Multiple1: slot mask m, c cycles
+//   1110mmmm mmmmcccc cccccccc cccccccc   Multiple2: slot mask m, c cycles
+//   11110000 t*56                         Start: absolute timer value t
+//   111101rr                              Repeat0: previous frame r+1 times
+//   11111000 rrrrrrrr                     Repeat1: previous frame r+1 times
+//   1111111x                              Filler
+//
+// A frame states that the events in its slots were asserted for c+1 cycles.
+// Consecutive frames asserting the same slot are merged into one interval
+// on the timeline.
+
+#include "llvm/ADT/DenseMap.h"
+#include "llvm/ADT/SmallVector.h"
+#include "llvm/ADT/StringExtras.h"
+#include "llvm/Support/CommandLine.h"
+#include "llvm/Support/FileSystem.h"
+#include "llvm/Support/InitLLVM.h"
+#include "llvm/Support/JSON.h"
+#include "llvm/Support/MemoryBuffer.h"
+#include "llvm/Support/ToolOutputFile.h"
+#include "llvm/Support/WithColor.h"
+
+#include <map>
+#include <string>
+#include <vector>
+
+using namespace llvm;
+
+static cl::opt<std::string> inputFilename(cl::Positional,
+                                          cl::desc("<trace words>"),
+                                          cl::init("-"));
+static cl::opt<std::string>
+    metadataFilename("metadata", cl::Required,
+                     cl::desc("trace metadata from aie-translate"),
+                     cl::value_desc("filename"));
+static cl::opt<std::string> outputFilename("o", cl::desc("Output filename"),
+                                           cl::value_desc("filename"),
+                                           cl::init("-"));
+static cl::opt<double>
+    clockMHz("clock-mhz", cl::desc("AIE array clock frequency in MHz"),
+             cl::init(1000.0));
+static cl::opt<unsigned>
+    packetWords("packet-words",
+                cl::desc("Words per trace packet, including the header"),
+                cl::init(8));
+
+namespace {
+
+// A trace stream described by the metadata.
+struct TraceStream {
+  int packetID;
+  int col;
+  int row;
+  std::string module;
+  std::string mode;
+  SmallVector<std::string, 8> events;
+  std::vector<uint8_t> bytes;
+};
+
+// An interval during which a traced event was asserted.
+struct Interval {
+  int slot;
+  uint64_t start;
+  uint64_t end;
+};
+
+} // namespace
+
+static StringRef eventCategory(StringRef event) {
+  if (event.contains("LOCK"))
+    return "lock";
+  if (event.contains("STALL"))
+    return "stall";
+  if (event.contains("DMA"))
+    return "dma";
+  return "core";
+}
+
+static bool parseMetadata(const json::Value &value,
+                          std::map<int, TraceStream> &streams) {
+  const json::Object *root = value.getAsObject();
+  const json::Array *traces = root ? root->getArray("traces") : nullptr;
+  if (!traces)
+    return false;
+  for (const json::Value &traceValue : *traces) {
+    const json::Object *trace = traceValue.getAsObject();
+    if (!trace)
+      return false;
+    auto packetID = trace->getInteger("packet_id");
+    auto col = trace->getInteger("col");
+    auto row = trace->getInteger("row");
+    auto module = trace->getString("module");
+    auto mode = trace->getString("mode");
+    const json::Array *events = trace->getArray("events");
+    if (!packetID || !col || !row || !module || !mode || !events)
+      return false;
+    TraceStream &stream = streams[*packetID];
+    stream.packetID = *packetID;
+    stream.col = *col;
+    stream.row = *row;
+    stream.module = module->str();
+    stream.mode = mode->str();
+    for (const json::Value &event : *events) {
+      auto name = event.getAsString();
+      if (!name)
+        return false;
+      stream.events.push_back(name->str());
+    }
+  }
+  return true;
+}
+
+static bool parseWords(StringRef text, std::vector<uint32_t> &words) {
+  SmallVector<StringRef, 64> lines;
+  text.split(lines, '\n');
+  for (auto it : llvm::enumerate(lines)) {
+    StringRef line = it.value().split('#').first.trim();
+    if (line.empty())
+      continue;
+    line.consume_front("0x") || line.consume_front("0X");
+    uint32_t word;
+    if (line.getAsInteger(16, word)) {
+      WithColor::error() << inputFilename << ":" << it.index() + 1
+                         << ": expected a hex word\n";
+      return false;
+    }
+    words.push_back(word);
+  }
+  return true;
+}
+
+// Split the words into packets and append each payload to its stream.
+static void demultiplex(ArrayRef<uint32_t> words,
+                        std::map<int, TraceStream> &streams) {
+  std::map<int, bool> warned;
+  for (size_t i = 0; i < words.size(); i += packetWords) {
+    size_t length = std::min<size_t>(packetWords - 1, words.size() - i - 1);
+    ArrayRef<uint32_t> payload = words.slice(i + 1, length);
+    // The unused tail of the trace buffer is zero.
+    if (words[i] == 0 && llvm::all_of(payload, [](uint32_t w) { return !w; }))
+      continue;
+    if (length < packetWords - 1)
+      WithColor::warning() << "truncated packet of " << length + 1
+                           << " words at word " << i << "\n";
+    int packetID = words[i] & 0x1f;
+    auto stream = streams.find(packetID);
+    if (stream == streams.end()) {
+      if (!warned[packetID])
+        WithColor::warning() << "no trace with packet ID " << packetID
+                             << " in the metadata\n";
+      warned[packetID] = true;
+      continue;
+    }
+    for (uint32_t word : payload)
+      for (int shift = 24; shift >= 0; shift -= 8)
+        stream->second.bytes.push_back((word >> shift) & 0xff);
+  }
+}
+
+// Decode the frames of an event-time stream into intervals.
+static void decodeEventTime(const TraceStream &stream,
+                            std::vector<Interval> &intervals) {
+  ArrayRef<uint8_t> bytes = stream.bytes;
+  uint64_t time = 0;
+  uint8_t active = 0;
+  uint64_t opened[8] = {0};
+  uint8_t lastMask = 0;
+  uint32_t lastCycles = 0;
+
+  // Assert the slots in mask for the given number of cycles.
+  auto advance = [&](uint8_t mask, uint64_t cycles) {
+    for (int slot = 0; slot < 8; slot++) {
+      bool was = active & (1 << slot), is = mask & (1 << slot);
+      if (is && !was)
+        opened[slot] = time;
+      else if (!is && was)
+        intervals.push_back({slot, opened[slot], time});
+    }
+    active = mask;
+    time += cycles;
+  };
+  auto closeAll = [&]() { advance(0, 0); };
+  auto field = [&](size_t offset, int count) {
+    uint64_t value = 0;
+    for (int i = 0; i < count; i++)
+      value = (value << 8) | bytes[offset + i];
+    return value;
+  };
+
+  size_t pos = 0;
+  while (pos < bytes.size()) {
+    uint8_t b = bytes[pos];
+    int length;
+    uint8_t mask = 0;
+    uint32_t cycles = 0;
+    bool isEvent = true;
+    if ((b & 0x80) == 0) {
+      length = 1;
+      mask = 1 << ((b >> 4) & 0x7);
+      cycles = b & 0xf;
+    } else if ((b & 0xe0) == 0x80 || (b & 0xe0) == 0xa0) {
+      length = (b & 0xe0) == 0x80 ? 2 : 3;
+      if (pos + length > bytes.size())
+        break;
+      uint64_t frame = field(pos, length);
+      int cycleBits = length * 8 - 6;
+      mask = 1 << ((frame >> cycleBits) & 0x7);
+      cycles = frame & ((1u << cycleBits) - 1);
+    } else if ((b & 0xf0) >= 0xc0 && (b & 0xf0) <= 0xe0) {
+      length = ((b & 0xf0) - 0xc0) / 0x10 + 2;
+      if (pos + length > bytes.size())
+        break;
+      uint64_t frame = field(pos, length);
+      int cycleBits = length * 8 - 12;
+      mask = (frame >> cycleBits) & 0xff;
+      cycles = frame & ((1u << cycleBits) - 1);
+    } else if (b == 0xf0) {
+      length = 8;
+      if (pos + length > bytes.size())
+        break;
+      closeAll();
+      time = field(pos + 1, 7);
+      isEvent = false;
+    } else if ((b & 0xfc) == 0xf4 || b == 0xf8) {
+      length = b == 0xf8 ? 2 : 1;
+      if (pos + length > bytes.size())
+        break;
+      uint64_t repeats = (b == 0xf8 ? bytes[pos + 1] : (b & 0x3)) + 1;
+      advance(lastMask, repeats * (lastCycles + 1));
+      isEvent = false;
+    } else if ((b & 0xfe) == 0xfe) {
+      length = 1;
+      isEvent = false;
+    } else {
+      WithColor::warning() << "trace " << stream.packetID
+                           << ": unknown frame 0x" << utohexstr(b)
+                           << " at byte " << pos << "\n";
+      length = 1;
+      isEvent = false;
+    }
+    if (isEvent) {
+      advance(mask, cycles + 1);
+      lastMask = mask;
+      lastCycles = cycles;
+    }
+    pos += length;
+  }
+  closeAll();
+}
+
+static void writeTimeline(json::OStream &json,
+                          const std::map<int, TraceStream> &streams) {
+  json.object([&] {
+    json.attributeArray("traceEvents", [&] {
+      for (auto &it : streams) {
+        const TraceStream &stream = it.second;
+        int pid = stream.packetID;
+        json.object([&] {
+          json.attribute("name", "process_name");
+          json.attribute("ph", "M");
+          json.attribute("pid", pid);
+          json.attributeObject("args", [&] {
+            json.attribute("name", "tile(" + std::to_string(stream.col) +
+                                       "," + std::to_string(stream.row) +
+                                       ") " + stream.module);
+          });
+        });
+        for (auto event : llvm::enumerate(stream.events))
+          json.object([&] {
+            json.attribute("name", "thread_name");
+            json.attribute("ph", "M");
+            json.attribute("pid", pid);
+            json.attribute("tid", (int64_t)event.index());
+            json.attributeObject(
+                "args", [&] { json.attribute("name", event.value()); });
+          });
+
+        if (stream.mode != "EventTime") {
+          WithColor::warning() << "trace " << pid << ": " << stream.mode
+                               << " traces are not decoded\n";
+          continue;
+        }
+        std::vector<Interval> intervals;
+        decodeEventTime(stream, intervals);
+        for (const Interval &interval : intervals) {
+          // Slots beyond the configured events are never asserted by a
+          // correctly configured trace unit.
+          if (interval.slot >= (int)stream.events.size())
+            continue;
+          StringRef name = stream.events[interval.slot];
+          json.object([&] {
+            json.attribute("name", name);
+            json.attribute("cat", eventCategory(name));
+            json.attribute("ph", "X");
+            json.attribute("pid", pid);
+            json.attribute("tid", interval.slot);
+            json.attribute("ts", interval.start / clockMHz);
+            json.attribute("dur", (interval.end - interval.start) / clockMHz);
+          });
+        }
+      }
+    });
+    json.attribute("displayTimeUnit", "ns");
+  });
+}
+
+int main(int argc, char **argv) {
+  InitLLVM y(argc, argv);
+  cl::ParseCommandLineOptions(argc, argv, "AIE trace decoder\n");
+  if (packetWords < 2) {
+    WithColor::error() << "--packet-words must be at least 2\n";
+    return 1;
+  }
+
+  auto metadataFile = MemoryBuffer::getFile(metadataFilename);
+  if (!metadataFile) {
+    WithColor::error() << "cannot open " << metadataFilename << ": "
+                       << metadataFile.getError().message() << "\n";
+    return 1;
+  }
+  auto metadata = json::parse(metadataFile.get()->getBuffer());
+  if (!metadata) {
+    WithColor::error() << metadataFilename << ": "
+                       << toString(metadata.takeError()) << "\n";
+    return 1;
+  }
+  std::map<int, TraceStream> streams;
+  if (!parseMetadata(*metadata, streams)) {
+    WithColor::error() << metadataFilename << ": malformed trace metadata\n";
+    return 1;
+  }
+
+  auto inputFile = MemoryBuffer::getFileOrSTDIN(inputFilename);
+  if (!inputFile) {
+    WithColor::error() << "cannot open " << inputFilename << ": "
+                       << inputFile.getError().message() << "\n";
+    return 1;
+  }
+  std::vector<uint32_t> words;
+  if (!parseWords(inputFile.get()->getBuffer(), words))
+    return 1;
+  demultiplex(words, streams);
+
+  std::error_code ec;
+  ToolOutputFile output(outputFilename, ec, sys::fs::OF_None);
+  if (ec) {
+    WithColor::error() << "cannot open " << outputFilename << ": "
+                       << ec.message() << "\n";
+    return 1;
+  }
+  json::OStream json(output.os(), 2);
+  writeTimeline(json, streams);
+  output.os() << "\n";
+  output.keep();
+  return 0;
+}
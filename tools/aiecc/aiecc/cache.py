@@ -0,0 +1,151 @@
+#
+# This file is licensed under the Apache License v2.0 with LLVM Exceptions.
+# See https://llvm.org/LICENSE.txt for license information.
+# SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+#
+# (c) Copyright 2022 Xilinx Inc.
+
+"""
+Content-addressed cache for per-core compilation results.
+
+Cores in a herd often run the same kernel on buffers at the same addresses,
+and only differ in the names of the core function and of the buffers they
+touch.  The cache key is therefore computed over the core's LLVM IR, linker
+script and BCF after renaming those symbols to positional placeholders, so
+that all such cores share a single cache entry.  The ELF files are loaded
+by address, so reusing one that was linked with the symbol names of another
+core is harmless.
+"""
+
+import hashlib
+import os
+import re
+import shutil
+import tempfile
+import threading
+
+from subprocess import PIPE, run
+
+# Bump this when the layout of the cache or the way keys are computed
+# changes, to invalidate all existing entries.
+CACHE_VERSION = '1'
+
+_ldscript_symbol = re.compile(r'^(\S+) = \.;$', re.MULTILINE)
+_ldscript_input = re.compile(r'^INPUT\((.*)\)$', re.MULTILINE)
+_bcf_input = re.compile(r'^_include _file (\S+)', re.MULTILINE)
+
+
+def _read(path):
+    with open(path, 'rb') as f:
+        return f.read()
+
+
+def _tool_version(tool):
+    path = shutil.which(tool)
+    if not path:
+        return tool + ': not found'
+    t = run([path, '--version'], stdout=PIPE, stderr=PIPE)
+    return path + ': ' + t.stdout.decode(errors='replace')
+
+
+class CompileCache:
+    def __init__(self, cachedir, tools, files, flags):
+        """Create a cache rooted at cachedir.  The output of '--version' of
+        every tool in tools, the contents of every file in files and the
+        given flags are part of every key."""
+        self.cachedir = cachedir
+        self.hits = 0
+        self.misses = 0
+        self.lock = threading.Lock()
+        self.key_locks = {}
+        os.makedirs(cachedir, exist_ok=True)
+
+        h = hashlib.sha256()
+        h.update(CACHE_VERSION.encode())
+        for tool in tools:
+            h.update(_tool_version(tool).encode())
+        for f in files:
+            h.update(_read(f) if os.path.exists(f) else b'')
+        for flag in flags:
+            h.update(str(flag).encode())
+        self.base = h.hexdigest()
+
+    def key(self, core, llvmir, ldscript, bcf):
+        """Compute the key of the given core from its LLVM IR, linker script
+        and BCF files."""
+        (corecol, corerow, _) = core
+        ir = _read(llvmir).decode()
+        ld = _read(ldscript).decode()
+        bc = _read(bcf).decode()
+
+        # Give the core function and the buffers visible from the core
+        # positional names, in the address order of the linker script.
+        renames = {'core%d%d' % (corecol, corerow): '__core'}
+        for i, sym in enumerate(_ldscript_symbol.findall(ld)):
+            if sym not in renames and not sym.startswith('_'):
+                renames[sym] = '__buf%d' % i
+        pattern = re.compile(r'(?<![\w.$])(%s)(?![\w.$])' %
+                             '|'.join(map(re.escape, renames)))
+        rename = lambda m: renames[m.group(1)]
+        ir = pattern.sub(rename, ir)
+        ld = pattern.sub(rename, ld)
+        bc = pattern.sub(rename, bc)
+
+        h = hashlib.sha256()
+        h.update(self.base.encode())
+        for text in [ir, ld, bc]:
+            h.update(b'\0')
+            h.update(text.encode())
+        # Objects pulled in by the 'link_with' attribute of the core.
+        for f in _ldscript_input.findall(ld) + _bcf_input.findall(bc):
+            h.update(b'\0')
+            h.update(_read(f) if os.path.exists(f) else f.encode())
+        return h.hexdigest()
+
+    def _entry(self, key):
+        return os.path.join(self.cachedir, key[:2], key)
+
+    def key_lock(self, key):
+        """Return the lock serializing the compilation of the cores with the
+        given key within this invocation."""
+        with self.lock:
+            return self.key_locks.setdefault(key, threading.Lock())
+
+    def lookup(self, key, outputs):
+        """Copy the cached results for key to the files in outputs, a map
+        from result name to path.  Return False if any of them is missing."""
+        entry = self._entry(key)
+        found = all(os.path.exists(os.path.join(entry, name))
+                    for name in outputs)
+        if found:
+            for name, path in outputs.items():
+                shutil.copyfile(os.path.join(entry, name), path)
+        with self.lock:
+            if found:
+                self.hits += 1
+            else:
+                self.misses += 1
+        return found
+
+    def store(self, key, outputs):
+        """Record the files in outputs, a map from result name to path, as
+        the results for key.  Entries are staged in a temporary directory and
+        published with a single rename, so concurrent aiecc invocations
+        sharing a cache directory never see a partial entry."""
+        entry = self._entry(key)
+        os.makedirs(os.path.dirname(entry), exist_ok=True)
+        staging = tempfile.mkdtemp(dir=os.path.dirname(entry))
+        try:
+            for name, path in outputs.items():
+                shutil.copyfile(path, os.path.join(staging, name))
+            os.rename(staging, entry)
+        except OSError:
+            # Either a result is missing, or another invocation stored the
+            # same entry first.  Its results are just as good.
+            shutil.rmtree(staging, ignore_errors=True)
+
+    def summary(self):
+        total = self.hits + self.misses
+        return 'compile cache: %d hits, %d misses (%d%% hit rate), %s' % (
+            self.hits, self.misses, 100 * self.hits // total if total else 0,
+            self.cachedir)
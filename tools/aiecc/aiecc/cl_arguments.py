@@ -12,6 +12,7 @@ import sys
 import shutil
 
 from aiecc.configure import *
+import aiecc.codesize
 
 def parse_args():
     parser = argparse.ArgumentParser(prog='aiecc')
@@ -90,6 +91,46 @@ def parse_args():
             default=aie_disable_link,
             action='store_false',
             help='Disable linking of AIE code')
+    parser.add_argument('--in-process',
+            dest="in_process",
+            default=False,
+            action='store_true',
+            help='Run the MLIR lowering of the design in a single aie-compile process')
+    parser.add_argument('--incremental',
+            dest="incremental",
+            default=False,
+            action='store_true',
+            help='Only rebuild the cores and host interface whose part of the design changed since the last build in tmpdir')
+    parser.add_argument('--profile',
+            dest="profile",
+            default=False,
+            action='store_true',
+            help='Report the time spent in each stage, core and MLIR pass, and write a Chrome trace to tmpdir/aiecc_trace.json')
+    parser.add_argument('--code-size-budget',
+            dest="code_size_budget",
+            default=aiecc.codesize.DEFAULT_BUDGET,
+            type=_positive_int,
+            help='Program memory of a core in bytes (default is %(default)s).  Cores whose code is larger are compiled for size, and it is an error if they still do not fit')
+    parser.add_argument('--code-size-report',
+            dest="code_size_report",
+            default=False,
+            action='store_true',
+            help='Report the estimated and linked code size of every core')
+    parser.add_argument('--cache',
+            dest="cache",
+            default=False,
+            action='store_true',
+            help='Reuse AIE core objects and ELFs from the compile cache')
+    parser.add_argument('--no-cache',
+            dest="cache",
+            action='store_false',
+            help='Always compile AIE cores (default)')
+    parser.add_argument('--cache-dir',
+            metavar="cachedir",
+            dest="cachedir",
+            default=os.getenv('AIECC_CACHE_DIR',
+                              os.path.join(os.path.expanduser('~'), '.cache', 'aiecc')),
+            help='directory holding the compile cache (default is $AIECC_CACHE_DIR or ~/.cache/aiecc)')
     parser.add_argument('--pathfinder',
             dest="pathfinder",
             default=False,
@@ -0,0 +1,97 @@
+#
+# This file is licensed under the Apache License v2.0 with LLVM Exceptions.
+# See https://llvm.org/LICENSE.txt for license information.
+# SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+#
+# (c) Copyright 2022 Xilinx Inc.
+
+"""
+Program memory budget of the cores.
+
+The linker script lets the program of a core grow well beyond the program
+memory of the tile, so a core that does not fit is only noticed when it
+runs.  The size of the code of every core is estimated on its LLVM dialect
+by aie-estimate-code-size, and measured on its ELF after linking.  Cores
+over budget are compiled for size: optimized with Oz, which does not unroll
+loops, and with the machine outliner, which folds the loop bodies
+duplicated by the objectFifo lowering back into functions.
+"""
+
+import os
+import re
+import struct
+import threading
+
+# Program memory of an AIE1 core.
+DEFAULT_BUDGET = 16 * 1024
+
+OPT_PASSES = 'default<O2>,strip'
+OPT_PASSES_FOR_SIZE = 'default<Oz>,strip'
+LLC_FLAGS_FOR_SIZE = ['--enable-machine-outliner']
+
+_estimate = re.compile(r'AIE\.code_size = (\d+) : i64')
+
+_SHF_EXECINSTR = 0x4
+
+
+def estimate(core_mlir):
+    """Return the code size estimated by aie-estimate-code-size on the given
+    core module, or None if it was not estimated."""
+    if not os.path.exists(core_mlir):
+        return None
+    with open(core_mlir) as f:
+        m = _estimate.search(f.read())
+    return int(m.group(1)) if m else None
+
+
+def program_size(elf):
+    """Return the end address of the code in the given ELF file, which is
+    the program memory it takes since the code is linked at address 0."""
+    with open(elf, 'rb') as f:
+        data = f.read()
+    if data[:4] != b'\x7fELF':
+        raise ValueError(elf + ' is not an ELF file')
+    is64 = data[4] == 2
+    endian = '<' if data[5] == 1 else '>'
+    if is64:
+        shoff, = struct.unpack_from(endian + 'Q', data, 0x28)
+        shentsize, shnum = struct.unpack_from(endian + 'HH', data, 0x3A)
+        section = endian + 'IIQQQQ'
+    else:
+        shoff, = struct.unpack_from(endian + 'I', data, 0x20)
+        shentsize, shnum = struct.unpack_from(endian + 'HH', data, 0x2E)
+        section = endian + 'IIIIII'
+    end = 0
+    for i in range(shnum):
+        _, _, flags, addr, _, size = struct.unpack_from(
+            section, data, shoff + i * shentsize)
+        if flags & _SHF_EXECINSTR:
+            end = max(end, addr + size)
+    return end
+
+
+class CodeSizeReport:
+    def __init__(self, budget):
+        self.budget = budget
+        self.cores = {}
+        self.lock = threading.Lock()
+
+    def record(self, core, estimate, size, for_size):
+        """Record the estimated and linked code size of core, a (col, row,
+        elf_file) tuple, and whether it was compiled for size.  Any of them
+        may be None if it is not known, e.g. when the ELF came from the
+        compile cache."""
+        with self.lock:
+            self.cores[core[0:2]] = (estimate, size, for_size)
+
+    def summary(self):
+        lines = ['', 'core code size (budget %d bytes):' % self.budget,
+                 '  %-10s %12s %12s %8s' % ('core', 'estimated', 'linked',
+                                            'for size')]
+        fmt = lambda n: '-' if n is None else str(n)
+        yes_no = lambda b: '-' if b is None else ('yes' if b else 'no')
+        for (col, row), (est, size, for_size) in sorted(self.cores.items()):
+            lines.append('  %-10s %12s %12s %8s' %
+                         ('(%d, %d)' % (col, row), fmt(est), fmt(size),
+                          yes_no(for_size)))
+        return '\n'.join(lines)
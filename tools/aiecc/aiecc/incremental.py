@@ -0,0 +1,106 @@
+#
+# This file is licensed under the Apache License v2.0 with LLVM Exceptions.
+# See https://llvm.org/LICENSE.txt for license information.
+# SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+#
+# (c) Copyright 2022 Xilinx Inc.
+
+"""
+Incremental rebuilds driven by the dependencies of each artifact.
+
+aie-translate --aie-generate-dependencies hashes, for aie_inc.cpp and for
+every core, the parts of the physical design that artifact depends on.  The
+fingerprint of an artifact combines that hash with the files linked into it,
+the aiecc options and the MLIR tools, and for the cores with the backend tools
+and runtime libraries too.  It is recorded in the tmpdir after a successful
+build.  An artifact whose fingerprint did not change and whose outputs still
+exist is not rebuilt.
+"""
+
+import hashlib
+import json
+import os
+import shutil
+import threading
+
+MANIFEST = 'aiecc_dependencies.json'
+MANIFEST_VERSION = 1
+
+
+def _tool_id(tool):
+    path = shutil.which(tool)
+    if not path:
+        return tool
+    return '%s %d' % (path, os.stat(path).st_mtime_ns)
+
+
+class Dependencies:
+    def __init__(self, tmpdirname, dependencies, flags, tools=[], files=[]):
+        """Load the manifest of the previous build from tmpdirname, and
+        compute the fingerprints of the current one from the output of
+        --aie-generate-dependencies and the given flags.  The backend tools
+        and the files linked into every core are part of the fingerprints of
+        the cores."""
+        self.path = os.path.join(tmpdirname, MANIFEST)
+        self.lock = threading.Lock()
+        self.built = {}
+
+        self.previous = {}
+        try:
+            with open(self.path) as f:
+                manifest = json.load(f)
+            if manifest.get('version') == MANIFEST_VERSION:
+                self.previous = manifest['artifacts']
+        except (OSError, ValueError, KeyError):
+            pass
+
+        base = hashlib.sha256()
+        for flag in flags + [_tool_id('aie-opt'), _tool_id('aie-translate')]:
+            base.update(str(flag).encode())
+            base.update(b'\0')
+
+        def update(h, files):
+            for f in files:
+                h.update(b'\0')
+                if os.path.exists(f):
+                    with open(f, 'rb') as contents:
+                        h.update(contents.read())
+
+        core_base = base.copy()
+        for tool in tools:
+            core_base.update(_tool_id(tool).encode())
+            core_base.update(b'\0')
+        update(core_base, files)
+
+        def fingerprint(start, design_hash, files=[]):
+            h = start.copy()
+            h.update(design_hash.encode())
+            update(h, files)
+            return h.hexdigest()
+
+        deps = json.loads(dependencies)
+        self.current = {'aie_inc.cpp': fingerprint(base, deps['aie_inc.cpp'])}
+        for name, core in deps['cores'].items():
+            self.current[name] = fingerprint(core_base, core['hash'],
+                                             core['files'])
+
+    def up_to_date(self, artifact, outputs):
+        """Return True if the artifact does not need to be rebuilt, that is if
+        its fingerprint did not change and all its outputs exist."""
+        fingerprint = self.current.get(artifact)
+        if (fingerprint is None or self.previous.get(artifact) != fingerprint
+                or not all(os.path.exists(f) for f in outputs)):
+            return False
+        self.record(artifact)
+        return True
+
+    def record(self, artifact):
+        """Record that the artifact was built from the current design."""
+        with self.lock:
+            self.built[artifact] = self.current[artifact]
+
+    def save(self):
+        """Write the manifest of the artifacts that are up to date."""
+        with open(self.path, 'w') as f:
+            json.dump({'version': MANIFEST_VERSION, 'artifacts': self.built},
+                      f, indent=2, sort_keys=True)
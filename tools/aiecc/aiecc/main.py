@@ -20,12 +20,31 @@ import tempfile
 import shutil
 
 import aiecc.cl_arguments
+import aiecc.cache
+import aiecc.codesize
+import aiecc.incremental
+import aiecc.profile
+
+profiler = None
 
 def do_call(command):
     global opts
     if(opts.verbose):
         print(" ".join(command))
-    ret = call(command)
+    if(profiler):
+      begin = profiler.begin()
+      if(os.path.basename(command[0]) == 'aie-opt'):
+        # Also record the time spent in each pass.
+        t = run(command + aiecc.profile.MLIR_TIMING_FLAGS, stderr=PIPE, universal_newlines=True)
+        pass_timings, stderr = aiecc.profile.split_mlir_timing(t.stderr)
+        sys.stderr.write(stderr)
+        profiler.end(command, begin, pass_timings)
+        ret = t.returncode
+      else:
+        ret = call(command)
+        profiler.end(command, begin)
+    else:
+      ret = call(command)
     if(ret != 0):
         print("Error encountered while running: " + " ".join(command))
         sys.exit(1)
@@ -34,10 +53,20 @@ def do_run(command):
     global opts
     if(opts.verbose):
         print(" ".join(command))
+    if(profiler):
+      begin = profiler.begin()
     ret = run(command, stdout=PIPE, stderr=PIPE, universal_newlines=True)
+    if(profiler):
+      profiler.end(command, begin)
     return ret
 
 def run_flow(opts, tmpdirname):
+    # The temporary directory is passed as the value of a pass option, which
+    # ends at a space and cannot hold unbalanced braces.
+    if any(c in tmpdirname for c in ' {}'):
+      print("Error: the temporary directory '%s' cannot contain spaces or braces" % tmpdirname)
+      sys.exit(1)
+
     if shutil.which("clang_wrapper"):
       cc_path = "clang_wrapper"
     else:
@@ -52,10 +81,46 @@ def run_flow(opts, tmpdirname):
     chess_intrinsic_wrapper_cpp = os.path.join(thispath, '..','..','runtime_lib', 'chess_intrinsic_wrapper.cpp')
 
     file_with_addresses = os.path.join(tmpdirname, 'input_with_addresses.mlir')
-    do_call(['aie-opt', '--aie-create-locks', '--lower-affine', '--aie-register-objectFifos', '--aie-unroll-objectFifos', '--aie-objectFifo-stateful-transform', '--aie-lower-broadcast-packet', '--aie-create-packet-flows', '--aie-assign-buffer-addresses', '-convert-scf-to-cf', opts.filename, '-o', file_with_addresses])
-    t = do_run(['aie-translate', '--aie-generate-corelist', file_with_addresses])
+    if(opts.in_process):
+      # aie-compile runs all the aie-opt and aie-translate steps below in a
+      # single process, and prints the list of cores.
+      cmd = ['aie-compile', opts.filename, '--tmpdir=%s' % tmpdirname, '-j', str(opts.nthreads)]
+      cmd += ['--aie-generate-xaie' if opts.xaie == 1 else '--aie-generate-xaiev2']
+      cmd += ['--code-size-budget=%d' % opts.code_size_budget]
+      if(opts.pathfinder):
+        cmd += ['--pathfinder']
+      if(opts.verbose):
+        cmd += ['-v']
+      t = do_run(cmd)
+      if(t.returncode != 0):
+        sys.stderr.write(t.stderr)
+        print("Error encountered while running: " + " ".join(cmd))
+        sys.exit(1)
+    else:
+      do_call(['aie-opt', '--aie-create-locks', '--lower-affine', '--aie-register-objectFifos', '--aie-unroll-objectFifos', '--aie-objectFifo-stateful-transform', '--aie-route-traces', '--aie-lower-broadcast-packet', '--aie-create-packet-flows', '--aie-assign-buffer-addresses', '-convert-scf-to-cf', opts.filename, '-o', file_with_addresses])
+      t = do_run(['aie-translate', '--aie-generate-corelist', file_with_addresses])
     cores = eval(t.stdout)
 
+    def corefile(dirname, core, ext):
+        (corecol, corerow, _) = core
+        return os.path.join(dirname, 'core_%d_%d.%s' % (corecol, corerow, ext))
+
+    def tmpcorefile(core, ext):
+        return corefile(tmpdirname, core, ext)
+
+    def coreartifact(core):
+        (corecol, corerow, _) = core
+        return 'core_%d_%d' % (corecol, corerow)
+
+    # The files produced for the core by process_core().
+    def coreoutputs(core):
+        (_, _, elf_file) = core
+        if not opts.compile:
+          return [tmpcorefile(core, "ll")]
+        if not opts.link:
+          return [tmpcorefile(core, "o")]
+        return [elf_file if elf_file else corefile(".", core, "elf")]
+
     if(opts.xchesscc == True):
       chess_intrinsic_wrapper = os.path.join(tmpdirname, 'chess_intrinsic_wrapper.ll')
       do_call(['xchesscc_wrapper', '-c', '-d', '-f', '+f', '+P', '4', chess_intrinsic_wrapper_cpp, '-o', chess_intrinsic_wrapper])      
@@ -64,12 +129,26 @@ def run_flow(opts, tmpdirname):
       do_call(['sed', '-i', 's/noalias_sidechannel[^,]*,//', chess_intrinsic_wrapper])
       do_call(['sed', '-i', 's/nocallback[^,]*,//', chess_intrinsic_wrapper])
 
-    def corefile(dirname, core, ext):
-        (corecol, corerow, _) = core
-        return os.path.join(dirname, 'core_%d_%d.%s' % (corecol, corerow, ext))
-
-    def tmpcorefile(core, ext):
-        return corefile(tmpdirname, core, ext)
+    # Everything the backend compile and link depend on, other than the
+    # per-core files.
+    backend_tools = ['xchesscc_wrapper'] if opts.xchesscc else ['opt', 'llc']
+    backend_tools += ['xchesscc_wrapper'] if opts.xbridge else [cc_path]
+    backend_files = [me_basic_o, libm]
+    if(opts.xchesscc):
+      backend_files += [chess_intrinsic_wrapper]
+
+    # Only rebuild the artifacts whose part of the design changed since the
+    # last build in tmpdirname.
+    deps = None
+    if(opts.incremental):
+      t = do_run(['aie-translate', '--aie-generate-dependencies', file_with_addresses])
+      deps = aiecc.incremental.Dependencies(tmpdirname, t.stdout,
+                                            [opts.xchesscc, opts.xbridge, opts.compile, opts.link,
+                                             opts.pathfinder, opts.xaie, opts.code_size_budget],
+                                            backend_tools if opts.compile else [],
+                                            backend_files if opts.compile else [])
+    stale_cores = [core for core in cores
+                   if not deps or not deps.up_to_date(coreartifact(core), coreoutputs(core))]
 
     # Extract included files from the given Chess linker script.
     # We rely on gnu linker scripts to stuff object files into a compile.  However, the Chess compiler doesn't 
@@ -78,31 +157,92 @@ def run_flow(opts, tmpdirname):
         t = do_run(['awk', '/_include _file/ {print($3)}', file_core_bcf])
         return ' '.join(t.stdout.split())
 
+    # Lower all the cores to the LLVM dialect in a single aie-opt run, which
+    # writes core_<col>_<row>.mlir for every core into tmpdirname, along with
+    # the estimated size of its code.
+    core_pipeline = ','.join(['aie-normalize-address-spaces',
+                              'aievec-standard-lowering',
+                              'canonicalize',
+                              'cse',
+                              'convert-vector-to-llvm',
+                              'convert-memref-to-llvm',
+                              'convert-func-to-llvm{use-bare-ptr-memref-call-conv=1}',
+                              'convert-cf-to-llvm',
+                              'canonicalize', 'cse',
+                              'aie-estimate-code-size{budget=%d}' % opts.code_size_budget])
+    if not opts.in_process and stale_cores:
+      do_call(['aie-opt', '--aie-localize-locks',
+                          '--aie-standard-lowering=output-dir=%s core-pipeline={%s}' % (tmpdirname, core_pipeline),
+                          file_with_addresses, '-o', os.devnull])
+      # Write the linker script and BCF file of every core into tmpdirname.
+      do_call(['aie-translate', file_with_addresses, '--aie-generate-linker-files', '--output-dir=%s' % tmpdirname, '-o', os.devnull])
+
+    cache = None
+    if(opts.cache and opts.compile):
+      cache = aiecc.cache.CompileCache(opts.cachedir, backend_tools, backend_files,
+                                       [opts.xchesscc, opts.xbridge, opts.link,
+                                        opts.code_size_budget])
+
+    code_sizes = aiecc.codesize.CodeSizeReport(opts.code_size_budget)
+
     def process_core(core):
         (corecol, corerow, elf_file) = core
-        file_core = tmpcorefile(core, "mlir")
-        do_call(['aie-opt', '--aie-localize-locks',
-                            '--aie-standard-lowering=tilecol=%d tilerow=%d' % core[0:2],
-                            file_with_addresses, '-o', file_core])
-        file_opt_core = tmpcorefile(core, "opt.mlir")
-        do_call(['aie-opt', '--aie-normalize-address-spaces',
-                            '--canonicalize',
-                            '--cse',
-                            '--convert-vector-to-llvm',
-                            '--convert-memref-to-llvm',
-                            '--convert-func-to-llvm=use-bare-ptr-memref-call-conv',
-                            '--convert-cf-to-llvm',
-                            '--canonicalize', '--cse', file_core, '-o', file_opt_core])
+        file_opt_core = tmpcorefile(core, "mlir")
         file_core_bcf = tmpcorefile(core, "bcf")
-        do_call(['aie-translate', file_with_addresses, '--aie-generate-bcf', '--tilecol=%d' % corecol, '--tilerow=%d' % corerow, '-o', file_core_bcf])
         file_core_ldscript = tmpcorefile(core, "ld.script")
-        do_call(['aie-translate', file_with_addresses, '--aie-generate-ldscript', '--tilecol=%d' % corecol, '--tilerow=%d' % corerow, '-o', file_core_ldscript])
         file_core_llvmir = tmpcorefile(core, "ll")
-        do_call(['aie-translate', '--mlir-to-llvmir', '--opaque-pointers=0', file_opt_core, '-o', file_core_llvmir])
+        if not opts.in_process:
+          do_call(['aie-translate', '--mlir-to-llvmir', '--opaque-pointers=0', file_opt_core, '-o', file_core_llvmir])
         file_core_elf = elf_file if elf_file else corefile(".", core, "elf")
         file_core_obj = tmpcorefile(core, "o")
+        estimate = aiecc.codesize.estimate(file_opt_core)
         if not opts.compile:
+          code_sizes.record(core, estimate, None, False)
           return
+        files = (file_core_llvmir, file_core_bcf, file_core_ldscript, file_core_obj, file_core_elf)
+        if not cache:
+          for_size = compile_core_within_budget(core, estimate, *files)
+        else:
+          key = cache.key(core, file_core_llvmir, file_core_ldscript, file_core_bcf)
+          outputs = {'elf': file_core_elf} if opts.link else {'o': file_core_obj}
+          if(opts.verbose):
+            print('core (%d, %d): compile cache key %s' % (corecol, corerow, key))
+          # Cores with the same key wait for the first one to be compiled.
+          with cache.key_lock(key):
+            for_size = None
+            if not cache.lookup(key, outputs):
+              for_size = compile_core_within_budget(core, estimate, *files)
+              cache.store(key, outputs)
+
+        size = aiecc.codesize.program_size(file_core_elf) if opts.link else None
+        code_sizes.record(core, estimate, size, for_size)
+        if size is not None and size > opts.code_size_budget:
+          print("Error: the program of core (%d, %d) takes %d bytes, more than the %d bytes of program memory" %
+                (corecol, corerow, size, opts.code_size_budget))
+          sys.exit(1)
+
+    # Compile the core, and compile it again for size if it is over the
+    # program memory budget.  Return whether it was compiled for size.
+    def compile_core_within_budget(core, estimate, *files):
+        (corecol, corerow, _) = core
+        (_, _, _, _, file_core_elf) = files
+        budget = opts.code_size_budget
+        for_size = estimate is not None and estimate > budget
+        if for_size:
+          print("core (%d, %d): estimated code size of %d bytes is over the budget of %d bytes, compiling for size" %
+                (corecol, corerow, estimate, budget))
+        compile_core(core, *files, for_size=for_size)
+        # Chess has no equivalent of the size pipeline.
+        if opts.link and not for_size and not opts.xchesscc:
+          size = aiecc.codesize.program_size(file_core_elf)
+          if size > budget:
+            print("core (%d, %d): code size of %d bytes is over the budget of %d bytes, compiling for size" %
+                  (corecol, corerow, size, budget))
+            for_size = True
+            compile_core(core, *files, for_size=for_size)
+        return for_size
+
+    def compile_core(core, file_core_llvmir, file_core_bcf, file_core_ldscript, file_core_obj, file_core_elf, for_size=False):
         if(opts.xchesscc):
           file_core_llvmir_chesshack = tmpcorefile(core, "chesshack.ll")
           do_call(['cp', file_core_llvmir, file_core_llvmir_chesshack])
@@ -127,8 +267,13 @@ def run_flow(opts, tmpdirname):
             '-Wl,-T,'+file_core_ldscript, '-o', file_core_elf])
         else:
           file_core_llvmir_stripped = tmpcorefile(core, "stripped.ll")
-          do_call(['opt', '--passes=default<O2>,strip', '-S', file_core_llvmir, '-o', file_core_llvmir_stripped])
-          do_call(['llc', file_core_llvmir_stripped, '-O2', '--march=aie', '--filetype=obj', '-o', file_core_obj])
+          if for_size:
+            do_call(['opt', '--passes=' + aiecc.codesize.OPT_PASSES_FOR_SIZE, '-S', file_core_llvmir, '-o', file_core_llvmir_stripped])
+            do_call(['llc', file_core_llvmir_stripped, '-O2', '--march=aie', '--filetype=obj'] +
+                    aiecc.codesize.LLC_FLAGS_FOR_SIZE + ['-o', file_core_obj])
+          else:
+            do_call(['opt', '--passes=' + aiecc.codesize.OPT_PASSES, '-S', file_core_llvmir, '-o', file_core_llvmir_stripped])
+            do_call(['llc', file_core_llvmir_stripped, '-O2', '--march=aie', '--filetype=obj', '-o', file_core_obj])
           if not opts.link:
             return
           if(opts.xbridge):
@@ -140,19 +285,34 @@ def run_flow(opts, tmpdirname):
 
 
 
+    def build_core(core):
+        if(profiler):
+          profiler.set_core(core)
+        process_core(core)
+        if(deps):
+          deps.record(coreartifact(core))
+
     def process_arm_cgen():
+      if(profiler):
+        profiler.set_core(None)
+
       # Generate the included host interface
       file_physical = os.path.join(tmpdirname, 'input_physical.mlir')
-      if(opts.pathfinder):
-        do_call(['aie-opt', '--aie-create-pathfinder-flows', '--aie-lower-broadcast-packet', '--aie-create-packet-flows', file_with_addresses, '-o', file_physical]);
-      else:
-        do_call(['aie-opt', '--aie-create-flows', '--aie-lower-broadcast-packet', '--aie-create-packet-flows', file_with_addresses, '-o', file_physical]);
       file_inc_cpp = os.path.join(tmpdirname, 'aie_inc.cpp')
-      if(opts.xaie == 1):
-          do_call(['aie-translate', '--aie-generate-xaie', '--xaie-target=v1', file_physical, '-o', file_inc_cpp])
-      else:
-          do_call(['aie-translate', '--aie-generate-xaie', '--xaie-target=v2', file_physical, '-o', file_inc_cpp])
-
+      if(deps and deps.up_to_date('aie_inc.cpp', [file_physical, file_inc_cpp])):
+        if(opts.verbose):
+          print('aie_inc.cpp is up to date')
+      elif not opts.in_process:
+        if(opts.pathfinder):
+          do_call(['aie-opt', '--aie-create-pathfinder-flows', '--aie-lower-broadcast-packet', '--aie-create-packet-flows', file_with_addresses, '-o', file_physical]);
+        else:
+          do_call(['aie-opt', '--aie-create-flows', '--aie-lower-broadcast-packet', '--aie-create-packet-flows', file_with_addresses, '-o', file_physical]);
+        if(opts.xaie == 1):
+            do_call(['aie-translate', '--aie-generate-xaie', '--xaie-target=v1', file_physical, '-o', file_inc_cpp])
+        else:
+            do_call(['aie-translate', '--aie-generate-xaie', '--xaie-target=v2', file_physical, '-o', file_inc_cpp])
+      if(deps):
+        deps.record('aie_inc.cpp')
 
       # Lastly, compile the generated host interface with any ARM code.
       if not opts.compile_host:
@@ -176,7 +336,7 @@ def run_flow(opts, tmpdirname):
       if(opts.xaie == 1):
         cmd += ['-fuse-ld=%s' % ld_path,'-lm','-rdynamic','-lxaiengine','-lmetal','-lopen_amp','-ldl']
       else:
-        cmd += ['-fuse-ld=%s' % ld_path,'-lm','-rdynamic','-lxaiengine','-ldl']
+        cmd += ['-fuse-ld=%s' % ld_path,'-lm','-rdynamic','-lxaiengine','-ldl','-lpthread']
     
 
       if(len(opts.arm_args) > 0):
@@ -190,14 +350,33 @@ def run_flow(opts, tmpdirname):
       with ThreadPool(nthreads) as thdpool:
           # prefer to dispatch and process_arm_cgen() first, it typically takes longer than process_core()
           thdpool.apply_async(process_arm_cgen)
-          thdpool.map(process_core, (cores))
+          thdpool.map(build_core, (stale_cores))
           thdpool.close()
           thdpool.join()
     else:
-      for core in cores:
-        process_core(core)
+      for core in stale_cores:
+        build_core(core)
       process_arm_cgen()
 
+    if(cache):
+      print(cache.summary())
+    if(opts.code_size_report):
+      # The cores that were up to date keep the code of the previous build.
+      for core in cores:
+        if core not in stale_cores:
+          elf = coreoutputs(core)[0] if opts.link else None
+          code_sizes.record(core, aiecc.codesize.estimate(tmpcorefile(core, "mlir")),
+                            aiecc.codesize.program_size(elf) if elf else None, None)
+      print(code_sizes.summary())
+    if(deps):
+      deps.save()
+      print('incremental build: rebuilt %d of %d cores' % (len(stale_cores), len(cores)))
+    if(profiler):
+      trace = os.path.join(tmpdirname, 'aiecc_trace.json')
+      profiler.write_trace(trace)
+      print(profiler.summary())
+      print('\nChrome trace written to ' + trace)
+
 
 def main(builtin_params={}):
     thispath = os.path.dirname(os.path.realpath(__file__))
@@ -238,6 +417,9 @@ def main(builtin_params={}):
     
     global opts
     opts = aiecc.cl_arguments.parse_args()
+    if(opts.profile):
+      global profiler
+      profiler = aiecc.profile.Profiler()
     is_windows = platform.system() == 'Windows'
 
     if(opts.verbose):
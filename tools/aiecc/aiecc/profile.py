@@ -0,0 +1,167 @@
+#
+# This file is licensed under the Apache License v2.0 with LLVM Exceptions.
+# See https://llvm.org/LICENSE.txt for license information.
+# SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+#
+# (c) Copyright 2022 Xilinx Inc.
+
+"""
+Compile-time profiling of the aiecc stages.
+
+Every command run by aiecc is recorded with its wall time, its stage and
+the core it was run for.  aie-opt is run with --mlir-timing, and the pass
+timings it reports are recorded as well.  The result is written as a Chrome
+trace (chrome://tracing or https://ui.perfetto.dev) and summarized in a
+table.
+"""
+
+import json
+import os
+import re
+import threading
+import time
+
+# With --mlir-timing-display=list, the MLIR timing report lists the wall time
+# of every pass, e.g. "    0.0123 ( 45.6%)  CSE", and ends with the total.
+MLIR_TIMING_FLAGS = ['--mlir-timing', '--mlir-timing-display=list']
+_timing_title = re.compile(r'^\s*\.\.\. Execution time report \.\.\.\s*$')
+_timing_line = re.compile(r'^\s+([0-9.]+) \(\s*[0-9.]+%\)\s+(.*?)\s*$')
+
+# The aie-opt commands running a router.  The packet flows are created along
+# with the lowering to the physical form, which is not counted as routing.
+ROUTING_FLAGS = ['--aie-create-flows', '--aie-create-pathfinder-flows']
+
+
+def stage(command):
+    """Return the stage of aiecc the given command belongs to."""
+    tool = os.path.basename(command[0])
+    if tool == 'aie-opt':
+        if any(arg in ROUTING_FLAGS for arg in command):
+            return 'routing'
+        return 'lowering'
+    if tool == 'aie-compile':
+        return 'lowering'
+    if tool == 'aie-translate':
+        if '--aie-generate-xaie' in command:
+            return 'host interface'
+        return 'translation'
+    if tool in ['opt', 'llc', 'llvm-link']:
+        return 'backend compile'
+    if tool == 'xchesscc_wrapper':
+        return 'backend compile' if '-c' in command else 'link'
+    if '--target=aie' in command:
+        return 'link'
+    if any(arg.startswith('--target=') for arg in command):
+        return 'host compile'
+    return 'other'
+
+
+def split_mlir_timing(stderr):
+    """Split the stderr of an MLIR tool into the pass timings and the rest."""
+    lines = stderr.splitlines(keepends=True)
+    start = next((i for i, line in enumerate(lines)
+                  if _timing_title.match(line)), None)
+    if start is None:
+        return [], stderr
+
+    # The title is framed by two "===---===" lines.
+    timings = []
+    end = start + 1
+    while end < len(lines):
+        m = _timing_line.match(lines[end])
+        end += 1
+        if m and m.group(2) == 'Total':
+            break
+        if m:
+            timings.append((m.group(2), float(m.group(1))))
+    return timings, ''.join(lines[:max(start - 1, 0)] + lines[end:])
+
+
+class Profiler:
+    def __init__(self):
+        self.start = time.perf_counter()
+        self.events = []
+        self.lock = threading.Lock()
+        self.local = threading.local()
+
+    def set_core(self, core):
+        """Attribute the following commands of this thread to core, a
+        (col, row, elf_file) tuple, or to the host if core is None."""
+        self.local.core = core
+
+    def _now(self):
+        return time.perf_counter() - self.start
+
+    def begin(self):
+        return self._now()
+
+    def end(self, command, begin, pass_timings=()):
+        """Record the command that ran from begin until now, and the timings
+        of the MLIR passes it ran."""
+        duration = self._now() - begin
+        core = getattr(self.local, 'core', None)
+        track = 'core (%d, %d)' % core[0:2] if core else 'host'
+        event = {'name': os.path.basename(command[0]),
+                 'stage': stage(command),
+                 'track': track,
+                 'begin': begin,
+                 'duration': duration,
+                 'command': ' '.join(command),
+                 'passes': pass_timings}
+        with self.lock:
+            self.events.append(event)
+
+    def write_trace(self, path):
+        tracks = sorted(set(e['track'] for e in self.events),
+                        key=lambda t: (t != 'host', t))
+        tids = {track: i for i, track in enumerate(tracks)}
+        trace = [{'name': 'thread_name', 'ph': 'M', 'pid': 0,
+                  'tid': tid, 'args': {'name': track}}
+                 for track, tid in tids.items()]
+        us = lambda seconds: int(seconds * 1e6)
+        for e in self.events:
+            trace.append({'name': e['name'], 'cat': e['stage'], 'ph': 'X',
+                          'pid': 0, 'tid': tids[e['track']],
+                          'ts': us(e['begin']), 'dur': us(e['duration']),
+                          'args': {'command': e['command']}})
+            # The timing report only gives the total time of every pass, so
+            # they are laid out one after the other within the command.
+            ts = e['begin']
+            for name, seconds in e['passes']:
+                trace.append({'name': name, 'cat': 'pass', 'ph': 'X',
+                              'pid': 0, 'tid': tids[e['track']],
+                              'ts': us(ts), 'dur': us(seconds)})
+                ts += seconds
+        with open(path, 'w') as f:
+            json.dump({'traceEvents': trace, 'displayTimeUnit': 'ms'}, f)
+
+    def summary(self):
+        total = self._now()
+        lines = ['', 'aiecc compile time: %.3f s' % total, '',
+                 '  %-16s %8s %12s %12s' % ('stage', 'commands',
+                                            'total (s)', 'max (s)')]
+        stages = {}
+        for e in self.events:
+            stages.setdefault(e['stage'], []).append(e['duration'])
+        for name, times in sorted(stages.items(), key=lambda s: -sum(s[1])):
+            lines.append('  %-16s %8d %12.3f %12.3f' %
+                         (name, len(times), sum(times), max(times)))
+
+        cores = {}
+        for e in self.events:
+            if e['track'] != 'host':
+                cores[e['track']] = cores.get(e['track'], 0) + e['duration']
+        if cores:
+            lines += ['', '  slowest cores:']
+            for track, t in sorted(cores.items(), key=lambda c: -c[1])[:5]:
+                lines.append('  %-16s %12.3f' % (track, t))
+
+        passes = {}
+        for e in self.events:
+            for name, seconds in e['passes']:
+                passes[name] = passes.get(name, 0) + seconds
+        if passes:
+            lines += ['', '  slowest MLIR passes:']
+            for name, t in sorted(passes.items(), key=lambda p: -p[1])[:10]:
+                lines.append('  %-40s %12.3f' % (name, t))
+        return '\n'.join(lines)
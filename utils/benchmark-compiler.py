@@ -0,0 +1,151 @@
+#!/usr/bin/env python3
+##===- utils/benchmark-compiler.py - Time the compiler passes -*- Script -*-===##
+#
+# This file licensed under the Apache License v2.0 with LLVM Exceptions.
+# See https://llvm.org/LICENSE.txt for license information.
+# SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+#
+##===----------------------------------------------------------------------===##
+#
+# This script measures the wall time and the peak memory of the compiler
+# stages that scale with the size of the array, on synthetic designs printed
+# by generate-design.py of increasing sizes, up to the full 50x8 array.
+#
+# benchmark-compiler.py [--tools-dir <dir>] [--json <file>] [--baseline <file>]
+#
+# Every stage runs on the output of the previous one, in its own process, so
+# that its peak resident set size can be measured on its own.
+#
+##===----------------------------------------------------------------------===##
+
+import argparse
+import json
+import os
+import subprocess
+import sys
+import tempfile
+import time
+
+STAGES = [
+    ('objectFifo', 'aie-opt', ['--aie-objectFifo-stateful-transform']),
+    ('packet-flows', 'aie-opt', ['--aie-create-packet-flows']),
+    ('pathfinder', 'aie-opt', ['--aie-create-pathfinder-flows']),
+    ('buffers', 'aie-opt', ['--aie-assign-buffer-addresses']),
+    ('xaie', 'aie-translate', ['--aie-generate-xaie']),
+]
+
+# The designs benchmarked at every size, as generate-design.py options.
+DESIGNS = [
+    ('neighbour', ['--flows', 'neighbour', '--object-fifos', 'neighbour']),
+    ('random', ['--flows', 'random', '--object-fifos', 'random',
+                '--packet-flows', '32', '--packet-fanout', '2']),
+]
+
+DEFAULT_SIZES = '2x2,4x4,8x4,16x8,32x8,50x8'
+
+
+def parse_args(args=sys.argv[1:]):
+    parser = argparse.ArgumentParser(
+        description='Benchmark the AIE compiler on synthetic designs')
+    parser.add_argument('--tools-dir', default='',
+                        help='directory holding aie-opt and aie-translate '
+                        '(default is to look them up in PATH)')
+    parser.add_argument('--sizes', default=DEFAULT_SIZES,
+                        help='comma separated list of array sizes, as '
+                        '<cols>x<rows> (default is %s)' % DEFAULT_SIZES)
+    parser.add_argument('--repeat', type=int, default=3,
+                        help='number of runs of every stage, of which the '
+                        'fastest is reported')
+    parser.add_argument('--seed', type=int, default=0,
+                        help='seed of the random designs')
+    parser.add_argument('--json', dest='json_file',
+                        help='write the results to this file')
+    parser.add_argument('--baseline',
+                        help='compare against the results of an earlier run, '
+                        'written with --json')
+    return parser.parse_args(args)
+
+
+def run(command, stdin, stdout):
+    """Run command, returning its wall time in seconds and its peak resident
+    set size in MiB."""
+    with tempfile.TemporaryFile() as stderr:
+        begin = time.perf_counter()
+        proc = subprocess.Popen(command, stdin=stdin, stdout=stdout,
+                                stderr=stderr)
+        # wait4 gives the resource usage of this process alone, unlike
+        # getrusage(RUSAGE_CHILDREN) which reports the maximum over all
+        # children.
+        _, status, usage = os.wait4(proc.pid, 0)
+        elapsed = time.perf_counter() - begin
+        if status != 0:
+            stderr.seek(0)
+            sys.exit('%s failed:\n%s' % (' '.join(command),
+                                          stderr.read().decode()))
+    return elapsed, usage.ru_maxrss / 1024
+
+
+def benchmark(opts, name, design_args, cols, rows, tmpdir):
+    generator = os.path.join(os.path.dirname(os.path.abspath(__file__)),
+                             'generate-design.py')
+    current = os.path.join(tmpdir, 'design.mlir')
+    with open(current, 'w') as f:
+        subprocess.check_call([sys.executable, generator,
+                               '--cols', str(cols), '--rows', str(rows),
+                               '--seed', str(opts.seed)] + design_args,
+                              stdout=f)
+
+    results = []
+    for i, (stage, tool, flags) in enumerate(STAGES):
+        output = os.path.join(tmpdir, 'stage%d.out' % i)
+        command = [os.path.join(opts.tools_dir, tool)] + flags
+        runs = []
+        for _ in range(opts.repeat):
+            with open(current) as fin, open(output, 'w') as fout:
+                runs.append(run(command, fin, fout))
+        results.append({'design': name, 'size': '%dx%d' % (cols, rows),
+                        'stage': stage,
+                        'seconds': min(r[0] for r in runs),
+                        'peak_mib': max(r[1] for r in runs)})
+        current = output
+    return results
+
+
+def main():
+    opts = parse_args()
+    sizes = [tuple(int(n) for n in size.split('x'))
+             for size in opts.sizes.split(',')]
+
+    baseline = {}
+    if opts.baseline:
+        with open(opts.baseline) as f:
+            for r in json.load(f):
+                baseline[(r['design'], r['size'], r['stage'])] = r
+
+    results = []
+    header = '%-10s %-6s %-13s %10s %10s' % ('design', 'size', 'stage',
+                                            'time (s)', 'peak (MiB)')
+    if baseline:
+        header += ' %10s' % 'vs. base'
+    print(header)
+    with tempfile.TemporaryDirectory() as tmpdir:
+        for name, design_args in DESIGNS:
+            for cols, rows in sizes:
+                for r in benchmark(opts, name, design_args, cols, rows,
+                                   tmpdir):
+                    line = '%-10s %-6s %-13s %10.3f %10.1f' % (
+                        r['design'], r['size'], r['stage'], r['seconds'],
+                        r['peak_mib'])
+                    base = baseline.get((r['design'], r['size'], r['stage']))
+                    if base and base['seconds'] > 0:
+                        line += ' %9.2fx' % (r['seconds'] / base['seconds'])
+                    print(line, flush=True)
+                    results.append(r)
+
+    if opts.json_file:
+        with open(opts.json_file, 'w') as f:
+            json.dump(results, f, indent=2)
+
+
+if __name__ == '__main__':
+    main()
@@ -0,0 +1,27 @@
+#!/bin/bash
+##===- utils/check-deterministic.sh - Check a command is deterministic -*- Script -*-===##
+# 
+# This file licensed under the Apache License v2.0 with LLVM Exceptions.
+# See https://llvm.org/LICENSE.txt for license information.
+# SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+# 
+##===----------------------------------------------------------------------===##
+#
+# This script runs the given command twice, in separate processes, and fails
+# if the two runs do not print the same output.  Since the operations of the
+# two runs are allocated at different addresses, this catches passes whose
+# output depends on the iteration order of maps keyed by pointers.
+#
+# check-deterministic.sh <command> [<args>...]
+#
+# e.g. check-deterministic.sh aie-opt --aie-create-packet-flows input.mlir
+#
+##===----------------------------------------------------------------------===##
+
+first=$(mktemp)
+second=$(mktemp)
+trap 'rm -f "$first" "$second"' EXIT
+
+"$@" > "$first" || exit 1
+"$@" > "$second" || exit 1
+diff -u "$first" "$second"
@@ -0,0 +1,198 @@
+#!/usr/bin/env python3
+##===- utils/generate-design.py - Generate synthetic AIE designs -*- Script -*-===##
+#
+# This file licensed under the Apache License v2.0 with LLVM Exceptions.
+# See https://llvm.org/LICENSE.txt for license information.
+# SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+#
+##===----------------------------------------------------------------------===##
+#
+# This script prints a synthetic AIE design for measuring how the compiler
+# scales: an array of cols x rows cores, with their buffers, connected by
+# circuit-switched flows, packet flows and objectFifos.
+#
+# generate-design.py --cols <n> --rows <m> [options]
+#
+# e.g. generate-design.py --cols 50 --rows 8 --flows random --packet-flows 64
+#
+# Circuit-switched flows go from the DMA channels of a tile to the DMA
+# channels of another one, and packet flows from Core : 0 to Core : 1, so
+# that every tile has at most two incoming and two outgoing circuit flows.
+# ObjectFifos between tiles that are not vertical neighbours may be lowered
+# to DMAs, so they take up DMA channels of their tiles as well.
+#
+##===----------------------------------------------------------------------===##
+
+import argparse
+import random
+import sys
+
+FIFO_TYPE = '!AIE.objectFifo<memref<16xi32>>'
+SUBVIEW_TYPE = '!AIE.objectFifoSubview<memref<16xi32>>'
+
+
+def parse_args(args=sys.argv[1:]):
+    parser = argparse.ArgumentParser(
+        description='Print a synthetic AIE design')
+    parser.add_argument('--cols', type=int, default=4,
+                        help='number of columns of cores')
+    parser.add_argument('--rows', type=int, default=4,
+                        help='number of rows of cores, starting at row 1')
+    parser.add_argument('--flows', default='neighbour',
+                        choices=['none', 'neighbour', 'random', 'all-to-all'],
+                        help='pattern of circuit-switched flows between cores')
+    parser.add_argument('--group', type=int, default=2,
+                        help='side of the square groups of cores connected '
+                        'all-to-all (at most 2, since a tile only has two '
+                        'DMA channels each way)')
+    parser.add_argument('--packet-flows', type=int, default=0,
+                        help='number of random packet flows')
+    parser.add_argument('--packet-fanout', type=int, default=1,
+                        help='number of destinations of each packet flow')
+    parser.add_argument('--object-fifos', default='none',
+                        choices=['none', 'neighbour', 'random'],
+                        help='pattern of objectFifos between cores')
+    parser.add_argument('--buffers', type=int, default=2,
+                        help='number of buffers per core')
+    parser.add_argument('--buffer-size', type=int, default=256,
+                        help='number of i32 elements of each buffer')
+    parser.add_argument('--seed', type=int, default=0,
+                        help='seed of the random patterns')
+    return parser.parse_args(args)
+
+
+def tile(col, row):
+    return '%%tile_%d_%d' % (col, row)
+
+
+class Design:
+    def __init__(self, opts):
+        self.opts = opts
+        self.rng = random.Random(opts.seed)
+        self.tiles = [(c, r) for c in range(opts.cols)
+                      for r in range(1, opts.rows + 1)]
+        # Free DMA channels of each tile for circuit-switched flows.
+        self.sources = {t: [0, 1] for t in self.tiles}
+        self.dests = {t: [0, 1] for t in self.tiles}
+        self.flows = []
+        self.fifos = []
+
+    def add_flow(self, src, dst):
+        if src == dst or not self.sources[src] or not self.dests[dst]:
+            return False
+        self.flows.append((src, self.sources[src].pop(0),
+                           dst, self.dests[dst].pop(0)))
+        return True
+
+    def neighbour_flows(self):
+        for (c, r) in self.tiles:
+            if (c + 1, r) in self.sources:
+                self.add_flow((c, r), (c + 1, r))
+            if (c, r + 1) in self.sources:
+                self.add_flow((c, r), (c, r + 1))
+
+    def random_flows(self):
+        for src in self.tiles:
+            for _ in range(2):
+                candidates = [t for t in self.tiles if self.dests[t]]
+                if candidates:
+                    self.add_flow(src, self.rng.choice(candidates))
+
+    def all_to_all_flows(self):
+        g = self.opts.group
+        for c0 in range(0, self.opts.cols, g):
+            for r0 in range(1, self.opts.rows + 1, g):
+                group = [t for t in self.tiles
+                         if c0 <= t[0] < c0 + g and r0 <= t[1] < r0 + g]
+                for src in group:
+                    for dst in group:
+                        self.add_flow(src, dst)
+
+    def object_fifos(self):
+        if self.opts.object_fifos == 'neighbour':
+            for (c, r) in self.tiles:
+                if (c + 1, r) in self.sources:
+                    self.fifos.append(((c, r), (c + 1, r)))
+        elif self.opts.object_fifos == 'random':
+            for src in self.tiles:
+                dst = self.rng.choice(self.tiles)
+                if src == dst:
+                    continue
+                if src[0] == dst[0] and abs(src[1] - dst[1]) == 1:
+                    self.fifos.append((src, dst))
+                elif self.sources[src] and self.dests[dst]:
+                    self.sources[src].pop(0)
+                    self.dests[dst].pop(0)
+                    self.fifos.append((src, dst))
+
+    def print(self, out):
+        opts = self.opts
+        self.object_fifos()
+        {'none': lambda: None,
+         'neighbour': self.neighbour_flows,
+         'random': self.random_flows,
+         'all-to-all': self.all_to_all_flows}[opts.flows]()
+
+        out.write('module @synthetic_%dx%d {\n' % (opts.cols, opts.rows))
+        for (c, r) in self.tiles:
+            out.write('  %s = AIE.tile(%d, %d)\n' % (tile(c, r), c, r))
+        for (c, r) in self.tiles:
+            for i in range(opts.buffers):
+                out.write('  %%buf_%d_%d_%d = AIE.buffer(%s) '
+                          '{sym_name = "buf_%d_%d_%d"} : memref<%dxi32>\n' %
+                          (c, r, i, tile(c, r), c, r, i, opts.buffer_size))
+
+        for (src, sch, dst, dch) in self.flows:
+            out.write('  AIE.flow(%s, DMA : %d, %s, DMA : %d)\n' %
+                      (tile(*src), sch, tile(*dst), dch))
+
+        for i in range(opts.packet_flows):
+            src = self.rng.choice(self.tiles)
+            dsts = self.rng.sample([t for t in self.tiles if t != src],
+                                   min(opts.packet_fanout,
+                                       len(self.tiles) - 1))
+            out.write('  AIE.packet_flow(%d) {\n' % (i % 32))
+            out.write('    AIE.packet_source<%s, Core : 0>\n' % tile(*src))
+            for dst in dsts:
+                out.write('    AIE.packet_dest<%s, Core : 1>\n' % tile(*dst))
+            out.write('  }\n')
+
+        for i, (src, dst) in enumerate(self.fifos):
+            out.write('  %%fifo_%d = AIE.objectFifo.createObjectFifo'
+                      '(%s, %s, 2) : %s\n' %
+                      (i, tile(*src), tile(*dst), FIFO_TYPE))
+
+        # Every core writes to its buffers, and to and from its objectFifos.
+        for (c, r) in self.tiles:
+            out.write('  %%core_%d_%d = AIE.core(%s) {\n' % (c, r, tile(c, r)))
+            out.write('    %c0 = arith.constant 0 : index\n')
+            out.write('    %%v = arith.constant %d : i32\n' % (c * 100 + r))
+            for i in range(opts.buffers):
+                out.write('    memref.store %%v, %%buf_%d_%d_%d[%%c0] : '
+                          'memref<%dxi32>\n' % (c, r, i, opts.buffer_size))
+            for i, (src, dst) in enumerate(self.fifos):
+                for port, end in [('Produce', src), ('Consume', dst)]:
+                    if end != (c, r):
+                        continue
+                    out.write('    %%sv_%s_%d = AIE.objectFifo.acquire<%s>'
+                              '(%%fifo_%d : %s, 1) : %s\n' %
+                              (port, i, port, i, FIFO_TYPE, SUBVIEW_TYPE))
+                    out.write('    %%elem_%s_%d = AIE.objectFifo.subview.access'
+                              ' %%sv_%s_%d[0] : %s -> memref<16xi32>\n' %
+                              (port, i, port, i, SUBVIEW_TYPE))
+                    out.write('    memref.store %%v, %%elem_%s_%d[%%c0] : '
+                              'memref<16xi32>\n' % (port, i))
+                    out.write('    AIE.objectFifo.release<%s>'
+                              '(%%fifo_%d : %s, 1)\n' %
+                              (port, i, FIFO_TYPE))
+            out.write('    AIE.end\n')
+            out.write('  }\n')
+        out.write('}\n')
+
+
+def main():
+    Design(parse_args()).print(sys.stdout)
+
+
+if __name__ == '__main__':
+    main()